@@ -120,7 +120,341 @@
 //
 static int servsockfd = LMON_INIT;
 static per_be_data_t bedata;
-static std::map<std::string, std::vector<MPIR_PROCDESC_EXT *> > proctab_cache;
+
+//
+// the view of proctab_msg that LMON_be_getMyProctab* are served
+// from, built on first use
+//
+static bool proctab_view_built = false;
+static lmon_proctab_view_t proctab_view;
+static std::vector<unsigned int> proctab_view_order;
+static std::vector<lmon_proctab_host_t> proctab_view_hosts;
+static char *proctab_view_tofree = NULL;
+
+//////////////////////////////////////////////////////////////////////////////////
+//
+// Static functions
+//
+//
+
+//! static lmonp_t *build_RPDTAB_slice
+/*!
+    builds a legacy proctable message holding only the given tasks
+    of a legacy entry array. Its string table holds the tasks' host
+    name followed by their distinct executables. Returns NULL if out
+    of memory.
+*/
+static lmonp_t *build_RPDTAB_slice(const char *entries, const char *strtab,
+                                   const std::vector<unsigned int> &tasks,
+                                   int *slicelen) {
+  using namespace std;
+
+  const unsigned int *ent = (const unsigned int *)entries;
+  map<unsigned int, unsigned int> newoff;
+  map<unsigned int, unsigned int>::iterator iter;
+  vector<unsigned int> order;
+  unsigned int strtablen = 0;
+  unsigned int ntasks = tasks.size();
+  size_t i;
+
+  for (i = 0; i < ntasks; ++i) {
+    const unsigned int *e = ent + tasks[i] * N_Fields_MPIR_PROCDESC_EXT;
+    //
+    // e[0] is the host name index, e[1] the executable index
+    //
+    for (int f = 0; f < 2; ++f) {
+      if (newoff.find(e[f]) == newoff.end()) {
+        newoff[e[f]] = strtablen;
+        order.push_back(e[f]);
+        strtablen += strlen(strtab + e[f]) + 1;
+      }
+    }
+  }
+
+  unsigned int entlen =
+      ntasks * N_Fields_MPIR_PROCDESC_EXT * sizeof(unsigned int);
+  *slicelen = sizeof(lmonp_t) + entlen + strtablen;
+  lmonp_t *slice = (lmonp_t *)malloc(*slicelen);
+  if (slice == NULL) return NULL;
+
+  unsigned short nexec = (ntasks > 0) ? (unsigned short)(order.size() - 1) : 0;
+  unsigned short nhn = (ntasks > 0) ? 1 : 0;
+  if (ntasks < LMON_NTASKS_THRE) {
+    set_msg_header(slice, lmonp_fetobe, (int)lmonp_febe_proctab,
+                   (unsigned short)ntasks, 0, nexec, nhn, 0,
+                   entlen + strtablen, 0);
+  } else {
+    set_msg_header(slice, lmonp_fetobe, (int)lmonp_febe_proctab,
+                   LMON_NTASKS_THRE, 0, nexec, nhn, ntasks,
+                   entlen + strtablen, 0);
+  }
+
+  unsigned int *sent = (unsigned int *)((char *)slice + sizeof(lmonp_t));
+  for (i = 0; i < ntasks; ++i) {
+    const unsigned int *e = ent + tasks[i] * N_Fields_MPIR_PROCDESC_EXT;
+    sent[0] = newoff[e[0]];
+    sent[1] = newoff[e[1]];
+    sent[2] = e[2];
+    sent[3] = e[3];
+    sent[4] = e[4];
+    sent += N_Fields_MPIR_PROCDESC_EXT;
+  }
+
+  char *sstrtab = (char *)sent;
+  for (i = 0; i < order.size(); ++i) {
+    memcpy(sstrtab + newoff[order[i]], strtab + order[i],
+           strlen(strtab + order[i]) + 1);
+  }
+
+  return slice;
+}
+
+//! static lmon_rc_e shard_proctab
+/*!
+    a collective that replaces the whole proctable message the master
+    received from the FE with per-host slices: the master broadcasts
+    the host names of the table, each daemon picks its own with its
+    host aliases, and the master scatters each daemon the slice of
+    its host. Daemons whose host isn't found get an empty slice.
+    The master keeps the whole message in bedata.proctab_full_msg.
+*/
+static lmon_rc_e shard_proctab() {
+  using namespace std;
+
+  vector<vector<unsigned int> > hosttasks;
+  vector<char> hosttab;
+  int hosttabsize = 0;
+  char *entries = NULL;
+  char *strtab = NULL;
+  char *tofree = NULL;
+
+  BEGIN_MASTER_ONLY(bedata)
+  entries = get_RPDTAB_entries(bedata.proctab_msg, &strtab, &tofree);
+  if (entries == NULL || strtab == NULL) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true,
+                 "get_RPDTAB_entries failed to decode RPDTAB");
+    hosttabsize = -1;
+  } else {
+    //
+    // grouping tasks by host in the order hosts first appear
+    //
+    map<unsigned int, unsigned int> hostix;
+    unsigned int ntasks = RPDTAB_msg_ntasks(bedata.proctab_msg);
+    const unsigned int *ent = (const unsigned int *)entries;
+    unsigned int i;
+
+    for (i = 0; i < ntasks; ++i, ent += N_Fields_MPIR_PROCDESC_EXT) {
+      map<unsigned int, unsigned int>::iterator iter = hostix.find(ent[0]);
+      if (iter == hostix.end()) {
+        const char *hn = strtab + ent[0];
+        iter = hostix.insert(make_pair(ent[0], hosttasks.size())).first;
+        hosttasks.push_back(vector<unsigned int>());
+        hosttab.insert(hosttab.end(), hn, hn + strlen(hn) + 1);
+      }
+      hosttasks[iter->second].push_back(i);
+    }
+    hosttabsize = (int)hosttab.size();
+  }
+  END_MASTER_ONLY
+
+  if (LMON_be_broadcast(&hosttabsize, sizeof(hosttabsize)) != LMON_OK) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Broadcast failed");
+    return LMON_ESUBCOM;
+  }
+
+  if (hosttabsize <= 0) {
+    if (tofree) free(tofree);
+    return LMON_EBDMSG;
+  }
+
+  hosttab.resize(hosttabsize);
+  if (LMON_be_broadcast(&hosttab[0], hosttabsize) != LMON_OK) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Broadcast failed");
+    return LMON_ESUBCOM;
+  }
+
+  //
+  // finding my host among the hosts of the table
+  //
+  int myhostix = -1;
+  int ix = 0;
+  const char *hn = &hosttab[0];
+  while (hn < &hosttab[0] + hosttabsize && myhostix < 0) {
+    vector<string>::const_iterator aiter;
+    for (aiter = bedata.daemon_data.host_aliases.begin();
+         aiter != bedata.daemon_data.host_aliases.end(); ++aiter) {
+      if (*aiter == hn) {
+        myhostix = ix;
+        break;
+      }
+    }
+    hn += strlen(hn) + 1;
+    ix++;
+  }
+
+#if VERBOSE
+  LMON_say_msg(LMON_BE_MSG_PREFIX, false, "BES: my proctab host index is %d",
+               myhostix);
+#endif
+
+  vector<int> hostixs(bedata.daemon_data.width, -1);
+  if (LMON_be_gather(&myhostix, sizeof(myhostix), &hostixs[0]) != LMON_OK) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "gather failed");
+    return LMON_ESUBCOM;
+  }
+
+  //
+  // the master builds one slice per host that a daemon asked for,
+  // plus an empty one for daemons without tasks, and packs each
+  // once: daemons on the same host share a displacement.
+  //
+  vector<int> sendcounts;
+  vector<int> displs;
+  vector<char> sendbuf;
+  int myslicesize = 0;
+
+  BEGIN_MASTER_ONLY(bedata)
+  vector<int> sliceoff(hosttasks.size() + 1, -1);
+  vector<int> slicelen(hosttasks.size() + 1, 0);
+  int d;
+
+  sendcounts.resize(bedata.daemon_data.width);
+  displs.resize(bedata.daemon_data.width);
+
+  for (d = 0; d < bedata.daemon_data.width; ++d) {
+    int h = hostixs[d];
+    if (h < 0 || h >= (int)hosttasks.size()) h = (int)hosttasks.size();
+
+    if (sliceoff[h] < 0) {
+      static const vector<unsigned int> notasks;
+      const vector<unsigned int> &tasks =
+          (h < (int)hosttasks.size()) ? hosttasks[h] : notasks;
+      int len;
+      lmonp_t *slice = build_RPDTAB_slice(entries, strtab, tasks, &len);
+      if (slice == NULL) {
+        LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Out of memory");
+        if (tofree) free(tofree);
+        return LMON_ENOMEM;
+      }
+      sliceoff[h] = (int)sendbuf.size();
+      slicelen[h] = len;
+      sendbuf.insert(sendbuf.end(), (char *)slice, (char *)slice + len);
+      free(slice);
+    }
+    sendcounts[d] = slicelen[h];
+    displs[d] = sliceoff[h];
+  }
+
+  if (tofree) free(tofree);
+  END_MASTER_ONLY
+
+  if (LMON_be_scatter(sendcounts.empty() ? NULL : &sendcounts[0], sizeof(int),
+                      &myslicesize) != LMON_OK) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Scatter failed");
+    return LMON_ESUBCOM;
+  }
+
+  lmonp_t *myslice = (lmonp_t *)malloc(myslicesize);
+  if (myslice == NULL) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Malloc returned NULL");
+    return LMON_ENOMEM;
+  }
+
+  if (LMON_daemon_internal_scatterv(
+          sendbuf.empty() ? NULL : &sendbuf[0],
+          sendcounts.empty() ? NULL : &sendcounts[0],
+          displs.empty() ? NULL : &displs[0], myslice,
+          myslicesize) != LMON_OK) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Scatterv failed");
+    free(myslice);
+    return LMON_ESUBCOM;
+  }
+
+  BEGIN_MASTER_ONLY(bedata)
+  bedata.proctab_full_msg = bedata.proctab_msg;
+  bedata.proctab_full_msg_size = bedata.proctab_msg_size;
+  END_MASTER_ONLY
+
+  bedata.proctab_msg = myslice;
+  bedata.proctab_msg_size = myslicesize;
+
+  return LMON_OK;
+}
+
+//! static lmon_rc_e build_proctab_view
+/*!
+    builds proctab_view over bedata.proctab_msg: tasks are grouped
+    by host into proctab_view_order with index_RPDTAB_entries, and
+    my_host is the first host that matches one of this daemon's
+    aliases, tried in alias order.
+*/
+static lmon_rc_e build_proctab_view() {
+  using namespace std;
+
+  if (proctab_view_built) return LMON_OK;
+
+  if (bedata.proctab_msg == NULL) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "bedata.proctab_msg is null!  ");
+
+    return LMON_EINVAL;
+  }
+
+  memset(&proctab_view, 0, sizeof(proctab_view));
+  proctab_view.my_host = -1;
+
+  unsigned int ntasks = RPDTAB_msg_ntasks(bedata.proctab_msg);
+  if (ntasks == 0) {
+    proctab_view_built = true;
+    return LMON_OK;
+  }
+
+  char *strtab = NULL;
+  char *entries =
+      get_RPDTAB_entries(bedata.proctab_msg, &strtab, &proctab_view_tofree);
+  if (entries == NULL || strtab == NULL) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, false,
+                 "get_RPDTAB_entries failed to decode RPDTAB");
+
+    return LMON_EINVAL;
+  }
+
+  proctab_view_order.resize(ntasks);
+  if (index_RPDTAB_entries(entries, strtab, ntasks, &proctab_view_order[0],
+                           &proctab_view_hosts) < 0) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, false,
+                 "index_RPDTAB_entries failed to index RPDTAB");
+
+    return LMON_EINVAL;
+  }
+
+  unsigned int i;
+  vector<string>::const_iterator aiter;
+  for (aiter = bedata.daemon_data.host_aliases.begin();
+       aiter != bedata.daemon_data.host_aliases.end() &&
+       proctab_view.my_host < 0;
+       ++aiter) {
+    for (i = 0; i < proctab_view_hosts.size(); ++i) {
+      if (*aiter == proctab_view_hosts[i].host_name) {
+        proctab_view.my_host = (int)i;
+#if VERBOSE
+        LMON_say_msg(LMON_BE_MSG_PREFIX, false,
+                     "found an entry with an alias %s.", (*aiter).c_str());
+#endif
+        break;
+      }
+    }
+  }
+
+  proctab_view.num_tasks = (int)ntasks;
+  proctab_view.num_hosts = (int)proctab_view_hosts.size();
+  proctab_view.hosts = &proctab_view_hosts[0];
+  proctab_view.order = &proctab_view_order[0];
+  proctab_view.entries = (const unsigned int *)entries;
+  proctab_view.strtab = strtab;
+  proctab_view_built = true;
+
+  return LMON_OK;
+}
 
 //////////////////////////////////////////////////////////////////////////////////
 //
@@ -234,6 +568,9 @@ extern "C" lmon_rc_e LMON_be_init(int ver, int *argc, char ***argv) {
 
   bedata.proctab_msg = NULL;
   bedata.proctab_msg_size = 0;
+  bedata.proctab_sharded = 0;
+  bedata.proctab_full_msg = NULL;
+  bedata.proctab_full_msg_size = 0;
   bedata.daemon_data.pack = NULL;
   bedata.daemon_data.unpack = NULL;
   bool ismstr =
@@ -509,6 +846,128 @@ extern "C" lmon_rc_e LMON_be_scatter(void *sendbuf, int numbyte_per_element,
   return LMON_OK;
 }
 
+//! lmon_rc_e LMON_be_gatherv
+/*!
+   Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_gatherv(void *sendbuf, int numbyte,
+                                     void **recvbuf, int *recvcounts) {
+  lmon_rc_e lrc =
+      LMON_daemon_internal_gatherv(sendbuf, numbyte, recvbuf, recvcounts);
+
+  if (lrc == LMON_ENOMEM) return LMON_ENOMEM;
+
+  if (lrc != LMON_OK) return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_scatterv
+/*!
+   Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_scatterv(void *sendbuf, int *sendcounts,
+                                      int *displs, void *recvbuf,
+                                      int recvcount) {
+  if (LMON_daemon_internal_scatterv(sendbuf, sendcounts, displs, recvbuf,
+                                    recvcount) != LMON_OK)
+    return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_regReduceOp
+/*!
+   Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_regReduceOp(lmon_reduce_fn_t fn, int *op) {
+  if (LMON_daemon_internal_regReduceOp(fn, op) != LMON_OK) return LMON_EINVAL;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_reduce
+/*!
+   Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_reduce(void *sendbuf, void *recvbuf, int count,
+                                    lmon_datatype_e type, int op) {
+  if (LMON_daemon_internal_reduce(sendbuf, recvbuf, count, type, op) !=
+      LMON_OK)
+    return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_allreduce
+/*!
+   Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_allreduce(void *sendbuf, void *recvbuf,
+                                       int count, lmon_datatype_e type,
+                                       int op) {
+  if (LMON_daemon_internal_allreduce(sendbuf, recvbuf, count, type, op) !=
+      LMON_OK)
+    return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_ibarrier
+/*!
+   Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_ibarrier(lmon_request_t *req) {
+  if (LMON_daemon_internal_ibarrier(req) != LMON_OK) return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_ibroadcast
+/*!
+   Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_ibroadcast(void *buf, int numbyte,
+                                        lmon_request_t *req) {
+  if (LMON_daemon_internal_ibroadcast(buf, numbyte, req) != LMON_OK)
+    return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_igather
+/*!
+   Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_igather(void *sendbuf, int numbyte_per_elem,
+                                     void *recvbuf, lmon_request_t *req) {
+  if (LMON_daemon_internal_igather(sendbuf, numbyte_per_elem, recvbuf, req) !=
+      LMON_OK)
+    return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_test
+/*!
+   Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_test(lmon_request_t *req, int *flag) {
+  if (LMON_daemon_internal_test(req, flag) != LMON_OK) return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_wait
+/*!
+   Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_wait(lmon_request_t *req) {
+  if (LMON_daemon_internal_wait(req) != LMON_OK) return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
 //! LMON_be_finalize();
 /*!
     Please refer to the header file: lmon_be.h
@@ -566,24 +1025,24 @@ extern "C" lmon_rc_e LMON_be_finalize() {
     return LMON_ESUBCOM;
   }
 
+  if (bedata.proctab_full_msg != NULL &&
+      bedata.proctab_full_msg != bedata.proctab_msg) {
+    free(bedata.proctab_full_msg);
+  }
+  bedata.proctab_full_msg = NULL;
+
   if (bedata.proctab_msg != NULL) {
     free(bedata.proctab_msg);
     bedata.proctab_msg = NULL;
   }
 
-  if (proctab_cache.size() != 0) {
-    std::map<std::string, std::vector<MPIR_PROCDESC_EXT *> >::iterator iter;
-    std::vector<MPIR_PROCDESC_EXT *>::iterator vectiter;
-    for (iter = proctab_cache.begin(); iter != proctab_cache.end(); ++iter) {
-      for (vectiter = iter->second.begin(); vectiter != iter->second.end();
-           ++vectiter) {
-        free((*vectiter)->pd.executable_name);
-        free((*vectiter)->pd.host_name);
-        free((*vectiter));
-      }
-    }
-    proctab_cache.clear();
+  if (proctab_view_tofree) {
+    free(proctab_view_tofree);
+    proctab_view_tofree = NULL;
   }
+  proctab_view_order.clear();
+  proctab_view_hosts.clear();
+  proctab_view_built = false;
 
   if (bedata.daemon_data.daemon_spawner) {
     delete bedata.daemon_data.daemon_spawner;
@@ -617,28 +1076,21 @@ extern "C" lmon_rc_e LMON_be_handshake(void *udata) {
   //
   int i;
   char *hngatherbuf = NULL;
+  std::vector<int> hnlens;
 
   BEGIN_MASTER_ONLY(bedata)
-
-  hngatherbuf = (char *)malloc(LMON_DAEMON_HN_MAX * bedata.daemon_data.width);
-  if (hngatherbuf == NULL) {
-    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "malloc returned zero");
-
-    return LMON_ENOMEM;
-  }
-#if VERBOSE
-  LMON_say_msg(LMON_BE_MSG_PREFIX, false,
-               "BE master: alloc buf of size %d x %d", LMON_DAEMON_HN_MAX,
-               bedata.daemon_data.width);
-#endif
+  hnlens.resize(bedata.daemon_data.width);
   END_MASTER_ONLY
 
   //
-  // once be_gather is performed, hngatherbuf
-  // should hold all the hostnames
+  // once be_gatherv is performed, hngatherbuf
+  // should hold all the hostnames back to back,
+  // each taking only its own length on the wire
   //
-  if (LMON_be_gather(bedata.daemon_data.my_hostname, LMON_DAEMON_HN_MAX,
-                     hngatherbuf) != LMON_OK) {
+  if (LMON_be_gatherv(bedata.daemon_data.my_hostname,
+                      strlen(bedata.daemon_data.my_hostname) + 1,
+                      (void **)&hngatherbuf,
+                      hnlens.empty() ? NULL : &hnlens[0]) != LMON_OK) {
     LMON_say_msg(LMON_BE_MSG_PREFIX, true, "gather failed");
 
     return LMON_ESUBCOM;
@@ -666,7 +1118,7 @@ extern "C" lmon_rc_e LMON_be_handshake(void *udata) {
       hostName[tmpstr].push_back(0);
       offset += (strlen(hntrav) + 1);
     }
-    hntrav += LMON_DAEMON_HN_MAX;
+    hntrav += hnlens[i];
   }
 
   //
@@ -716,7 +1168,7 @@ extern "C" lmon_rc_e LMON_be_handshake(void *udata) {
       strtabptr += (strlen(hntrav) + 1);
       hostName[tmpstr][1] = 1;
     }
-    hntrav += LMON_DAEMON_HN_MAX;
+    hntrav += hnlens[i];
   }
 
   free(hngatherbuf);
@@ -852,6 +1304,18 @@ extern "C" lmon_rc_e LMON_be_handshake(void *udata) {
 #endif
   }
 
+  //
+  // Each daemon only gets its own host's slice of the proctable
+  // unless LMON_BE_PROCTAB_DIST asks for the whole table to be
+  // broadcast ("bcast").
+  //
+  const char *dist = getenv(LMON_BE_PROCTAB_DIST_ENVNAME);
+  bedata.proctab_sharded =
+      ((bedata.daemon_data.width > 1) &&
+       !(dist && (strcmp(dist, "bcast") == 0)))
+          ? 1
+          : 0;
+
   END_MASTER_ONLY
 
   //
@@ -873,42 +1337,71 @@ extern "C" lmon_rc_e LMON_be_handshake(void *udata) {
     return LMON_ESUBCOM;
   }
 
-  if (LMON_be_broadcast(&(bedata.proctab_msg_size),
-                        sizeof(bedata.proctab_msg_size)) != LMON_OK) {
-    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Broadcast failed");
+  if (LMON_be_broadcast(&(bedata.proctab_sharded),
+                        sizeof(bedata.proctab_sharded)) != LMON_OK) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true,
+                 "Broadcast failed for proctab_sharded");
 
     return LMON_ESUBCOM;
   }
 
+  if (bedata.proctab_sharded) {
+    //
+    // scattering per-host slices of the proctab_msg
+    //
+    lmon_rc_e lrc = shard_proctab();
+    if (lrc != LMON_OK) {
+      LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Sharding the proctab failed");
+      return lrc;
+    }
+
 #if VERBOSE
-  LMON_say_msg(LMON_BE_MSG_PREFIX, false,
-               "BES: Bcasted is_launch and proctab_msg_size: %d",
-               bedata.proctab_msg_size);
+    LMON_say_msg(LMON_BE_MSG_PREFIX, false,
+                 "BEs: proctab_msg finish Scattering: %d",
+                 bedata.proctab_msg_size);
 #endif
+  } else {
+    if (LMON_be_broadcast(&(bedata.proctab_msg_size),
+                          sizeof(bedata.proctab_msg_size)) != LMON_OK) {
+      LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Broadcast failed");
 
-  BEGIN_SLAVE_ONLY(bedata)
-  //
-  // slave BEs preparing for proctab_msg broadcast
-  //
-  bedata.proctab_msg = (lmonp_t *)malloc(bedata.proctab_msg_size);
-  if (bedata.proctab_msg == NULL) {
-    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Malloc returned NULL");
-    return LMON_ENOMEM;
-  }
-  END_SLAVE_ONLY
+      return LMON_ESUBCOM;
+    }
 
-  //
-  // duplicating the proctab_msg using broadcast
-  //
-  if (LMON_be_broadcast(bedata.proctab_msg, bedata.proctab_msg_size) !=
-      LMON_OK) {
-    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Broadcast failed");
-    return LMON_ESUBCOM;
-  }
+#if VERBOSE
+    LMON_say_msg(LMON_BE_MSG_PREFIX, false,
+                 "BES: Bcasted is_launch and proctab_msg_size: %d",
+                 bedata.proctab_msg_size);
+#endif
+
+    BEGIN_SLAVE_ONLY(bedata)
+    //
+    // slave BEs preparing for proctab_msg broadcast
+    //
+    bedata.proctab_msg = (lmonp_t *)malloc(bedata.proctab_msg_size);
+    if (bedata.proctab_msg == NULL) {
+      LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Malloc returned NULL");
+      return LMON_ENOMEM;
+    }
+    END_SLAVE_ONLY
+
+    //
+    // duplicating the proctab_msg using broadcast
+    //
+    if (LMON_be_broadcast(bedata.proctab_msg, bedata.proctab_msg_size) !=
+        LMON_OK) {
+      LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Broadcast failed");
+      return LMON_ESUBCOM;
+    }
+
+    bedata.proctab_full_msg = bedata.proctab_msg;
+    bedata.proctab_full_msg_size = bedata.proctab_msg_size;
 
 #if VERBOSE
-  LMON_say_msg(LMON_BE_MSG_PREFIX, false, "BEs: proctab_msg finish Bcasting");
+    LMON_say_msg(LMON_BE_MSG_PREFIX, false,
+                 "BEs: proctab_msg finish Bcasting");
 #endif
+  }
 
   //
   //
@@ -1121,62 +1614,28 @@ extern "C" lmon_rc_e LMON_be_assist_mw_coloc() {
 */
 extern "C" lmon_rc_e LMON_be_getMyProctab(MPIR_PROCDESC_EXT *proctabbuf,
                                           int *size, int proctab_num_elem) {
-  using namespace std;
-
-  unsigned int i;
-  char *key;
   lmon_rc_e lrc;
+  int i;
 
-  if (bedata.proctab_msg == NULL) {
-    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "bedata.proctab_msg is null!  ");
-
-    return LMON_EINVAL;
-  }
-
-  if (proctab_cache.size() == 0) {
-    if (parse_raw_RPDTAB_msg(bedata.proctab_msg, &proctab_cache) < 0) {
-      LMON_say_msg(LMON_BE_MSG_PREFIX, false,
-                   "parse_raw_RPDTAB_msg failed to parse RPDTAB");
-
-      return LMON_EINVAL;
-    }
-  }
+  if ((lrc = build_proctab_view()) != LMON_OK) return lrc;
 
-  std::vector<std::string>::const_iterator itr;
-  map<string, vector<MPIR_PROCDESC_EXT *> >::const_iterator viter;
   *size = 0;
+  if (proctab_view.my_host < 0) return LMON_OK;
 
-  for (itr = bedata.daemon_data.host_aliases.begin();
-       itr != bedata.daemon_data.host_aliases.end(); itr++) {
-    viter = proctab_cache.find(*itr);
-    if (viter != proctab_cache.end()) {
-      *size = viter->second.size();
-#if VERBOSE
-      LMON_say_msg(LMON_BE_MSG_PREFIX, false,
-                   "found an entry with an alias %s.", (*itr).c_str());
-#endif
-      break;
-    }
-#if VERBOSE
-    else {
-      LMON_say_msg(
-          LMON_BE_MSG_PREFIX, false,
-          "couldn't find an entry with an alias %s... trying the next alias",
-          (*itr).c_str());
-    }
-#endif
-  }
+  const lmon_proctab_host_t *h = &proctab_view.hosts[proctab_view.my_host];
+  *size = h->end - h->begin;
 
   for (i = 0; (i < (*size)) && (i < proctab_num_elem); ++i) {
     //
     // The caller is responsible for freeing strdup's memory
     //
     proctabbuf[i].pd.executable_name =
-        strdup((*viter).second[i]->pd.executable_name);
-    proctabbuf[i].pd.host_name = strdup((*viter).second[i]->pd.host_name);
-    proctabbuf[i].pd.pid = (*viter).second[i]->pd.pid;
-    proctabbuf[i].mpirank = (*viter).second[i]->mpirank;
-    proctabbuf[i].cnodeid = (*viter).second[i]->cnodeid;
+        strdup(LMON_view_executable_name(&proctab_view, h->begin + i));
+    proctabbuf[i].pd.host_name =
+        strdup(LMON_view_host_name(&proctab_view, h->begin + i));
+    proctabbuf[i].pd.pid = LMON_view_pid(&proctab_view, h->begin + i);
+    proctabbuf[i].mpirank = LMON_view_mpirank(&proctab_view, h->begin + i);
+    proctabbuf[i].cnodeid = LMON_view_cnodeid(&proctab_view, h->begin + i);
   }
 
   if ((i == proctab_num_elem) && (proctab_num_elem < (*size)))
@@ -1190,50 +1649,151 @@ extern "C" lmon_rc_e LMON_be_getMyProctab(MPIR_PROCDESC_EXT *proctabbuf,
     Please refer to the header file: lmon_be.h
 */
 lmon_rc_e LMON_be_getMyProctabSize(int *size) {
-  using namespace std;
+  lmon_rc_e lrc;
+
+  if ((lrc = build_proctab_view()) != LMON_OK) return lrc;
+
+  *size = 0;
+  if (proctab_view.my_host >= 0) {
+    const lmon_proctab_host_t *h = &proctab_view.hosts[proctab_view.my_host];
+    *size = h->end - h->begin;
+  }
+
+  return LMON_OK;
+}
 
-  char *key = NULL;
+//! lmon_rc_e LMON_be_getMyProctabView
+/*!
+    Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_getMyProctabView(lmon_proctab_view_t *view) {
   lmon_rc_e lrc;
 
+  if (view == NULL) return LMON_EBDARG;
+
+  if ((lrc = build_proctab_view()) != LMON_OK) return lrc;
+
+  *view = proctab_view;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_fetchProctable
+/*!
+    Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_fetchProctable() {
   if (bedata.proctab_msg == NULL) {
     LMON_say_msg(LMON_BE_MSG_PREFIX, true, "bedata.proctab_msg is null!  ");
 
     return LMON_EINVAL;
   }
 
-  if (proctab_cache.size() == 0) {
-    if (parse_raw_RPDTAB_msg(bedata.proctab_msg, &proctab_cache) < 0) {
-      LMON_say_msg(LMON_BE_MSG_PREFIX, false,
-                   "parse_raw_RPDTAB_msg failed to parse RPDTAB");
+  //
+  // the whole table was broadcast at handshake: nothing to do
+  //
+  if (!bedata.proctab_sharded) return LMON_OK;
 
-      return LMON_EINVAL;
-    }
+  int fullsize = bedata.proctab_full_msg_size;
+  if (LMON_be_broadcast(&fullsize, sizeof(fullsize)) != LMON_OK) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Broadcast failed");
+
+    return LMON_ESUBCOM;
   }
 
-  std::vector<std::string>::const_iterator itr;
-  map<string, vector<MPIR_PROCDESC_EXT *> >::const_iterator viter;
-  *size = 0;
+  //
+  // daemons that already have it still have to receive the
+  // broadcast to stay in step
+  //
+  lmonp_t *fullmsg = bedata.proctab_full_msg;
+  BEGIN_SLAVE_ONLY(bedata)
+  if (fullmsg == NULL) {
+    fullmsg = (lmonp_t *)malloc(fullsize);
+  } else {
+    fullmsg = (lmonp_t *)realloc(fullmsg, fullsize);
+  }
+  if (fullmsg == NULL) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Malloc returned NULL");
 
-  for (itr = bedata.daemon_data.host_aliases.begin();
-       itr != bedata.daemon_data.host_aliases.end(); itr++) {
-    viter = proctab_cache.find(*itr);
-    if (viter != proctab_cache.end()) {
-      *size = viter->second.size();
-#if VERBOSE
-      LMON_say_msg(LMON_BE_MSG_PREFIX, false,
-                   "found an entry with an alias %s.", (*itr).c_str());
-#endif
-      break;
-    }
-#if VERBOSE
-    else {
-      LMON_say_msg(
-          LMON_BE_MSG_PREFIX, false,
-          "couldn't find an entry with an alias %s... trying the next alias",
-          (*itr).c_str());
-    }
-#endif
+    return LMON_ENOMEM;
   }
+  END_SLAVE_ONLY
+
+  if (LMON_be_broadcast(fullmsg, fullsize) != LMON_OK) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true, "Broadcast failed");
+
+    return LMON_ESUBCOM;
+  }
+
+  bedata.proctab_full_msg = fullmsg;
+  bedata.proctab_full_msg_size = fullsize;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_getProctableSize
+/*!
+    Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_getProctableSize(int *size) {
+  if (bedata.proctab_full_msg == NULL) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true,
+                 "the whole proctable hasn't been fetched");
+
+    return LMON_EDUNAV;
+  }
+
+  *size = (int)RPDTAB_msg_ntasks(bedata.proctab_full_msg);
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_be_getProctable
+/*!
+    Please refer to the header file: lmon_be.h
+*/
+extern "C" lmon_rc_e LMON_be_getProctable(MPIR_PROCDESC_EXT *proctabbuf,
+                                          int *size, int proctab_num_elem) {
+  char *mpirent;
+  char *strtab;
+  char *tofree = NULL;
+  int i;
+
+  if (bedata.proctab_full_msg == NULL) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true,
+                 "the whole proctable hasn't been fetched");
+
+    return LMON_EDUNAV;
+  }
+
+  *size = (int)RPDTAB_msg_ntasks(bedata.proctab_full_msg);
+  if (*size == 0) return LMON_OK;
+
+  mpirent = get_RPDTAB_entries(bedata.proctab_full_msg, &strtab, &tofree);
+  if (mpirent == NULL || strtab == NULL) {
+    LMON_say_msg(LMON_BE_MSG_PREFIX, true,
+                 "get_RPDTAB_entries failed to decode RPDTAB");
+
+    return LMON_EINVAL;
+  }
+
+  const unsigned int *ent = (const unsigned int *)mpirent;
+  for (i = 0; (i < *size) && (i < proctab_num_elem);
+       ++i, ent += N_Fields_MPIR_PROCDESC_EXT) {
+    //
+    // The caller is responsible for freeing strdup's memory
+    //
+    proctabbuf[i].pd.host_name = strdup(strtab + ent[0]);
+    proctabbuf[i].pd.executable_name = strdup(strtab + ent[1]);
+    proctabbuf[i].pd.pid = (int)ent[2];
+    proctabbuf[i].mpirank = (int)ent[3];
+    proctabbuf[i].cnodeid = (int)ent[4];
+  }
+
+  if (tofree) free(tofree);
+
+  if ((i == proctab_num_elem) && (proctab_num_elem < (*size)))
+    return LMON_ETRUNC;
 
   return LMON_OK;
 }
@@ -101,6 +101,96 @@ static int ICCL_size = -1;
 static int ICCL_global_id = -1;
 static per_be_data_t *bedataPtr = NULL;
 
+//
+// User reduction ops registered with LMON_daemon_internal_regReduceOp.
+// The fabric calls them through trampolines, one per slot, that turn
+// its element types back into lmon_datatype_e.
+//
+#define LMON_DAEMON_MAX_USER_OPS 8
+
+static lmon_reduce_fn_t userReduceOps[LMON_DAEMON_MAX_USER_OPS];
+static int numUserReduceOps = 0;
+
+#if MPI_BASED
+static MPI_Datatype mpiTypes[] = {
+    MPI_CHAR,      MPI_INT,       MPI_UNSIGNED,
+    MPI_LONG,      MPI_UNSIGNED_LONG, MPI_LONG_LONG,
+    MPI_UNSIGNED_LONG_LONG, MPI_FLOAT, MPI_DOUBLE};
+
+static MPI_Op mpiOps[] = {MPI_SUM,  MPI_PROD, MPI_MIN, MPI_MAX, MPI_LAND,
+                          MPI_LOR,  MPI_BAND, MPI_BOR, MPI_BXOR};
+
+static MPI_Op mpiUserOps[LMON_DAEMON_MAX_USER_OPS];
+
+//! mpiUserReduceOp
+/*!
+    MPI computes inoutvec = invec op inoutvec with invec holding the
+    lower ranks, so the user op works on a copy of invec.
+*/
+template <int N>
+static void mpiUserReduceOp(void *invec, void *inoutvec, int *len,
+                            MPI_Datatype *dt) {
+  int t, size;
+
+  if ((*len) <= 0) return;
+
+  for (t = 0; t < LMON_TYPE_DOUBLE && mpiTypes[t] != (*dt); ++t)
+    ;
+  MPI_Type_size(*dt, &size);
+
+  std::vector<char> lower((char *)invec, (char *)invec + (*len) * size);
+  userReduceOps[N](&lower[0], inoutvec, *len, (lmon_datatype_e)t);
+  memcpy(inoutvec, &lower[0], lower.size());
+}
+
+static MPI_User_function *mpiUserReduceTrampolines[LMON_DAEMON_MAX_USER_OPS] = {
+    mpiUserReduceOp<0>, mpiUserReduceOp<1>, mpiUserReduceOp<2>,
+    mpiUserReduceOp<3>, mpiUserReduceOp<4>, mpiUserReduceOp<5>,
+    mpiUserReduceOp<6>, mpiUserReduceOp<7>};
+#elif COBO_BASED
+static const int coboTypes[] = {
+    COBO_CHAR,      COBO_INT,       COBO_UNSIGNED,
+    COBO_LONG,      COBO_UNSIGNED_LONG, COBO_LONG_LONG,
+    COBO_UNSIGNED_LONG_LONG, COBO_FLOAT, COBO_DOUBLE};
+
+static const int coboOps[] = {COBO_SUM,  COBO_PROD, COBO_MIN,
+                              COBO_MAX,  COBO_LAND, COBO_LOR,
+                              COBO_BAND, COBO_BOR,  COBO_BXOR};
+
+static int coboUserOps[LMON_DAEMON_MAX_USER_OPS];
+
+template <int N>
+static void coboUserReduceOp(void *inout, void *in, int count, int type) {
+  int t;
+
+  for (t = 0; t < LMON_TYPE_DOUBLE && coboTypes[t] != type; ++t)
+    ;
+  userReduceOps[N](inout, in, count, (lmon_datatype_e)t);
+}
+
+static cobo_op_fn coboUserReduceTrampolines[LMON_DAEMON_MAX_USER_OPS] = {
+    coboUserReduceOp<0>, coboUserReduceOp<1>, coboUserReduceOp<2>,
+    coboUserReduceOp<3>, coboUserReduceOp<4>, coboUserReduceOp<5>,
+    coboUserReduceOp<6>, coboUserReduceOp<7>};
+#endif
+
+//! validReduceArgs
+/*!
+    whether type is an lmon_datatype_e and op a predefined lmon_op_e
+    or a registered user op. The logical and bitwise ops only take
+    integer types, as MPI would abort on a floating type.
+*/
+static bool validReduceArgs(lmon_datatype_e type, int op) {
+  if (type < LMON_TYPE_CHAR || type > LMON_TYPE_DOUBLE) return false;
+
+  if (op >= LMON_OP_LAND && op <= LMON_OP_BXOR)
+    return (type != LMON_TYPE_FLOAT && type != LMON_TYPE_DOUBLE);
+
+  if (op >= LMON_OP_SUM && op <= LMON_OP_MAX) return true;
+
+  return (op >= LMON_OP_USER && op < LMON_OP_USER + numUserReduceOps);
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 //
 // LAUNCHMON BACKEND INTERNAL INTERFACE
@@ -468,6 +558,97 @@ lmon_rc_e LMON_daemon_internal_gather(void *sendbuf, int numbyte_per_elem,
   return LMON_OK;
 }
 
+//! lmon_rc_e LMON_daemon_internal_gatherv
+/*!
+   Gathers variable size data from all tool daemons: each daemon sends
+   numbyte bytes from sendbuf, and the master receives a buffer
+   allocated in recvbuf that holds the data of all daemons back to
+   back in rank order, as well as the number of bytes from daemon i
+   in recvcounts[i]. recvbuf and recvcounts are only meaningful to
+   the master, which must free the buffer. If the master runs out of
+   memory, all daemons return LMON_ENOMEM.
+*/
+lmon_rc_e LMON_daemon_internal_gatherv(void *sendbuf, int numbyte,
+                                       void **recvbuf, int *recvcounts) {
+  int rc;
+
+#if MPI_BASED
+  int rank, size;
+  int *displs = NULL;
+  int allocated = 1;
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  rc = MPI_Gather(&numbyte, 1, MPI_INT, recvcounts, 1, MPI_INT, LMON_BE_MASTER,
+                  MPI_COMM_WORLD);
+  if (rc < 0) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "MPI_Gather failed");
+
+    return LMON_EINVAL;
+  }
+
+  if (rank == LMON_BE_MASTER) {
+    int i, total = 0;
+    for (i = 0; i < size; ++i) total += recvcounts[i];
+
+    displs = (int *)malloc(size * sizeof(int));
+    *recvbuf = malloc(total + 1);
+    if (displs == NULL || *recvbuf == NULL) {
+      LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "malloc returned NULL");
+
+      free(displs);
+      free(*recvbuf);
+      *recvbuf = NULL;
+      allocated = 0;
+    } else {
+      for (total = 0, i = 0; i < size; ++i) {
+        displs[i] = total;
+        total += recvcounts[i];
+      }
+    }
+  }
+
+  //
+  // the others are about to send; let them know whether the master
+  // can take their data so that nobody is left in MPI_Gatherv
+  //
+  rc = MPI_Bcast(&allocated, 1, MPI_INT, LMON_BE_MASTER, MPI_COMM_WORLD);
+  if (rc < 0) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "MPI_Bcast failed");
+
+    free(displs);
+    return LMON_EINVAL;
+  }
+
+  if (!allocated) return LMON_ENOMEM;
+
+  rc = MPI_Gatherv(sendbuf, numbyte, MPI_BYTE,
+                   (rank == LMON_BE_MASTER) ? *recvbuf : NULL, recvcounts,
+                   displs, MPI_BYTE, LMON_BE_MASTER, MPI_COMM_WORLD);
+  free(displs);
+
+  if (rc < 0) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "MPI_Gatherv failed");
+
+    return LMON_EINVAL;
+  }
+#elif COBO_BASED
+  rc = cobo_gatherv(sendbuf, numbyte, recvbuf, recvcounts, LMON_DAEMON_MASTER);
+  if (rc != COBO_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "cobo_gatherv failed");
+
+    return LMON_EINVAL;
+  }
+#else
+  LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+               "no internal comm fabric to leverage");
+  return LMON_EINVAL;
+#endif
+
+  return LMON_OK;
+}
+
 //! lmon_rc_e LMON_daemon_internal_scatter
 /*!
    Scatter data to all tool daemons. Each daemon receives its portion
@@ -506,6 +687,398 @@ lmon_rc_e LMON_daemon_internal_scatter(void *sendbuf, int numbyte_per_element,
   return LMON_OK;
 }
 
+//! lmon_rc_e LMON_daemon_internal_scatterv
+/*!
+   Scatters variable size data to all tool daemons: the master sends
+   sendcounts[i] bytes at sendbuf+displs[i] to daemon i, which
+   receives them into recvbuf of recvcount bytes. sendbuf, sendcounts
+   and displs are only meaningful to the source.
+*/
+lmon_rc_e LMON_daemon_internal_scatterv(void *sendbuf, int *sendcounts,
+                                        int *displs, void *recvbuf,
+                                        int recvcount) {
+  int rc;
+
+#if MPI_BASED
+  rc = MPI_Scatterv(sendbuf, sendcounts, displs, MPI_BYTE, recvbuf, recvcount,
+                    MPI_BYTE, LMON_BE_MASTER, MPI_COMM_WORLD);
+
+  if (rc < 0) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, " MPI_Scatterv failed");
+
+    return LMON_EINVAL;
+  }
+#elif COBO_BASED
+  rc = cobo_scatterv(sendbuf, sendcounts, displs, recvbuf, recvcount,
+                     LMON_DAEMON_MASTER);
+
+  if (rc != COBO_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, " cobo_scatterv failed");
+
+    return LMON_EINVAL;
+  }
+#else
+  LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+               "no internal comm fabric to leverage");
+  return LMON_EINVAL;
+#endif
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_daemon_internal_regReduceOp
+/*!
+   Registers a user reduction op for LMON_daemon_internal_reduce and
+   _allreduce. Every daemon must register its ops in the same order.
+*/
+lmon_rc_e LMON_daemon_internal_regReduceOp(lmon_reduce_fn_t fn, int *op) {
+  int rc;
+
+  if (!fn || numUserReduceOps >= LMON_DAEMON_MAX_USER_OPS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+                 "cannot register more than %d reduction ops",
+                 LMON_DAEMON_MAX_USER_OPS);
+
+    return LMON_EINVAL;
+  }
+
+#if MPI_BASED
+  rc = MPI_Op_create(mpiUserReduceTrampolines[numUserReduceOps], 0,
+                     &mpiUserOps[numUserReduceOps]);
+  if (rc != MPI_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "MPI_Op_create failed");
+
+    return LMON_EINVAL;
+  }
+#elif COBO_BASED
+  rc = cobo_op_create(coboUserReduceTrampolines[numUserReduceOps],
+                      &coboUserOps[numUserReduceOps]);
+  if (rc != COBO_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "cobo_op_create failed");
+
+    return LMON_EINVAL;
+  }
+#else
+  LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+               "no internal comm fabric to leverage");
+  return LMON_EINVAL;
+#endif
+
+  userReduceOps[numUserReduceOps] = fn;
+  (*op) = LMON_OP_USER + numUserReduceOps;
+  numUserReduceOps++;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_daemon_internal_reduce
+/*!
+   Combines count elements of type from every tool daemon with op
+   into recvbuf of the master tool daemon. With COBO, the elements
+   are combined on the way up the tree, so each daemon receives a
+   single array from each of its children.
+*/
+lmon_rc_e LMON_daemon_internal_reduce(void *sendbuf, void *recvbuf, int count,
+                                      lmon_datatype_e type, int op) {
+  int rc;
+
+  if (!validReduceArgs(type, op)) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+                 "invalid reduction type %d or op %d", type, op);
+
+    return LMON_EINVAL;
+  }
+
+#if MPI_BASED
+  rc = MPI_Reduce(sendbuf, recvbuf, count, mpiTypes[type],
+                  (op >= LMON_OP_USER) ? mpiUserOps[op - LMON_OP_USER]
+                                       : mpiOps[op],
+                  LMON_BE_MASTER, MPI_COMM_WORLD);
+
+  if (rc != MPI_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "MPI_Reduce failed");
+
+    return LMON_EINVAL;
+  }
+#elif COBO_BASED
+  rc = cobo_reduce(sendbuf, recvbuf, count, coboTypes[type],
+                   (op >= LMON_OP_USER) ? coboUserOps[op - LMON_OP_USER]
+                                        : coboOps[op],
+                   LMON_DAEMON_MASTER);
+
+  if (rc != COBO_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "cobo_reduce failed");
+
+    return LMON_EINVAL;
+  }
+#else
+  LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+               "no internal comm fabric to leverage");
+  return LMON_EINVAL;
+#endif
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_daemon_internal_allreduce
+/*!
+   Like LMON_daemon_internal_reduce, but every tool daemon receives
+   the result into recvbuf.
+*/
+lmon_rc_e LMON_daemon_internal_allreduce(void *sendbuf, void *recvbuf,
+                                         int count, lmon_datatype_e type,
+                                         int op) {
+  int rc;
+
+  if (!validReduceArgs(type, op)) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+                 "invalid reduction type %d or op %d", type, op);
+
+    return LMON_EINVAL;
+  }
+
+#if MPI_BASED
+  rc = MPI_Allreduce(sendbuf, recvbuf, count, mpiTypes[type],
+                     (op >= LMON_OP_USER) ? mpiUserOps[op - LMON_OP_USER]
+                                          : mpiOps[op],
+                     MPI_COMM_WORLD);
+
+  if (rc != MPI_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "MPI_Allreduce failed");
+
+    return LMON_EINVAL;
+  }
+#elif COBO_BASED
+  rc = cobo_allreduce(sendbuf, recvbuf, count, coboTypes[type],
+                      (op >= LMON_OP_USER) ? coboUserOps[op - LMON_OP_USER]
+                                           : coboOps[op]);
+
+  if (rc != COBO_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "cobo_allreduce failed");
+
+    return LMON_EINVAL;
+  }
+#else
+  LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+               "no internal comm fabric to leverage");
+  return LMON_EINVAL;
+#endif
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_daemon_internal_ibarrier
+/*!
+   Starts a barrier across tool daemons and returns right away; req
+   completes through LMON_daemon_internal_test or _wait. Without
+   MPI-3 non-blocking collectives, the MPI path runs the blocking
+   call and returns a completed (NULL) request.
+*/
+lmon_rc_e LMON_daemon_internal_ibarrier(lmon_request_t *req) {
+  int rc;
+
+#if MPI_BASED
+#if MPI_VERSION >= 3
+  MPI_Request *mreq = new MPI_Request;
+  if ((rc = MPI_Ibarrier(MPI_COMM_WORLD, mreq)) != MPI_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "MPI_Ibarrier failed ");
+    delete mreq;
+
+    return LMON_EINVAL;
+  }
+  (*req) = (lmon_request_t)mreq;
+#else
+  (*req) = LMON_REQUEST_NULL;
+  return LMON_daemon_internal_barrier();
+#endif
+#elif COBO_BASED
+  cobo_request creq;
+  if ((rc = cobo_ibarrier(&creq)) != COBO_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "cobo_ibarrier failed ");
+
+    return LMON_EINVAL;
+  }
+  (*req) = (lmon_request_t)creq;
+#else
+  LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+               "no internal comm fabric to leverage");
+  return LMON_EINVAL;
+#endif
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_daemon_internal_ibroadcast
+/*!
+   Non-blocking LMON_daemon_internal_broadcast; buf must not be
+   touched until req completes.
+*/
+lmon_rc_e LMON_daemon_internal_ibroadcast(void *buf, int numbyte,
+                                          lmon_request_t *req) {
+  int rc;
+
+#if MPI_BASED
+#if MPI_VERSION >= 3
+  MPI_Request *mreq = new MPI_Request;
+  if ((rc = MPI_Ibcast(buf, numbyte, MPI_BYTE, LMON_BE_MASTER, MPI_COMM_WORLD,
+                       mreq)) != MPI_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, " MPI_Ibcast failed");
+    delete mreq;
+
+    return LMON_EINVAL;
+  }
+  (*req) = (lmon_request_t)mreq;
+#else
+  (*req) = LMON_REQUEST_NULL;
+  return LMON_daemon_internal_broadcast(buf, numbyte);
+#endif
+#elif COBO_BASED
+  cobo_request creq;
+  if ((rc = cobo_ibcast(buf, numbyte, LMON_DAEMON_MASTER, &creq)) !=
+      COBO_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, " cobo_ibcast failed");
+
+    return LMON_EINVAL;
+  }
+  (*req) = (lmon_request_t)creq;
+#else
+  LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+               "no internal comm fabric to leverage");
+  return LMON_EINVAL;
+#endif
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_daemon_internal_igather
+/*!
+   Non-blocking LMON_daemon_internal_gather; sendbuf and recvbuf
+   must not be touched until req completes.
+*/
+lmon_rc_e LMON_daemon_internal_igather(void *sendbuf, int numbyte_per_elem,
+                                       void *recvbuf, lmon_request_t *req) {
+  int rc;
+
+#if MPI_BASED
+#if MPI_VERSION >= 3
+  MPI_Request *mreq = new MPI_Request;
+  rc = MPI_Igather(sendbuf, numbyte_per_elem, MPI_BYTE, recvbuf,
+                   numbyte_per_elem, MPI_BYTE, LMON_BE_MASTER, MPI_COMM_WORLD,
+                   mreq);
+
+  if (rc != MPI_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "MPI_Igather failed");
+    delete mreq;
+
+    return LMON_EINVAL;
+  }
+  (*req) = (lmon_request_t)mreq;
+#else
+  (*req) = LMON_REQUEST_NULL;
+  return LMON_daemon_internal_gather(sendbuf, numbyte_per_elem, recvbuf);
+#endif
+#elif COBO_BASED
+  cobo_request creq;
+  rc = cobo_igather(sendbuf, numbyte_per_elem, recvbuf, LMON_DAEMON_MASTER,
+                    &creq);
+  if (rc != COBO_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "cobo_igather failed");
+
+    return LMON_EINVAL;
+  }
+  (*req) = (lmon_request_t)creq;
+#else
+  LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+               "no internal comm fabric to leverage");
+  return LMON_EINVAL;
+#endif
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_daemon_internal_test
+/*!
+   Advances outstanding non-blocking collectives without waiting.
+   Sets flag to 1 and req to LMON_REQUEST_NULL once req has
+   completed, to 0 otherwise.
+*/
+lmon_rc_e LMON_daemon_internal_test(lmon_request_t *req, int *flag) {
+  int rc;
+
+  (*flag) = 1;
+  if ((*req) == LMON_REQUEST_NULL) {
+    return LMON_OK;
+  }
+
+#if MPI_BASED
+#if MPI_VERSION >= 3
+  MPI_Request *mreq = (MPI_Request *)(*req);
+  if ((rc = MPI_Test(mreq, flag, MPI_STATUS_IGNORE)) != MPI_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "MPI_Test failed");
+
+    return LMON_EINVAL;
+  }
+  if (*flag) {
+    delete mreq;
+    (*req) = LMON_REQUEST_NULL;
+  }
+#endif
+#elif COBO_BASED
+  cobo_request creq = (cobo_request)(*req);
+  if ((rc = cobo_test(&creq, flag)) != COBO_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "cobo_test failed");
+
+    return LMON_EINVAL;
+  }
+  (*req) = (lmon_request_t)creq;
+#else
+  LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+               "no internal comm fabric to leverage");
+  return LMON_EINVAL;
+#endif
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_daemon_internal_wait
+/*!
+   Waits until req has completed and sets it to LMON_REQUEST_NULL.
+*/
+lmon_rc_e LMON_daemon_internal_wait(lmon_request_t *req) {
+  int rc;
+
+  if ((*req) == LMON_REQUEST_NULL) {
+    return LMON_OK;
+  }
+
+#if MPI_BASED
+#if MPI_VERSION >= 3
+  MPI_Request *mreq = (MPI_Request *)(*req);
+  if ((rc = MPI_Wait(mreq, MPI_STATUS_IGNORE)) != MPI_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "MPI_Wait failed");
+
+    return LMON_EINVAL;
+  }
+  delete mreq;
+  (*req) = LMON_REQUEST_NULL;
+#endif
+#elif COBO_BASED
+  cobo_request creq = (cobo_request)(*req);
+  if ((rc = cobo_wait(&creq)) != COBO_SUCCESS) {
+    LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true, "cobo_wait failed");
+
+    return LMON_EINVAL;
+  }
+  (*req) = LMON_REQUEST_NULL;
+#else
+  LMON_say_msg(LMON_DAEMON_MSG_PREFIX, true,
+               "no internal comm fabric to leverage");
+  return LMON_EINVAL;
+#endif
+
+  return LMON_OK;
+}
+
 //! LMON_daemon_internal_finalize();
 /*
   Finalizes the LMON BACKEND API. Every daemon must call this to
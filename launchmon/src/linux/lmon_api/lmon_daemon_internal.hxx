@@ -133,6 +133,19 @@ typedef struct _per_be_data_t {
    */
   int proctab_msg_size; /* to hold the size of proctab_msg */
 
+  /*
+   * 1 if proctab_msg only holds this daemon's host slice
+   */
+  int proctab_sharded;
+
+  /*
+   * the whole raw proctab message: the same as proctab_msg if it
+   * was broadcast, otherwise NULL except on the master until
+   * LMON_be_fetchProctable is called
+   */
+  lmonp_t *proctab_full_msg;
+  int proctab_full_msg_size;
+
 } per_be_data_t;
 
 typedef struct _per_mw_data_t {
@@ -160,10 +173,42 @@ extern lmon_rc_e LMON_daemon_internal_gather(void *sendbuf,
                                              int numbyte_per_elem,
                                              void *recvbuf);
 
+extern lmon_rc_e LMON_daemon_internal_gatherv(void *sendbuf, int numbyte,
+                                              void **recvbuf, int *recvcounts);
+
 extern lmon_rc_e LMON_daemon_internal_scatter(void *sendbuf,
                                               int numbyte_per_element,
                                               void *recvbuf);
 
+extern lmon_rc_e LMON_daemon_internal_scatterv(void *sendbuf, int *sendcounts,
+                                               int *displs, void *recvbuf,
+                                               int recvcount);
+
+extern lmon_rc_e LMON_daemon_internal_regReduceOp(lmon_reduce_fn_t fn,
+                                                 int *op);
+
+extern lmon_rc_e LMON_daemon_internal_reduce(void *sendbuf, void *recvbuf,
+                                             int count, lmon_datatype_e type,
+                                             int op);
+
+extern lmon_rc_e LMON_daemon_internal_allreduce(void *sendbuf, void *recvbuf,
+                                                int count,
+                                                lmon_datatype_e type, int op);
+
+extern lmon_rc_e LMON_daemon_internal_ibarrier(lmon_request_t *req);
+
+extern lmon_rc_e LMON_daemon_internal_ibroadcast(void *buf, int numbyte,
+                                                 lmon_request_t *req);
+
+extern lmon_rc_e LMON_daemon_internal_igather(void *sendbuf,
+                                              int numbyte_per_elem,
+                                              void *recvbuf,
+                                              lmon_request_t *req);
+
+extern lmon_rc_e LMON_daemon_internal_test(lmon_request_t *req, int *flag);
+
+extern lmon_rc_e LMON_daemon_internal_wait(lmon_request_t *req);
+
 extern lmon_rc_e LMON_daemon_internal_finalize(int is_be);
 extern lmon_rc_e LMON_daemon_getWhereToConnect(struct sockaddr_in *servaddr);
 extern lmon_rc_e LMON_daemon_gethostname(bool bgion, char *my_hostname,
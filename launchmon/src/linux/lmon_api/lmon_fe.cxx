@@ -153,6 +153,7 @@
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
@@ -203,6 +204,7 @@ const int DFLT_FE_ENGINE_TOUT = 120;
 const int DFLT_FE_BE_TOUT = 120;
 const int DFLT_FE_MW_TOUT = 120;
 const int MAX_TIMEOUT = 6000;
+const int DFLT_FE_RPDTAB_CHUNK = 65536;
 const char *LMON_FE_MSG_PREFIX = "<LMON FE API>";
 
 //////////////////////////////////////////////////////////////////////////////////
@@ -227,11 +229,15 @@ const int conn_size = 3;
 
 typedef int64_t lmon_reshandle_t;
 
-class lexGraphCmp {
+class hostNameCmp {
  public:
-  bool operator()(const std::string &s1, const std::string &s2) {
-    return (s1 < s2);
+  hostNameCmp(const std::vector<lmon_proctab_host_t> &h) : hosts(h) {}
+  bool operator()(int h1, int h2) const {
+    return (strcmp(hosts[h1].host_name, hosts[h2].host_name) < 0);
   }
+
+ private:
+  const std::vector<lmon_proctab_host_t> &hosts;
 };
 
 //! lmon_session_comm_desc_t
@@ -426,9 +432,48 @@ typedef struct _lmon_session_desc_t {
   lmonp_t *hntab_mw_msg;
 
   /*
-   * the host list constructed from proctab_msg
+   * the indices built over proctab_msg when it arrives:
+   * proctab_view groups the tasks by host through proctab_order
+   * and proctab_hosts, proctab_hosts_sorted lists the hosts in
+   * lexicographical order and proctab_rank_pos maps an MPI rank
+   * to its position in proctab_view (-1 if absent)
+   */
+  lmon_proctab_view_t proctab_view;
+  char *proctab_tofree;
+  std::vector<unsigned int> proctab_order;
+  std::vector<lmon_proctab_host_t> proctab_hosts;
+  std::vector<int> proctab_hosts_sorted;
+  std::vector<int> proctab_rank_pos;
+
+  /*
+   * the latest engine statistics snapshot and the number of
+   * snapshots received so far
    */
-  std::map<std::string, std::vector<MPIR_PROCDESC_EXT *>, lexGraphCmp> pMap;
+  lmon_engine_stats_t *engine_stats;
+  unsigned int engine_stats_seq;
+
+  /*
+   * the RPDTAB encoding negotiated with the engine; a streamed
+   * proctable is re-encoded here once reassembled
+   */
+  lmon_rpdtab_enc_e rpdtab_enc;
+
+  /*
+   * the proctable stream being reassembled: proctab_streaming is
+   * set from lmonp_proctable_begin until lmonp_proctable_end.
+   * proctab_stream_hosts points into proctab_stream_hostbuf, the
+   * host list the stream begins with, which daemon bootstrapping
+   * uses before the proctable is complete. The entries and string
+   * table of the chunks received so far are gathered in
+   * proctab_stream_entries and proctab_stream_strtab.
+   */
+  boolean_e proctab_streaming;
+  unsigned int proctab_stream_ntasks;
+  unsigned int proctab_stream_nrecvd;
+  std::vector<char> proctab_stream_hostbuf;
+  std::vector<const char *> proctab_stream_hosts;
+  std::vector<char> proctab_stream_entries;
+  std::vector<char> proctab_stream_strtab;
 
   /*
    * the vector of spawner objects
@@ -666,7 +711,16 @@ static int LMON_init_sess(lmon_session_desc_t *s) {
   s->proctab_msg = NULL;
   s->hntab_msg = NULL;
 
-  // make_sure: s->pMap.size == 0
+  // make_sure: s->proctab_hosts.empty()
+  bzero(&(s->proctab_view), sizeof(s->proctab_view));
+  s->proctab_view.my_host = LMON_INIT;
+  s->proctab_tofree = NULL;
+  s->engine_stats = NULL;
+  s->engine_stats_seq = 0;
+  s->rpdtab_enc = lmon_rpdtab_legacy;
+  s->proctab_streaming = LMON_FALSE;
+  s->proctab_stream_ntasks = 0;
+  s->proctab_stream_nrecvd = 0;
   s->resourceHandle = LMON_INIT;
 
   // make_sure: s->spawner_vector.empty()
@@ -738,24 +792,24 @@ static int LMON_destroy_sess(lmon_session_desc_t *s) {
 
   s->resourceHandle = LMON_INIT;
 
-  if (s->pMap.size() != 0) {
-    //
-    // TODO: ugly, someday, change pointers to smart pointers
-    // that mix well with STL
-    //
-    std::map<std::string, std::vector<MPIR_PROCDESC_EXT *>,
-             lexGraphCmp>::iterator iter;
-    std::vector<MPIR_PROCDESC_EXT *>::iterator vectiter;
-    for (iter = s->pMap.begin(); iter != s->pMap.end(); ++iter) {
-      for (vectiter = iter->second.begin(); vectiter != iter->second.end();
-           ++vectiter) {
-        free((*vectiter)->pd.executable_name);
-        free((*vectiter)->pd.host_name);
-        free((*vectiter));
-      }
-    }
-    s->pMap.clear();
-  }
+  if (s->proctab_tofree) free(s->proctab_tofree);
+  s->proctab_tofree = NULL;
+  s->proctab_order.clear();
+  s->proctab_hosts.clear();
+  s->proctab_hosts_sorted.clear();
+  s->proctab_rank_pos.clear();
+
+  if (s->engine_stats) free(s->engine_stats);
+  s->engine_stats = NULL;
+  s->engine_stats_seq = 0;
+
+  s->proctab_streaming = LMON_FALSE;
+  s->proctab_stream_ntasks = 0;
+  s->proctab_stream_nrecvd = 0;
+  std::vector<char>().swap(s->proctab_stream_hostbuf);
+  std::vector<const char *>().swap(s->proctab_stream_hosts);
+  std::vector<char>().swap(s->proctab_stream_entries);
+  std::vector<char>().swap(s->proctab_stream_strtab);
 
   if (!s->spawner_vector.empty()) {
     std::vector<spawner_base_t *>::iterator iter;
@@ -1280,41 +1334,53 @@ static lmon_rc_e LMON_assist_ICCL_BE_init(lmon_session_desc_t *mydesc) {
   else
     tosec = DFLT_FE_BE_TOUT;
 
-  if (!mydesc->proctab_msg) {
+  //
+  // The host list comes from the proctable or, while a proctable
+  // stream is still arriving, from the stream's first message. Both
+  // list the hosts in the same order.
+  //
+  pthread_mutex_lock(&(mydesc->watchdogThr.eventMutex));
+  if (!mydesc->proctab_msg && mydesc->proctab_streaming != LMON_TRUE) {
+    pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
     LMON_say_msg(LMON_FE_MSG_PREFIX, true,
                  "proctab msg has not yet arrived from the launchmon engine! A "
                  "race condition?");
 
     return LMON_EBUG;
   } else {
-    if (parse_raw_RPDTAB_msg(mydesc->proctab_msg, &(mydesc->pMap)) < 0) {
-      LMON_say_msg(LMON_FE_MSG_PREFIX, false, "failed to parse MPIR_proctable");
-
-      return LMON_ESYS;
-    }
-
-    if ((mydesc->pMap.size()) != 0) {
+    size_t nhosts = mydesc->proctab_msg ? mydesc->proctab_hosts.size()
+                                        : mydesc->proctab_stream_hosts.size();
+    if (nhosts > 0) {
       int j;
-      std::map<std::string, std::vector<MPIR_PROCDESC_EXT *> >::const_iterator
-          iter;
-      hostlist =
-          (const char **)malloc(mydesc->pMap.size() * sizeof(const char *));
+      std::vector<int>::const_iterator iter;
+      hostlist = (const char **)malloc(nhosts * sizeof(const char *));
       if (hostlist == NULL) {
+        pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
         LMON_say_msg(LMON_FE_MSG_PREFIX, false, "malloc returned NULL");
 
         return LMON_ENOMEM;
       }
 
-      for (iter = mydesc->pMap.begin(); iter != mydesc->pMap.end(); iter++) {
-        // Unless mydesc->pMap destroyed strings that hostlist points
-        // to should be valid
-        hostlist[hcnt] = iter->first.c_str();
-        hcnt++;
+      if (mydesc->proctab_msg) {
+        for (iter = mydesc->proctab_hosts_sorted.begin();
+             iter != mydesc->proctab_hosts_sorted.end(); iter++) {
+          // host names point into proctab_msg or proctab_tofree
+          // both of which live as long as the session
+          hostlist[hcnt] = mydesc->proctab_hosts[(*iter)].host_name;
+          hcnt++;
+        }
+      } else {
+        // host names point into proctab_stream_hostbuf, which
+        // lives as long as the session
+        for (hcnt = 0; hcnt < nhosts; hcnt++) {
+          hostlist[hcnt] = mydesc->proctab_stream_hosts[hcnt];
+        }
       }
 
       /* This is only for testing */
       portlist = (int *)malloc(COBO_PORT_RANGE * sizeof(int));
       if (portlist == NULL) {
+        pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
         LMON_say_msg(LMON_FE_MSG_PREFIX, false, "malloc returned NULL");
 
         return LMON_ENOMEM;
@@ -1323,9 +1389,9 @@ static lmon_rc_e LMON_assist_ICCL_BE_init(lmon_session_desc_t *mydesc) {
       for (j = 0; j < COBO_PORT_RANGE; ++j) portlist[j] = COBO_BEGIN_PORT + j;
     }
   }
+  pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
 
-  mydesc->commDesc[fe_be_conn].nDaemons =
-      mydesc->proctab_msg->sec_or_stringinfo.exec_and_hn.num_host_name;
+  mydesc->commDesc[fe_be_conn].nDaemons = (int)hcnt;
   ndmons = mydesc->commDesc[fe_be_conn].nDaemons;
 
   if (set_cobosec_mode() < 0) {
@@ -1561,6 +1627,43 @@ static bool LMON_fe_is_secure(unsigned char *decryptedID, int k_len,
   return true;
 }
 
+//! LMON_wait_for_proctab
+/*!
+  blocks until a proctable stream still arriving is complete
+*/
+static lmon_rc_e LMON_wait_for_proctab(lmon_session_desc_t *mydesc) {
+  struct timespec ts;
+  char *tout = getenv("LMON_FE_ENGINE_TIMEOUT");
+  lmon_rc_e lrc = LMON_OK;
+  int prc;
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+  if (tout && ((atoi(tout) > 0) && (atoi(tout) <= MAX_TIMEOUT)))
+    ts.tv_sec += atoi(tout);
+  else
+    ts.tv_sec += DFLT_FE_ENGINE_TOUT;
+
+  pthread_mutex_lock(&(mydesc->watchdogThr.eventMutex));
+  while (!mydesc->proctab_msg && mydesc->proctab_streaming == LMON_TRUE) {
+    prc = pthread_cond_timedwait(&(mydesc->watchdogThr.condVar),
+                                 &(mydesc->watchdogThr.eventMutex), &ts);
+    if (prc == ETIMEDOUT) {
+      LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                   "timed out waiting for the proctable stream");
+      lrc = LMON_ETOUT;
+      break;
+    } else if (prc != 0) {
+      lrc = LMON_EBUG;
+      break;
+    }
+  }
+
+  if (lrc == LMON_OK && !mydesc->proctab_msg) lrc = LMON_EBUG;
+  pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+
+  return lrc;
+}
+
 //! lmon_rc_e LMON_fe_beHandshakeSequence
 /*!
     -- assist BE's ICCL layer bootstrap (this can be NOOP most of the cases)
@@ -1767,7 +1870,11 @@ static lmon_rc_e LMON_fe_beHandshakeSequence(
     return LMON_ESYS;
   }
 
-  if (mydesc->proctab_msg == NULL) return LMON_EBUG;
+  //
+  // a streamed proctable may still be arriving
+  //
+  lmon_rc_e wrc;
+  if ((wrc = LMON_wait_for_proctab(mydesc)) != LMON_OK) return wrc;
 
   //
   // PROCTAB MSG
@@ -2161,6 +2268,30 @@ static lmon_rc_e LMON_set_options(lmon_session_desc_t *mydesc, opts_args_t &opt,
   optcontext->attach = attach;
   optcontext->tool_daemon = toolDaemon;
 
+  //
+  // The engine ships the RPDTAB in the compact format unless
+  // LMON_FE_RPDTAB_ENCODING says otherwise ("legacy" or "lz4").
+  // The BE and MW APIs understand every encoding this FE does.
+  //
+  if (getenv("LMON_FE_RPDTAB_ENCODING")) {
+    optcontext->rpdtab_enc = getenv("LMON_FE_RPDTAB_ENCODING");
+  } else {
+    optcontext->rpdtab_enc = "compact";
+  }
+  mydesc->rpdtab_enc = str_to_rpdtab_enc(optcontext->rpdtab_enc.c_str());
+
+  //
+  // Proctables larger than this many tasks are streamed in chunks
+  // of that size unless LMON_FE_RPDTAB_CHUNK says otherwise; 0 has
+  // the engine ship every proctable in a single message.
+  //
+  if (getenv("LMON_FE_RPDTAB_CHUNK")) {
+    optcontext->rpdtab_chunk = atoi(getenv("LMON_FE_RPDTAB_CHUNK"));
+    if (optcontext->rpdtab_chunk < 0) optcontext->rpdtab_chunk = 0;
+  } else {
+    optcontext->rpdtab_chunk = DFLT_FE_RPDTAB_CHUNK;
+  }
+
   if (launcher != NULL) {
     optcontext->debugtarget = launcher;
   }
@@ -2295,6 +2426,71 @@ static lmon_rc_e LMON_openBindAndListen(int *sfd) {
   return LMON_OK;
 }
 
+//! LMON_index_proctab
+/*!
+  builds the per-session proctable indices over mydesc->proctab_msg
+  so that the proctable access functions need not decode or copy it
+  return 0 on success; -1 on failure
+*/
+static int LMON_index_proctab(lmon_session_desc_t *mydesc) {
+  unsigned int ntasks;
+  unsigned int i;
+  char *entries;
+  char *strtab = NULL;
+  lmon_proctab_view_t *v = &(mydesc->proctab_view);
+
+  ntasks = RPDTAB_msg_ntasks(mydesc->proctab_msg);
+
+  bzero(v, sizeof(*v));
+  v->my_host = LMON_INIT;
+  if (ntasks == 0) return 0;
+
+  entries = get_RPDTAB_entries(mydesc->proctab_msg, &strtab,
+                               &(mydesc->proctab_tofree));
+  if (!entries || !strtab) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true, "failed to decode the proctable");
+
+    return -1;
+  }
+
+  mydesc->proctab_order.resize(ntasks);
+  if (index_RPDTAB_entries(entries, strtab, ntasks, &(mydesc->proctab_order[0]),
+                           &(mydesc->proctab_hosts)) < 0) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true, "failed to index the proctable");
+
+    return -1;
+  }
+
+  v->num_tasks = (int)ntasks;
+  v->num_hosts = (int)mydesc->proctab_hosts.size();
+  v->hosts = &(mydesc->proctab_hosts[0]);
+  v->order = &(mydesc->proctab_order[0]);
+  v->entries = (const unsigned int *)entries;
+  v->strtab = strtab;
+
+  mydesc->proctab_hosts_sorted.resize(mydesc->proctab_hosts.size());
+  for (i = 0; i < mydesc->proctab_hosts_sorted.size(); ++i)
+    mydesc->proctab_hosts_sorted[i] = (int)i;
+  std::sort(mydesc->proctab_hosts_sorted.begin(),
+            mydesc->proctab_hosts_sorted.end(),
+            hostNameCmp(mydesc->proctab_hosts));
+
+  //
+  // MPI ranks are dense in [0, ntasks), so a flat array gives
+  // the O(1) lookup; out-of-range ranks are left unindexed
+  //
+  mydesc->proctab_rank_pos.assign(ntasks, LMON_INIT);
+  for (i = 0; i < ntasks; ++i) {
+    int r = LMON_view_mpirank(v, i);
+    if (r >= 0 && (unsigned int)r < ntasks &&
+        mydesc->proctab_rank_pos[r] == LMON_INIT) {
+      mydesc->proctab_rank_pos[r] = (int)i;
+    }
+  }
+
+  return 0;
+}
+
 //! LMON_handle_proctab_event
 /*!
   fetches the proctable message from the LaunchMON Engine
@@ -2334,9 +2530,178 @@ static int LMON_handle_proctab_event(int readingFd, lmon_session_desc_t *mydesc,
   //
   mydesc->proctab_msg = (lmonp_t *)proctab_message;
 
+  return LMON_index_proctab(mydesc);
+}
+
+//! LMON_handle_proctab_begin_event
+/*!
+  starts reassembling a proctable stream from the LaunchMON Engine
+  and keeps the host list the stream begins with
+*/
+static int LMON_handle_proctab_begin_event(int readingFd,
+                                           lmon_session_desc_t *mydesc,
+                                           lmonp_t *msg) {
+  unsigned int len = msg->lmon_payload_length + msg->usr_payload_length;
+  unsigned int ntasks;
+  size_t i;
+
+  ntasks = RPDTAB_msg_ntasks(msg);
+
+  mydesc->proctab_stream_hostbuf.resize(len);
+  if (len > 0 && read_lmonp_payloads(readingFd,
+                                     &(mydesc->proctab_stream_hostbuf[0]),
+                                     len) != (int)len) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                 "read_lmonp_payloads returned a bad return code");
+
+    return -1;
+  }
+
+  if (len > 0 && mydesc->proctab_stream_hostbuf[len - 1] != '\0') {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                 "the proctable stream begins with a malformed host list");
+
+    return -1;
+  }
+
+  mydesc->proctab_stream_hosts.clear();
+  for (i = 0; i < len; i += strlen(&(mydesc->proctab_stream_hostbuf[i])) + 1) {
+    mydesc->proctab_stream_hosts.push_back(
+        &(mydesc->proctab_stream_hostbuf[i]));
+  }
+
+  mydesc->proctab_stream_ntasks = ntasks;
+  mydesc->proctab_stream_nrecvd = 0;
+  mydesc->proctab_stream_entries.resize(
+      (size_t)ntasks * N_Fields_MPIR_PROCDESC_EXT * sizeof(unsigned int));
+  mydesc->proctab_stream_strtab.clear();
+  mydesc->proctab_streaming = LMON_TRUE;
+
   return 0;
 }
 
+//! LMON_handle_proctab_chunk_event
+/*!
+  appends the entries and the string table bytes of a proctable
+  stream chunk. Chunks must arrive in task order.
+*/
+static int LMON_handle_proctab_chunk_event(int readingFd,
+                                           lmon_session_desc_t *mydesc,
+                                           lmonp_t *msg) {
+  const size_t esize = N_Fields_MPIR_PROCDESC_EXT * sizeof(unsigned int);
+  size_t len = msg->lmon_payload_length + msg->usr_payload_length;
+  uint32_t range[2];
+  size_t elen, slen, soff;
+
+  if (mydesc->proctab_streaming != LMON_TRUE || len < sizeof(range)) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                 "a proctable chunk arrived outside of a stream");
+
+    return -1;
+  }
+
+  if (read_lmonp_payloads(readingFd, range, sizeof(range)) !=
+      (int)sizeof(range)) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                 "read_lmonp_payloads returned a bad return code");
+
+    return -1;
+  }
+
+  elen = (size_t)range[1] * esize;
+  if (range[0] != mydesc->proctab_stream_nrecvd ||
+      range[1] > mydesc->proctab_stream_ntasks - range[0] ||
+      elen > len - sizeof(range)) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                 "a proctable chunk [%u, +%u) arrived out of order",
+                 range[0], range[1]);
+
+    return -1;
+  }
+
+  if (elen > 0 &&
+      read_lmonp_payloads(readingFd,
+                          &(mydesc->proctab_stream_entries[range[0] * esize]),
+                          elen) != (int)elen) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                 "read_lmonp_payloads returned a bad return code");
+
+    return -1;
+  }
+
+  slen = len - sizeof(range) - elen;
+  soff = mydesc->proctab_stream_strtab.size();
+  mydesc->proctab_stream_strtab.resize(soff + slen);
+  if (slen > 0 &&
+      read_lmonp_payloads(readingFd, &(mydesc->proctab_stream_strtab[soff]),
+                          slen) != (int)slen) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                 "read_lmonp_payloads returned a bad return code");
+
+    return -1;
+  }
+
+  mydesc->proctab_stream_nrecvd += range[1];
+
+  return 0;
+}
+
+//! LMON_handle_proctab_end_event
+/*!
+  turns a complete proctable stream into the proctable message
+  lmonp_proctable_avail would have carried, re-encoded as negotiated
+*/
+static int LMON_handle_proctab_end_event(int readingFd,
+                                         lmon_session_desc_t *mydesc,
+                                         lmonp_t *msg) {
+  size_t elen = mydesc->proctab_stream_entries.size();
+  size_t slen = mydesc->proctab_stream_strtab.size();
+  lmonp_t *proctab_message;
+  char *trav_ptr;
+
+  if (mydesc->proctab_streaming != LMON_TRUE ||
+      mydesc->proctab_stream_nrecvd != mydesc->proctab_stream_ntasks ||
+      (msg->lmon_payload_length + msg->usr_payload_length) != 0) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                 "the proctable stream ended incomplete: %u of %u tasks",
+                 mydesc->proctab_stream_nrecvd, mydesc->proctab_stream_ntasks);
+
+    return -1;
+  }
+
+  proctab_message = (lmonp_t *)malloc(sizeof(*msg) + elen + slen);
+  if (proctab_message == NULL) return LMON_ENOMEM;
+
+  memcpy(proctab_message, msg, sizeof(*msg));
+  proctab_message->type.fetofe_type = lmonp_proctable_avail;
+  proctab_message->lmon_payload_length = elen + slen;
+  trav_ptr = (char *)proctab_message + sizeof(*msg);
+  if (elen > 0) memcpy(trav_ptr, &(mydesc->proctab_stream_entries[0]), elen);
+  if (slen > 0)
+    memcpy(trav_ptr + elen, &(mydesc->proctab_stream_strtab[0]), slen);
+
+  std::vector<char>().swap(mydesc->proctab_stream_entries);
+  std::vector<char>().swap(mydesc->proctab_stream_strtab);
+
+  //
+  // The engine streams the legacy layout and leaves the encoding to us
+  //
+  if (mydesc->rpdtab_enc != lmon_rpdtab_legacy) {
+    int cmptsize = 0;
+    lmonp_t *cmptbuf =
+        compact_RPDTAB_msg(proctab_message, mydesc->rpdtab_enc, &cmptsize);
+    if (cmptbuf) {
+      free(proctab_message);
+      proctab_message = cmptbuf;
+    }
+  }
+
+  mydesc->proctab_msg = proctab_message;
+  mydesc->proctab_streaming = LMON_FALSE;
+
+  return LMON_index_proctab(mydesc);
+}
+
 static int LMON_handle_resourcehandle_event(int readingFd,
                                             lmon_session_desc_t *mydesc,
                                             lmonp_t *msg) {
@@ -2407,6 +2772,43 @@ static int LMON_handle_rminfo_event(int readingFd, lmon_session_desc_t *mydesc,
   return (i < mydesc->rm_info.num_supported_types) ? 0 : -1;
 }
 
+//! LMON_handle_stats_event
+/*!
+    stores the engine statistics snapshot carried by an lmonp_stats
+    message; the caller must hold eventMutex.
+*/
+static int LMON_handle_stats_event(int readingFd, lmon_session_desc_t *mydesc,
+                                   lmonp_t *msg) {
+  int bytesread;
+
+  if ((msg->lmon_payload_length + msg->usr_payload_length) !=
+      sizeof(lmon_engine_stats_t)) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                 "payload size mismatch detected during "
+                 "LMON_handle_stats_event");
+    return -1;
+  }
+
+  if (mydesc->engine_stats == NULL) {
+    mydesc->engine_stats =
+        (lmon_engine_stats_t *)malloc(sizeof(lmon_engine_stats_t));
+    if (mydesc->engine_stats == NULL) return -1;
+  }
+
+  bytesread = read_lmonp_payloads(readingFd, mydesc->engine_stats,
+                                  sizeof(lmon_engine_stats_t));
+
+  if (bytesread != (int)sizeof(lmon_engine_stats_t)) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                 "read_lmonp_payloads returned a bad return code");
+    return -1;
+  }
+
+  mydesc->engine_stats_seq++;
+
+  return 0;
+}
+
 static void LMON_child_fork_handler(void) {
   int i;
   lmon_session_desc_t *mydesc;
@@ -2596,6 +2998,69 @@ static void *LMON_fetofe_watchdog_thread(void *arg) {
         pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
         break;
 
+      case lmonp_proctable_begin:
+        //
+        // The proctable is about to be streamed. The host list is
+        // all it takes to get daemon launching under way, so the
+        // main thread is let go as with lmonp_proctable_avail and
+        // waits for the rest only when it needs the proctable.
+        //
+        pthread_mutex_lock(&(mydesc->watchdogThr.eventMutex));
+        if (LMON_handle_proctab_begin_event(readingFd, mydesc, &msg) != 0) {
+          LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                       "LMON_handle_proctab_begin_event failed");
+
+          pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+          goto watchdog_done;
+        }
+        mydesc->spawned = LMON_TRUE;
+        fe_getStatus(mydesc, &status);
+        if (mydesc->statusCB != NULL) {
+          if (mydesc->statusCB(&status) != 0) {
+            LMON_say_msg(
+                LMON_FE_MSG_PREFIX, false,
+                "registered status call back returned non-zero... continue");
+          }
+        }
+#if VERBOSE
+        LMON_say_msg(LMON_FE_MSG_PREFIX, false, "RPDTAB stream begins...");
+#endif
+        pthread_cond_signal(&(mydesc->watchdogThr.condVar));
+        pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+        break;
+
+      case lmonp_proctable_chunk:
+        pthread_mutex_lock(&(mydesc->watchdogThr.eventMutex));
+        if (LMON_handle_proctab_chunk_event(readingFd, mydesc, &msg) != 0) {
+          LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                       "LMON_handle_proctab_chunk_event failed");
+
+          mydesc->proctab_streaming = LMON_FALSE;
+          pthread_cond_signal(&(mydesc->watchdogThr.condVar));
+          pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+          goto watchdog_done;
+        }
+        pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+        break;
+
+      case lmonp_proctable_end:
+        pthread_mutex_lock(&(mydesc->watchdogThr.eventMutex));
+        if (LMON_handle_proctab_end_event(readingFd, mydesc, &msg) != 0) {
+          LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                       "LMON_handle_proctab_end_event failed");
+
+          mydesc->proctab_streaming = LMON_FALSE;
+          pthread_cond_signal(&(mydesc->watchdogThr.condVar));
+          pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+          goto watchdog_done;
+        }
+#if VERBOSE
+        LMON_say_msg(LMON_FE_MSG_PREFIX, false, "RPDTAB stream received...");
+#endif
+        pthread_cond_signal(&(mydesc->watchdogThr.condVar));
+        pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+        break;
+
       case lmonp_resourcehandle_avail:
         //
         // The event indicating the resourcehandle is available.
@@ -2633,6 +3098,24 @@ static void *LMON_fetofe_watchdog_thread(void *arg) {
         pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
         break;
 
+      case lmonp_stats:
+        //
+        // The reply to LMON_fe_getEngineStats
+        //
+        pthread_mutex_lock(&(mydesc->watchdogThr.eventMutex));
+        if (LMON_handle_stats_event(readingFd, mydesc, &msg) != 0) {
+          LMON_say_msg(LMON_FE_MSG_PREFIX, true,
+                       "LMON_handle_stats_event failed");
+          pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+          goto watchdog_done;
+        }
+#if VERBOSE
+        LMON_say_msg(LMON_FE_MSG_PREFIX, false, "stats event received...");
+#endif
+        pthread_cond_signal(&(mydesc->watchdogThr.condVar));
+        pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+        break;
+
       case lmonp_detach_done:
         //
         // Synchronous detach event
@@ -3701,6 +4184,88 @@ lmon_rc_e LMON_fe_recvUsrDataMw(int sessionHandle, void *mwfe_data) {
   return rc;
 }
 
+//! lmon_rc_e LMON_fe_getEngineStats
+/*!
+
+    Please refer to the manpage
+
+*/
+extern "C" lmon_rc_e LMON_fe_getEngineStats(int sessionHandle,
+                                            lmon_engine_stats_t *stats) {
+  lmonp_t msg;
+  lmon_session_desc_t *mydesc;
+  unsigned int seq;
+  int numbytes;
+  int rc;
+  struct timespec ts;
+  char *tout = NULL;
+  lmon_rc_e lrc = LMON_OK;
+
+  if ((sessionHandle < 0) || (sessionHandle > MAX_LMON_SESSION) ||
+      (stats == NULL)) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true, "session or argument is invalid");
+
+    return LMON_EBDARG;
+  }
+
+  mydesc = &sess.sessionDescArray[sessionHandle];
+  pthread_mutex_lock(&(mydesc->watchdogThr.eventMutex));
+  if ((mydesc->registered == LMON_FALSE) ||
+      (mydesc->commDesc[fe_engine_conn].sessionAcceptSockFd < 0) ||
+      (mydesc->detached == LMON_TRUE) || (mydesc->killed == LMON_TRUE)) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, false,
+                 "the given session is invalid, the engine not running?");
+
+    pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+    return LMON_EBDARG;
+  }
+
+  init_msg_header(&msg);
+  msg.msgclass = lmonp_fetofe;
+  msg.type.fetofe_type = lmonp_stats_req;
+  seq = mydesc->engine_stats_seq;
+
+  numbytes = write_lmonp_long_msg(
+      mydesc->commDesc[fe_engine_conn].sessionAcceptSockFd, &msg, sizeof(msg));
+
+  if (numbytes != sizeof(msg)) {
+    pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+    return LMON_EINVAL;
+  }
+
+  tout = getenv("LMON_FE_DMONCTL_TIMEOUT");
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  if (tout && ((atoi(tout) > 0) && (atoi(tout) <= MAX_TIMEOUT)))
+    ts.tv_sec += atoi(tout);
+  else
+    ts.tv_sec += DFLT_FE_ENGINE_TOUT;
+
+  while (mydesc->engine_stats_seq == seq) {
+    /*
+     * This must be signaled by "lmonp_stats" event
+     */
+    rc = pthread_cond_timedwait(&(mydesc->watchdogThr.condVar),
+                                &(mydesc->watchdogThr.eventMutex), &ts);
+
+    if (mydesc->engine_stats_seq != seq) break;
+
+    if (rc == ETIMEDOUT) {
+      lrc = LMON_ETOUT;
+      break;
+    } else if (rc != 0) {
+      lrc = LMON_EINVAL;
+      break;
+    }
+  }
+
+  if (lrc == LMON_OK) memcpy(stats, mydesc->engine_stats, sizeof(*stats));
+
+  pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+
+  return lrc;
+}
+
 //! lmon_rc_e LMON_fe_detach
 /*!
 
@@ -3950,53 +4515,64 @@ lmon_rc_e LMON_fe_shutdownDaemons(int sessionHandle) {
   return lrc;
 }
 
-//! lmon_rc_e LMON_fe_getProctableSize
+//! lmon_rc_e LMON_lock_proctab_sess
 /*!
-
-    Please refer to the manpage
-
+  validates sessionHandle and returns its descriptor via mydesc
+  with the session's eventMutex held on LMON_OK. The proctable
+  indices are valid once it returns LMON_OK.
 */
-extern "C" lmon_rc_e LMON_fe_getProctableSize(int sessionHandle,
-                                              unsigned int *size) {
-  lmon_session_desc_t *mydesc;
-
+static lmon_rc_e LMON_lock_proctab_sess(int sessionHandle,
+                                        lmon_session_desc_t **mydesc) {
   if ((sessionHandle < 0) || (sessionHandle > MAX_LMON_SESSION)) {
     LMON_say_msg(LMON_FE_MSG_PREFIX, true, "an argument is invalid");
 
     return LMON_EBDARG;
   }
 
-  mydesc = &(sess.sessionDescArray[(sessionHandle)]);
-  pthread_mutex_lock(&(mydesc->watchdogThr.eventMutex));
-  if (mydesc->registered == LMON_FALSE) {
+  (*mydesc) = &(sess.sessionDescArray[(sessionHandle)]);
+  pthread_mutex_lock(&((*mydesc)->watchdogThr.eventMutex));
+  if ((*mydesc)->registered == LMON_FALSE) {
     LMON_say_msg(LMON_FE_MSG_PREFIX, true,
                  "session is invalid, the job killed?");
 
-    pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+    pthread_mutex_unlock(&((*mydesc)->watchdogThr.eventMutex));
     return LMON_EBDARG;
   }
 
-  if (mydesc->spawned == LMON_FALSE) {
+  if ((*mydesc)->spawned == LMON_FALSE) {
     LMON_say_msg(LMON_FE_MSG_PREFIX, true,
                  "has this session already finished?");
 
-    pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+    pthread_mutex_unlock(&((*mydesc)->watchdogThr.eventMutex));
     return LMON_EDUNAV;
   }
 
-  if (!(mydesc->proctab_msg)) {
+  if (!((*mydesc)->proctab_msg)) {
     LMON_say_msg(LMON_FE_MSG_PREFIX, true,
                  "per-session proctab_msg is null!  ");
 
-    pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+    pthread_mutex_unlock(&((*mydesc)->watchdogThr.eventMutex));
     return LMON_EDUNAV;
   }
 
-  if (mydesc->proctab_msg->sec_or_jobsizeinfo.num_tasks < LMON_NTASKS_THRE) {
-    (*size) = (unsigned int)(mydesc->proctab_msg->sec_or_jobsizeinfo.num_tasks);
-  } else {
-    (*size) = (unsigned int)(mydesc->proctab_msg->long_num_tasks);
-  }
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_fe_getProctableSize
+/*!
+
+    Please refer to the manpage
+
+*/
+extern "C" lmon_rc_e LMON_fe_getProctableSize(int sessionHandle,
+                                              unsigned int *size) {
+  lmon_session_desc_t *mydesc;
+  lmon_rc_e lrc;
+
+  if ((lrc = LMON_lock_proctab_sess(sessionHandle, &mydesc)) != LMON_OK)
+    return lrc;
+
+  (*size) = (unsigned int)(mydesc->proctab_view.num_tasks);
   pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
 
   return LMON_OK;
@@ -4013,97 +4589,190 @@ extern "C" lmon_rc_e LMON_fe_getProctable(int sessionHandle,
                                           unsigned int *size,
                                           unsigned int maxlen) {
   unsigned int i;
-  char *traverse;
-  char *strtab_offset;
+  const unsigned int *traverse;
+  const char *strtab;
+  lmon_session_desc_t *mydesc;
+  lmon_rc_e lrc;
 
+  if (!(proctable)) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true, "proctable is null ! ");
+
+    return LMON_EDUNAV;
+  }
+
+  if ((lrc = LMON_lock_proctab_sess(sessionHandle, &mydesc)) != LMON_OK)
+    return lrc;
+
+  //
+  // entries are returned in the order the engine sent them. The
+  // copy-out holds eventMutex so that a concurrent session teardown
+  // cannot free the entries and the string table underneath it.
+  //
+  (*size) = (unsigned int)(mydesc->proctab_view.num_tasks);
+  traverse = mydesc->proctab_view.entries;
+  strtab = mydesc->proctab_view.strtab;
+  for (i = 0; (i < (*size)) && i < maxlen; i++) {
+    proctable[i].pd.host_name = strdup(strtab + traverse[0]);
+    proctable[i].pd.executable_name = strdup(strtab + traverse[1]);
+    proctable[i].pd.pid = (int)traverse[2];
+    proctable[i].mpirank = (int)traverse[3];
+    proctable[i].cnodeid = (int)traverse[4];
+    traverse += N_Fields_MPIR_PROCDESC_EXT;
+  }
+  pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+
+  if ((i == maxlen) && maxlen < (*size)) return LMON_ETRUNC;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_fe_getProctableView
+/*!
+
+    Please refer to the manpage
+
+*/
+extern "C" lmon_rc_e LMON_fe_getProctableView(int sessionHandle,
+                                              lmon_proctab_view_t *view) {
   lmon_session_desc_t *mydesc;
+  lmon_rc_e lrc;
 
-  if ((sessionHandle < 0) || (sessionHandle > MAX_LMON_SESSION) ||
-      (maxlen < 0)) {
+  if (view == NULL) {
     LMON_say_msg(LMON_FE_MSG_PREFIX, true, "an argument is invalid");
 
     return LMON_EBDARG;
   }
 
-  mydesc = &(sess.sessionDescArray[(sessionHandle)]);
-  pthread_mutex_lock(&(mydesc->watchdogThr.eventMutex));
-  if (mydesc->registered == LMON_FALSE) {
-    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
-                 "session is invalid, the job killed?");
+  if ((lrc = LMON_lock_proctab_sess(sessionHandle, &mydesc)) != LMON_OK)
+    return lrc;
+
+  (*view) = mydesc->proctab_view;
+  pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_fe_getProctablePage
+/*!
+
+    Please refer to the manpage
+
+*/
+extern "C" lmon_rc_e LMON_fe_getProctablePage(int sessionHandle,
+                                              unsigned int offset,
+                                              unsigned int count,
+                                              lmon_proctab_view_t *page) {
+  lmon_session_desc_t *mydesc;
+  lmon_rc_e lrc;
+  unsigned int ntasks;
+
+  if (page == NULL) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true, "an argument is invalid");
 
-    pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
     return LMON_EBDARG;
   }
 
-  if (mydesc->spawned == LMON_FALSE) {
-    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
-                 "has this session already finished?");
+  if ((lrc = LMON_lock_proctab_sess(sessionHandle, &mydesc)) != LMON_OK)
+    return lrc;
+
+  ntasks = (unsigned int)(mydesc->proctab_view.num_tasks);
+  if (offset > ntasks) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true, "offset is beyond the proctable");
 
     pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
-    return LMON_EDUNAV;
+    return LMON_EBDARG;
   }
 
-  if (!(mydesc->proctab_msg)) {
-    LMON_say_msg(LMON_FE_MSG_PREFIX, true,
-                 "per-session proctab_msg is null!  ");
+  (*page) = mydesc->proctab_view;
+  page->num_tasks = (int)std::min(count, ntasks - offset);
+  page->num_hosts = 0;
+  page->my_host = LMON_INIT;
+  page->hosts = NULL;
+  if (page->order) page->order += offset;
+  pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
 
-    pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
-    return LMON_EDUNAV;
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_fe_getProctableByHost
+/*!
+
+    Please refer to the manpage
+
+*/
+extern "C" lmon_rc_e LMON_fe_getProctableByHost(int sessionHandle,
+                                                const char *hostname,
+                                                lmon_proctab_view_t *view) {
+  lmon_session_desc_t *mydesc;
+  lmon_rc_e lrc;
+  int lo, hi;
+
+  if (hostname == NULL || view == NULL) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true, "an argument is invalid");
+
+    return LMON_EBDARG;
   }
 
-  if (!(proctable)) {
-    LMON_say_msg(LMON_FE_MSG_PREFIX, true, "proctable is null ! ");
+  if ((lrc = LMON_lock_proctab_sess(sessionHandle, &mydesc)) != LMON_OK)
+    return lrc;
 
-    pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
-    return LMON_EDUNAV;
+  //
+  // binary search over the hosts in lexicographical order
+  //
+  const std::vector<int> &sorted = mydesc->proctab_hosts_sorted;
+  lo = 0;
+  hi = (int)sorted.size();
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (strcmp(mydesc->proctab_hosts[sorted[mid]].host_name, hostname) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
   }
 
-  traverse = get_lmonpayload_begin((mydesc->proctab_msg));
-  if (!traverse) {
+  if (lo == (int)sorted.size() ||
+      strcmp(mydesc->proctab_hosts[sorted[lo]].host_name, hostname) != 0) {
+    pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
     return LMON_EDUNAV;
   }
-  if (mydesc->proctab_msg->sec_or_jobsizeinfo.num_tasks < LMON_NTASKS_THRE) {
-    (*size) = (unsigned int)(mydesc->proctab_msg->sec_or_jobsizeinfo.num_tasks);
-  } else {
-    (*size) = (unsigned int)(mydesc->proctab_msg->long_num_tasks);
-  }
 
-  strtab_offset = get_strtab_begin(mydesc->proctab_msg);
+  (*view) = mydesc->proctab_view;
+  view->my_host = sorted[lo];
+  pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
 
-  for (i = 0; (i < (*size)) && i < maxlen; i++) {
-    //
-    // fetch a host_name
-    // possible error check what  ( strtab_offset + ( *((unsigned
-    // int*)traverse)) ) contains
-    proctable[i].pd.host_name =
-        strdup(strtab_offset + (*((unsigned int *)traverse)));
-    traverse += sizeof(unsigned int);
+  return LMON_OK;
+}
 
-    //
-    // fetch a exectuable_name
-    //
-    proctable[i].pd.executable_name =
-        strdup(strtab_offset + (*((unsigned int *)traverse)));
-    traverse += sizeof(unsigned int);
+//! lmon_rc_e LMON_fe_getProctableByRank
+/*!
 
-    //
-    // fetch a pid
-    //
-    memcpy(&(proctable[i].pd.pid), (void *)traverse, sizeof(int));
-    traverse += sizeof(int);
+    Please refer to the manpage
 
-    //
-    // fetch a mpirank
-    //
-    memcpy(&(proctable[i].mpirank), (void *)traverse, sizeof(int));
-    traverse += sizeof(int);
+*/
+extern "C" lmon_rc_e LMON_fe_getProctableByRank(int sessionHandle, int rank,
+                                                lmon_proctab_view_t *view,
+                                                int *index) {
+  lmon_session_desc_t *mydesc;
+  lmon_rc_e lrc;
 
-    memcpy(&(proctable[i].cnodeid), (void *)traverse, sizeof(int));
-    traverse += sizeof(int);
+  if (view == NULL || index == NULL) {
+    LMON_say_msg(LMON_FE_MSG_PREFIX, true, "an argument is invalid");
+
+    return LMON_EBDARG;
   }
-  pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
 
-  if ((i == maxlen) && maxlen < (*size)) return LMON_ETRUNC;
+  if ((lrc = LMON_lock_proctab_sess(sessionHandle, &mydesc)) != LMON_OK)
+    return lrc;
+
+  if (rank < 0 || rank >= (int)mydesc->proctab_rank_pos.size() ||
+      mydesc->proctab_rank_pos[rank] == LMON_INIT) {
+    pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
+    return LMON_EDUNAV;
+  }
+
+  (*view) = mydesc->proctab_view;
+  (*index) = mydesc->proctab_rank_pos[rank];
+  pthread_mutex_unlock(&(mydesc->watchdogThr.eventMutex));
 
   return LMON_OK;
 }
@@ -4467,6 +5136,14 @@ extern "C" lmon_rc_e LMON_fe_launchAndSpawnDaemons(
     lmonOptArgs.push_back(opt.get_my_opt()->lmon_sec_info);
     lmonOptArgs.push_back("--daemonpath");
     lmonOptArgs.push_back(opt.get_my_opt()->tool_daemon);
+    lmonOptArgs.push_back("--rpdtabenc");
+    lmonOptArgs.push_back(opt.get_my_opt()->rpdtab_enc);
+    lmonOptArgs.push_back("--rpdtabchunk");
+    {
+      stringstream ss;
+      ss << opt.get_my_opt()->rpdtab_chunk;
+      lmonOptArgs.push_back(ss.str());
+    }
 
     const list<string> &tool_daemon_opts = opt.get_my_opt()->tool_daemon_opts;
     if (!tool_daemon_opts.empty()) {
@@ -4653,6 +5330,14 @@ extern "C" lmon_rc_e LMON_fe_attachAndSpawnDaemons(
     lmonOptArgs.push_back(opt.get_my_opt()->lmon_sec_info);
     lmonOptArgs.push_back("--daemonpath");
     lmonOptArgs.push_back(opt.get_my_opt()->tool_daemon);
+    lmonOptArgs.push_back("--rpdtabenc");
+    lmonOptArgs.push_back(opt.get_my_opt()->rpdtab_enc);
+    lmonOptArgs.push_back("--rpdtabchunk");
+    {
+      stringstream ss;
+      ss << opt.get_my_opt()->rpdtab_chunk;
+      lmonOptArgs.push_back(ss.str());
+    }
 
     const list<string> &tool_daemon_opts = opt.get_my_opt()->tool_daemon_opts;
     if (!tool_daemon_opts.empty()) {
@@ -4734,11 +5419,11 @@ extern "C" lmon_rc_e LMON_fe_launchMwDaemons(int sessionHandle,
       if ((req[i].ndaemon == -1) && (req[i].block == -1) &&
           (req[i].cyclic == -1)) {
         std::vector<std::string> hostvect;
-        std::map<std::string, std::vector<MPIR_PROCDESC_EXT *>,
-                 lexGraphCmp>::const_iterator miter;
-        for (miter = mydesc->pMap.begin(); miter != mydesc->pMap.end();
-             miter++) {
-          hostvect.push_back(miter->first);
+        std::vector<int>::const_iterator hiter;
+        for (hiter = mydesc->proctab_hosts_sorted.begin();
+             hiter != mydesc->proctab_hosts_sorted.end(); hiter++) {
+          hostvect.push_back(
+              std::string(mydesc->proctab_hosts[(*hiter)].host_name));
         }
         spawner_base_t *colocSpawner = new spawner_coloc_t(
             mydesc->commDesc[fe_be_conn].sessionAcceptSockFd,
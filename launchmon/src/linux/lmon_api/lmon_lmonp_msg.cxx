@@ -58,6 +58,7 @@
 #include <unistd.h>
 #include <cassert>
 #include <cstdio>
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <map>
@@ -67,6 +68,10 @@
 #include <lmon_api/lmon_lmonp_msg.h>
 #include <lmon_api/lmon_proctab.h>
 
+#if HAVE_LZ4
+#include <lz4.h>
+#endif
+
 #define LMONP_MSG_OP "[LMONP MSG]"
 
 ////////////////////////////////////////////////////////////////////
@@ -105,6 +110,11 @@ static const char *lmonp_fe_to_fe_str[] = {"lmonp_conn_ack_no_error",
                                            "lmonp_kill",
                                            "lmonp_shutdownbe",
                                            "lmonp_cont_launch_bp",
+                                           "lmonp_stats_req",
+                                           "lmonp_stats",
+                                           "lmonp_proctable_begin",
+                                           "lmonp_proctable_chunk",
+                                           "lmonp_proctable_end",
                                            "lmonp_invalid"};
 
 static const char *lmonp_fe_to_be_str[] = {"lmonp_febe_security_chk",
@@ -584,6 +594,422 @@ extern "C" int set_msg_header(lmonp_t *msg, lmonp_msg_class_e mc, int type,
   return 0;
 }
 
+////////////////////////////////////////////////////////////////////
+//
+// Compact RPDTAB encoding
+//
+//
+
+static void put_varint(std::string &out, uint32_t v) {
+  while (v >= 0x80) {
+    out += (char)((v & 0x7f) | 0x80);
+    v >>= 7;
+  }
+  out += (char)v;
+}
+
+static bool get_varint(const unsigned char **p, const unsigned char *end,
+                       uint32_t *v) {
+  uint32_t r = 0;
+  int shift;
+
+  for (shift = 0; shift < 35 && *p < end; shift += 7) {
+    unsigned char c = *((*p)++);
+    r |= (uint32_t)(c & 0x7f) << shift;
+    if (!(c & 0x80)) {
+      *v = r;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void put_delta(std::string &out, uint32_t cur, uint32_t prev) {
+  int32_t d = (int32_t)(cur - prev);
+  put_varint(out, ((uint32_t)d << 1) ^ (uint32_t)(d >> 31));
+}
+
+static bool get_delta(const unsigned char **p, const unsigned char *end,
+                      uint32_t prev, uint32_t *cur) {
+  uint32_t z;
+  if (!get_varint(p, end, &z)) return false;
+  *cur = prev + ((z >> 1) ^ (uint32_t)(-(int32_t)(z & 1)));
+  return true;
+}
+
+static void put_runs(std::string &out, const std::vector<uint32_t> &col) {
+  std::string runs;
+  uint32_t nruns = 0;
+  size_t i = 0;
+
+  while (i < col.size()) {
+    size_t j = i + 1;
+    while (j < col.size() && col[j] == col[i]) j++;
+    put_varint(runs, col[i]);
+    put_varint(runs, (uint32_t)(j - i));
+    nruns++;
+    i = j;
+  }
+  put_varint(out, nruns);
+  out += runs;
+}
+
+static bool get_runs(const unsigned char **p, const unsigned char *end,
+                     uint32_t ntasks, uint32_t nvals,
+                     std::vector<uint32_t> &col) {
+  uint32_t nruns, r, val, len;
+
+  col.clear();
+  col.reserve(ntasks);
+  if (!get_varint(p, end, &nruns)) return false;
+  for (r = 0; r < nruns; r++) {
+    if (!get_varint(p, end, &val) || !get_varint(p, end, &len)) return false;
+    if (val >= nvals || len > ntasks - col.size()) return false;
+    col.insert(col.end(), len, val);
+  }
+
+  return col.size() == ntasks;
+}
+
+struct strtab_less {
+  const char *strtab;
+  strtab_less(const char *s) : strtab(s) {}
+  bool operator()(uint32_t a, uint32_t b) const {
+    return strcmp(strtab + a, strtab + b) < 0;
+  }
+};
+
+//! lmon_rpdtab_enc_e str_to_rpdtab_enc
+/*!
+    maps an --rpdtabenc argument to an encoding
+*/
+lmon_rpdtab_enc_e str_to_rpdtab_enc(const char *enc) {
+  if (!enc) return lmon_rpdtab_legacy;
+
+  if (strcmp(enc, "compact") == 0) return lmon_rpdtab_compact;
+
+  if (strcmp(enc, "lz4") == 0) return lmon_rpdtab_compact_lz4;
+
+  return lmon_rpdtab_legacy;
+}
+
+//! unsigned int RPDTAB_msg_ntasks
+/*!
+    returns the number of tasks in a proctable message
+*/
+unsigned int RPDTAB_msg_ntasks(lmonp_t *msg) {
+  if (msg->sec_or_jobsizeinfo.num_tasks < LMON_NTASKS_THRE)
+    return msg->sec_or_jobsizeinfo.num_tasks;
+
+  return msg->long_num_tasks;
+}
+
+//! int is_compact_RPDTAB_msg
+/*!
+    1 if msg carries a proctable in the compact format, 0 otherwise
+*/
+int is_compact_RPDTAB_msg(lmonp_t *msg) {
+  char *payload;
+
+  if (!msg) return 0;
+
+  if (!((msg->msgclass == lmonp_fetofe &&
+         msg->type.fetofe_type == lmonp_proctable_avail) ||
+        (msg->msgclass == lmonp_fetobe &&
+         msg->type.fetobe_type == lmonp_febe_proctab)))
+    return 0;
+
+  if (msg->lmon_payload_length < sizeof(lmonp_rpdtab_cmpt_t)) return 0;
+
+  payload = get_lmonpayload_begin(msg);
+
+  return ((lmonp_rpdtab_cmpt_t *)payload)->magic == LMON_RPDTAB_CMPT_MAGIC;
+}
+
+//! lmonp_t *compact_RPDTAB_msg
+/*!
+    re-encodes a legacy proctable message. Executables keep the
+    order of the legacy string table; hostnames are sorted so that
+    front coding can share their prefixes.
+*/
+lmonp_t *compact_RPDTAB_msg(lmonp_t *msg, lmon_rpdtab_enc_e enc,
+                            int *msglen) {
+  using namespace std;
+
+  char *entries;
+  char *strtab;
+  unsigned int ntasks, i;
+  uint32_t strtab_len;
+  uint32_t flags = 0;
+
+  if (!msg || enc == lmon_rpdtab_legacy || is_compact_RPDTAB_msg(msg))
+    return NULL;
+
+  if (!(entries = get_lmonpayload_begin(msg)) ||
+      !(strtab = get_strtab_begin(msg)))
+    return NULL;
+
+  ntasks = RPDTAB_msg_ntasks(msg);
+  strtab_len = msg->lmon_payload_length - (uint32_t)(strtab - entries);
+
+  //
+  // collecting distinct strings by their legacy string table offsets
+  //
+  map<uint32_t, uint32_t> exec_ix;
+  map<uint32_t, uint32_t> host_ix;
+  vector<uint32_t> execs;
+  vector<uint32_t> hosts;
+  vector<uint32_t> exec_col(ntasks);
+  vector<uint32_t> host_col(ntasks);
+  const uint32_t *ent = (const uint32_t *)entries;
+
+  for (i = 0; i < ntasks; i++, ent += N_Fields_MPIR_PROCDESC_EXT) {
+    if (ent[0] >= strtab_len || ent[1] >= strtab_len) return NULL;
+
+    if (exec_ix.find(ent[1]) == exec_ix.end()) {
+      exec_ix[ent[1]] = (uint32_t)execs.size();
+      execs.push_back(ent[1]);
+    }
+    if (host_ix.find(ent[0]) == host_ix.end()) {
+      host_ix[ent[0]] = 0;
+      hosts.push_back(ent[0]);
+    }
+  }
+
+  sort(hosts.begin(), hosts.end(), strtab_less(strtab));
+  for (i = 0; i < hosts.size(); i++) host_ix[hosts[i]] = i;
+
+  ent = (const uint32_t *)entries;
+  for (i = 0; i < ntasks; i++, ent += N_Fields_MPIR_PROCDESC_EXT) {
+    exec_col[i] = exec_ix[ent[1]];
+    host_col[i] = host_ix[ent[0]];
+  }
+
+  if (execs.size() == 1) flags |= LMON_RPDTAB_SINGLE_EXEC;
+
+  //
+  // building the body
+  //
+  string body;
+  body.reserve(ntasks * 4 + strtab_len);
+  put_varint(body, (uint32_t)execs.size());
+  put_varint(body, (uint32_t)hosts.size());
+
+  for (i = 0; i < execs.size(); i++) {
+    body.append(strtab + execs[i], strlen(strtab + execs[i]) + 1);
+  }
+
+  const char *prev = "";
+  for (i = 0; i < hosts.size(); i++) {
+    const char *cur = strtab + hosts[i];
+    uint32_t shared = 0;
+    while (prev[shared] && prev[shared] == cur[shared]) shared++;
+    put_varint(body, shared);
+    body.append(cur + shared, strlen(cur + shared) + 1);
+    prev = cur;
+  }
+
+  if (!(flags & LMON_RPDTAB_SINGLE_EXEC)) put_runs(body, exec_col);
+  put_runs(body, host_col);
+
+  uint32_t prev_pid = 0, prev_rank = (uint32_t)-1, prev_cn = 0;
+  ent = (const uint32_t *)entries;
+  for (i = 0; i < ntasks; i++, ent += N_Fields_MPIR_PROCDESC_EXT) {
+    put_delta(body, ent[2], prev_pid);
+    prev_pid = ent[2];
+  }
+  ent = (const uint32_t *)entries;
+  for (i = 0; i < ntasks; i++, ent += N_Fields_MPIR_PROCDESC_EXT) {
+    put_delta(body, ent[3], prev_rank + 1);
+    prev_rank = ent[3];
+  }
+  ent = (const uint32_t *)entries;
+  for (i = 0; i < ntasks; i++, ent += N_Fields_MPIR_PROCDESC_EXT) {
+    put_delta(body, ent[4], prev_cn);
+    prev_cn = ent[4];
+  }
+
+  //
+  // optionally compressing it
+  //
+  const char *wire = body.data();
+  uint32_t wire_length = (uint32_t)body.size();
+#if HAVE_LZ4
+  vector<char> zbuf;
+  if (enc == lmon_rpdtab_compact_lz4 && body.size() > 0) {
+    zbuf.resize(LZ4_compressBound((int)body.size()));
+    int zlen = LZ4_compress_default(body.data(), &zbuf[0], (int)body.size(),
+                                    (int)zbuf.size());
+    if (zlen > 0 && (uint32_t)zlen < body.size()) {
+      wire = &zbuf[0];
+      wire_length = (uint32_t)zlen;
+      flags |= LMON_RPDTAB_LZ4;
+    }
+  }
+#endif
+
+  int len = sizeof(lmonp_t) + sizeof(lmonp_rpdtab_cmpt_t) + wire_length +
+            msg->usr_payload_length;
+  lmonp_t *cmsg = (lmonp_t *)malloc(len);
+  if (!cmsg) return NULL;
+
+  memcpy(cmsg, msg, sizeof(lmonp_t));
+  cmsg->lmon_payload_length = sizeof(lmonp_rpdtab_cmpt_t) + wire_length;
+
+  lmonp_rpdtab_cmpt_t *ch = (lmonp_rpdtab_cmpt_t *)get_lmonpayload_begin(cmsg);
+  ch->magic = LMON_RPDTAB_CMPT_MAGIC;
+  ch->flags = flags;
+  ch->body_length = (uint32_t)body.size();
+  ch->wire_length = wire_length;
+  memcpy((char *)(ch + 1), wire, wire_length);
+
+  if (msg->usr_payload_length) {
+    memcpy(get_usrpayload_begin(cmsg), get_usrpayload_begin(msg),
+           msg->usr_payload_length);
+  }
+
+  *msglen = len;
+
+  return cmsg;
+}
+
+//! char *get_RPDTAB_entries
+/*!
+    returns the legacy per-task entries of a proctable message.
+    Compact messages are inflated and decoded into a freshly
+    allocated legacy payload: the entries followed by the string
+    table holding the executables and then the hostnames.
+*/
+char *get_RPDTAB_entries(lmonp_t *msg, char **strtab, char **tofree) {
+  using namespace std;
+
+  *tofree = NULL;
+  *strtab = NULL;
+
+  if (!is_compact_RPDTAB_msg(msg)) {
+    *strtab = get_strtab_begin(msg);
+    return get_lmonpayload_begin(msg);
+  }
+
+  lmonp_rpdtab_cmpt_t *ch = (lmonp_rpdtab_cmpt_t *)get_lmonpayload_begin(msg);
+  const unsigned char *body = (const unsigned char *)(ch + 1);
+  vector<unsigned char> zbody;
+
+  if (ch->wire_length > msg->lmon_payload_length - sizeof(*ch)) return NULL;
+
+  if (ch->flags & LMON_RPDTAB_LZ4) {
+#if HAVE_LZ4
+    zbody.resize(ch->body_length + 1);
+    if (LZ4_decompress_safe((const char *)body, (char *)&zbody[0],
+                            (int)ch->wire_length,
+                            (int)ch->body_length) != (int)ch->body_length)
+      return NULL;
+    body = &zbody[0];
+#else
+    //
+    // LZ4 support is not built in
+    //
+    return NULL;
+#endif
+  } else if (ch->body_length != ch->wire_length) {
+    return NULL;
+  }
+
+  const unsigned char *p = body;
+  const unsigned char *end = body + ch->body_length;
+  unsigned int ntasks = RPDTAB_msg_ntasks(msg);
+  uint32_t nexec, nhost, i;
+
+  if (!get_varint(&p, end, &nexec) || !get_varint(&p, end, &nhost) ||
+      nexec == 0 || nhost == 0)
+    return NULL;
+
+  //
+  // strings: executables verbatim, hostnames front-decoded
+  //
+  string strs;
+  vector<uint32_t> exec_off(nexec);
+  vector<uint32_t> host_off(nhost);
+
+  for (i = 0; i < nexec; i++) {
+    const unsigned char *nul =
+        (const unsigned char *)memchr(p, '\0', end - p);
+    if (!nul) return NULL;
+    exec_off[i] = (uint32_t)strs.size();
+    strs.append((const char *)p, nul - p + 1);
+    p = nul + 1;
+  }
+
+  uint32_t prev_off = 0, prev_len = 0;
+  for (i = 0; i < nhost; i++) {
+    uint32_t shared;
+    if (!get_varint(&p, end, &shared) || shared > prev_len) return NULL;
+    const unsigned char *nul =
+        (const unsigned char *)memchr(p, '\0', end - p);
+    if (!nul) return NULL;
+
+    host_off[i] = (uint32_t)strs.size();
+    string prefix = strs.substr(prev_off, shared);
+    strs += prefix;
+    strs.append((const char *)p, nul - p + 1);
+    prev_off = host_off[i];
+    prev_len = shared + (uint32_t)(nul - p);
+    p = nul + 1;
+  }
+
+  //
+  // columns
+  //
+  vector<uint32_t> exec_col;
+  vector<uint32_t> host_col;
+
+  if (ch->flags & LMON_RPDTAB_SINGLE_EXEC) {
+    exec_col.assign(ntasks, 0);
+  } else if (!get_runs(&p, end, ntasks, nexec, exec_col)) {
+    return NULL;
+  }
+
+  if (!get_runs(&p, end, ntasks, nhost, host_col)) return NULL;
+
+  size_t entlen = ntasks * N_Fields_MPIR_PROCDESC_EXT * sizeof(uint32_t);
+  char *legacy = (char *)malloc(entlen + strs.size());
+  if (!legacy) return NULL;
+
+  uint32_t *ent = (uint32_t *)legacy;
+  uint32_t prev = 0;
+  for (i = 0; i < ntasks; i++, ent += N_Fields_MPIR_PROCDESC_EXT) {
+    ent[0] = host_off[host_col[i]];
+    ent[1] = exec_off[exec_col[i]];
+    if (!get_delta(&p, end, prev, &ent[2])) goto decode_error;
+    prev = ent[2];
+  }
+
+  ent = (uint32_t *)legacy;
+  prev = (uint32_t)-1;
+  for (i = 0; i < ntasks; i++, ent += N_Fields_MPIR_PROCDESC_EXT) {
+    if (!get_delta(&p, end, prev + 1, &ent[3])) goto decode_error;
+    prev = ent[3];
+  }
+
+  ent = (uint32_t *)legacy;
+  prev = 0;
+  for (i = 0; i < ntasks; i++, ent += N_Fields_MPIR_PROCDESC_EXT) {
+    if (!get_delta(&p, end, prev, &ent[4])) goto decode_error;
+    prev = ent[4];
+  }
+
+  memcpy(legacy + entlen, strs.data(), strs.size());
+  *strtab = legacy + entlen;
+  *tofree = legacy;
+
+  return legacy;
+
+decode_error:
+  free(legacy);
+  return NULL;
+}
+
 char *get_lmonpayload_begin(lmonp_t *msg) {
   char *ret = (char *)msg;
   if (!msg) return NULL;
@@ -608,6 +1034,25 @@ char *get_usrpayload_begin(lmonp_t *msg) {
 
 char *get_strtab_begin(lmonp_t *msg) {
   char *ret = NULL;
+
+  if (is_compact_RPDTAB_msg(msg)) {
+    //
+    // The compact format keeps its strings right after the two
+    // counts at the beginning of the body. There is no string table
+    // to point to until an LZ4 body is inflated.
+    //
+    lmonp_rpdtab_cmpt_t *ch = (lmonp_rpdtab_cmpt_t *)get_lmonpayload_begin(msg);
+    const unsigned char *p = (const unsigned char *)(ch + 1);
+    const unsigned char *end = p + ch->wire_length;
+    uint32_t v;
+
+    if ((ch->flags & LMON_RPDTAB_LZ4) || !get_varint(&p, end, &v) ||
+        !get_varint(&p, end, &v))
+      return NULL;
+
+    return (char *)p;
+  }
+
   switch (msg->msgclass) {
     case lmonp_fetofe: {
       if (msg->type.fetofe_type == lmonp_proctable_avail)
@@ -677,6 +1122,7 @@ int parse_raw_RPDTAB_msg(lmonp_t *proctabMsg, void *pMap) {
 
   char *mpirent;
   char *strtab;
+  char *tofree = NULL;
   int i;
   unsigned int ntasks;
 
@@ -688,16 +1134,12 @@ int parse_raw_RPDTAB_msg(lmonp_t *proctabMsg, void *pMap) {
 
   if ((*pTab).size() != 0 || proctabMsg == NULL) return -1;
 
-  mpirent = get_lmonpayload_begin(proctabMsg);
-  if (!mpirent) return -2;
+  if (!get_lmonpayload_begin(proctabMsg)) return -2;
 
-  strtab = get_strtab_begin(proctabMsg);
-  if (!strtab) return -3;
+  mpirent = get_RPDTAB_entries(proctabMsg, &strtab, &tofree);
+  if (!mpirent || !strtab) return -3;
 
-  if (proctabMsg->sec_or_jobsizeinfo.num_tasks < LMON_NTASKS_THRE)
-    ntasks = proctabMsg->sec_or_jobsizeinfo.num_tasks;
-  else
-    ntasks = proctabMsg->long_num_tasks;
+  ntasks = RPDTAB_msg_ntasks(proctabMsg);
 
   for (i = 0; i < ntasks; i++) {
     unsigned int *hn_ix_ptr = (unsigned int *)mpirent;
@@ -713,7 +1155,10 @@ int parse_raw_RPDTAB_msg(lmonp_t *proctabMsg, void *pMap) {
     MPIR_PROCDESC_EXT *anentry =
         (MPIR_PROCDESC_EXT *)malloc(sizeof(MPIR_PROCDESC_EXT));
 
-    if (anentry == NULL) return -4;
+    if (anentry == NULL) {
+      if (tofree) free(tofree);
+      return -4;
+    }
 
     anentry->pd.executable_name = strdup(exeptr);
     anentry->pd.host_name = strdup(hntmpstr.c_str());
@@ -730,6 +1175,60 @@ int parse_raw_RPDTAB_msg(lmonp_t *proctabMsg, void *pMap) {
     }
   }
 
+  if (tofree) free(tofree);
+
+  return 0;
+}
+
+//
+// 0 on success
+// <0 on failure
+//
+int index_RPDTAB_entries(const char *entries, const char *strtab,
+                         unsigned int ntasks, unsigned int *order,
+                         void *hosts) {
+  using namespace std;
+
+  //
+  // This implementation assumes that hosts is C++ STD vector type
+  //
+  vector<lmon_proctab_host_t> *hvec = (vector<lmon_proctab_host_t> *)hosts;
+  const unsigned int *ent = (const unsigned int *)entries;
+  map<unsigned int, int> hostix;
+  vector<int> taskhost(ntasks);
+  unsigned int i;
+
+  if (hvec == NULL || (ntasks > 0 && (!entries || !strtab || !order)))
+    return -1;
+
+  hvec->clear();
+
+  for (i = 0; i < ntasks; ++i) {
+    unsigned int hn = ent[i * N_Fields_MPIR_PROCDESC_EXT];
+    map<unsigned int, int>::iterator iter = hostix.find(hn);
+    if (iter == hostix.end()) {
+      lmon_proctab_host_t h;
+      h.host_name = strtab + hn;
+      h.begin = 0;
+      h.end = 0;
+      iter = hostix.insert(make_pair(hn, (int)hvec->size())).first;
+      hvec->push_back(h);
+    }
+    taskhost[i] = iter->second;
+    (*hvec)[iter->second].end++;
+  }
+
+  int begin = 0;
+  vector<lmon_proctab_host_t>::iterator hiter;
+  for (hiter = hvec->begin(); hiter != hvec->end(); ++hiter) {
+    int n = hiter->end;
+    hiter->begin = begin;
+    hiter->end = begin;
+    begin += n;
+  }
+
+  for (i = 0; i < ntasks; ++i) order[(*hvec)[taskhost[i]].end++] = i;
+
   return 0;
 }
 
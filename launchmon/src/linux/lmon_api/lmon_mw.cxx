@@ -423,6 +423,73 @@ extern "C" lmon_rc_e LMON_mw_scatter(void *sendbuf, int numbyte_per_element,
   return LMON_OK;
 }
 
+//! lmon_rc_e LMON_mw_gatherv
+/*!
+
+*/
+extern "C" lmon_rc_e LMON_mw_gatherv(void *sendbuf, int numbyte,
+                                     void **recvbuf, int *recvcounts) {
+  lmon_rc_e lrc =
+      LMON_daemon_internal_gatherv(sendbuf, numbyte, recvbuf, recvcounts);
+
+  if (lrc == LMON_ENOMEM) return LMON_ENOMEM;
+
+  if (lrc != LMON_OK) return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_mw_scatterv
+/*!
+
+*/
+extern "C" lmon_rc_e LMON_mw_scatterv(void *sendbuf, int *sendcounts,
+                                      int *displs, void *recvbuf,
+                                      int recvcount) {
+  if (LMON_daemon_internal_scatterv(sendbuf, sendcounts, displs, recvbuf,
+                                    recvcount) != LMON_OK)
+    return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_mw_regReduceOp
+/*!
+
+*/
+extern "C" lmon_rc_e LMON_mw_regReduceOp(lmon_reduce_fn_t fn, int *op) {
+  if (LMON_daemon_internal_regReduceOp(fn, op) != LMON_OK) return LMON_EINVAL;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_mw_reduce
+/*!
+
+*/
+extern "C" lmon_rc_e LMON_mw_reduce(void *sendbuf, void *recvbuf, int count,
+                                    lmon_datatype_e type, int op) {
+  if (LMON_daemon_internal_reduce(sendbuf, recvbuf, count, type, op) !=
+      LMON_OK)
+    return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
+//! lmon_rc_e LMON_mw_allreduce
+/*!
+
+*/
+extern "C" lmon_rc_e LMON_mw_allreduce(void *sendbuf, void *recvbuf,
+                                       int count, lmon_datatype_e type,
+                                       int op) {
+  if (LMON_daemon_internal_allreduce(sendbuf, recvbuf, count, type, op) !=
+      LMON_OK)
+    return LMON_ESUBCOM;
+
+  return LMON_OK;
+}
+
 //! lmon_rc_e LMON_mw_broadcast
 /*!
 
@@ -503,28 +570,21 @@ extern "C" lmon_rc_e LMON_mw_handshake(void *udata) {
   //
   int i;
   char *hngatherbuf = NULL;
+  std::vector<int> hnlens;
 
   BEGIN_MASTER_ONLY(mwdata)
-
-  hngatherbuf = (char *)malloc(LMON_DAEMON_HN_MAX * mwdata.daemon_data.width);
-  if (hngatherbuf == NULL) {
-    LMON_say_msg(LMON_MW_MSG_PREFIX, true, "malloc returned zero");
-
-    return LMON_ENOMEM;
-  }
-#if VERBOSE
-  LMON_say_msg(LMON_MW_MSG_PREFIX, false,
-               "MW master: alloc buf of size %d x %d", LMON_DAEMON_HN_MAX,
-               mwdata.daemon_data.width);
-#endif
+  hnlens.resize(mwdata.daemon_data.width);
   END_MASTER_ONLY
 
   //
-  // once mw_gather is performed, hngatherbuf
-  // should hold all the hostnames
+  // once mw_gatherv is performed, hngatherbuf
+  // should hold all the hostnames back to back,
+  // each taking only its own length on the wire
   //
-  if (LMON_mw_gather(mwdata.daemon_data.my_hostname, LMON_DAEMON_HN_MAX,
-                     hngatherbuf) != LMON_OK) {
+  if (LMON_mw_gatherv(mwdata.daemon_data.my_hostname,
+                      strlen(mwdata.daemon_data.my_hostname) + 1,
+                      (void **)&hngatherbuf,
+                      hnlens.empty() ? NULL : &hnlens[0]) != LMON_OK) {
     LMON_say_msg(LMON_MW_MSG_PREFIX, true, "gather failed");
 
     return LMON_ESUBCOM;
@@ -554,7 +614,7 @@ extern "C" lmon_rc_e LMON_mw_handshake(void *udata) {
       hostName[tmpstr].push_back(0);
       offset += (strlen(hntrav) + 1);
     }
-    hntrav += LMON_DAEMON_HN_MAX;
+    hntrav += hnlens[i];
   }
 
   //
@@ -604,7 +664,7 @@ extern "C" lmon_rc_e LMON_mw_handshake(void *udata) {
       strtabptr += (strlen(hntrav) + 1);
       hostName[tmpstr][1] = 1;
     }
-    hntrav += LMON_DAEMON_HN_MAX;
+    hntrav += hnlens[i];
   }
   free(hngatherbuf);
 
@@ -0,0 +1,862 @@
+/*
+ *--------------------------------------------------------------------------------
+ * Copyright (c) 2008, Lawrence Livermore National Security, LLC. Produced at
+ * the Lawrence Livermore National Laboratory. Written by Dong H. Ahn
+ * <ahn1@llnl.gov>. LLNL-CODE-409469. All rights reserved.
+ *
+ * This file is part of LaunchMON. For details, see
+ * https://computing.llnl.gov/?set=resources&page=os_projects
+ *
+ * Please also read LICENSE.txt -- Our Notice and GNU Lesser General Public
+ * License.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the terms and conditions of the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple
+ * Place, Suite 330, Boston, MA 02111-1307 USA
+ *--------------------------------------------------------------------------------
+ */
+
+#ifndef HAVE_LAUNCHMON_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "sdbg_linux_elfsym.hxx"
+
+////////////////////////////////////////////////////////////////////
+//
+// PUBLIC INTERFACES (class elf_symbol_resolver_t)
+//
+//
+
+//! File scope elf_sym_name_less
+/*!
+    orders symbol numbers by the names they refer to
+*/
+struct elf_sym_name_less {
+  const lmon_elf_sym_t* syms;
+  const char* strtab;
+  elf_sym_name_less(const lmon_elf_sym_t* s, const char* st)
+      : syms(s), strtab(st) {}
+  bool operator()(Elf32_Word a, Elf32_Word b) const {
+    return strcmp(strtab + syms[a].st_name, strtab + syms[b].st_name) < 0;
+  }
+  bool operator()(Elf32_Word a, const char* b) const {
+    return strcmp(strtab + syms[a].st_name, b) < 0;
+  }
+  bool operator()(const char* a, Elf32_Word b) const {
+    return strcmp(a, strtab + syms[b].st_name) < 0;
+  }
+};
+
+//!  PUBLIC:
+/*!  elf_symbol_resolver_t constructor & destructor
+
+*/
+elf_symbol_resolver_t::elf_symbol_resolver_t()
+    : image(NULL),
+      image_size(0),
+      syms(NULL),
+      nsyms(0),
+      strtab(NULL),
+      strtab_size(0),
+      gnu_hash(NULL),
+      gnu_hash_words(0),
+      sysv_hash(NULL),
+      sysv_hash_words(0) {}
+
+elf_symbol_resolver_t::~elf_symbol_resolver_t() { finalize(); }
+
+//!  PUBLIC:
+/*!  elf_symbol_resolver_t::init
+
+     maps path and locates its symbol table: .symtab if present,
+     .dynsym otherwise, as well as the string table and a hash
+     section that index it.
+*/
+symtab_error_e elf_symbol_resolver_t::init(const std::string& path) throw(
+    symtab_exception_t) {
+  using namespace std;
+
+  string e;
+  string func = "[elf_symbol_resolver_t::init]";
+  const lmon_elf_ehdr_t* ehdr;
+  const lmon_elf_shdr_t* shdrs;
+  const lmon_elf_shdr_t* symsect = NULL;
+  const lmon_elf_shdr_t* dynsect = NULL;
+  struct stat sbuf;
+  size_t symndx = 0, dynndx = 0;
+  size_t i;
+  int fd;
+
+  finalize();
+
+  if ((fd = open(path.c_str(), O_RDONLY)) == -1) {
+    e = func + " couldn't open " + path;
+    throw symtab_exception_t(e, SDBG_SYMTAB_FAILED);
+  }
+
+  if (fstat(fd, &sbuf) != 0 || (size_t)sbuf.st_size < sizeof(*ehdr)) {
+    close(fd);
+    e = func + " " + path + " is not an ELF image";
+    throw symtab_exception_t(e, SDBG_SYMTAB_FAILED);
+  }
+
+  image_size = (size_t)sbuf.st_size;
+  image = (char*)mmap(NULL, image_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (image == MAP_FAILED) {
+    image = NULL;
+    e = func + " mmap failed on " + path;
+    throw symtab_exception_t(e, SDBG_SYMTAB_FAILED);
+  }
+
+  ehdr = (const lmon_elf_ehdr_t*)image;
+  if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0 ||
+#if BIT64
+      ehdr->e_ident[EI_CLASS] != ELFCLASS64 ||
+#else
+      ehdr->e_ident[EI_CLASS] != ELFCLASS32 ||
+#endif
+      ehdr->e_shentsize != sizeof(lmon_elf_shdr_t) ||
+      ehdr->e_shoff + (size_t)ehdr->e_shnum * sizeof(lmon_elf_shdr_t) >
+          image_size) {
+    finalize();
+    e = func + " " + path + " is not a valid ELF image for this engine";
+    throw symtab_exception_t(e, SDBG_SYMTAB_FAILED);
+  }
+
+  shdrs = (const lmon_elf_shdr_t*)(image + ehdr->e_shoff);
+  for (i = 0; i < ehdr->e_shnum; ++i) {
+    if (shdrs[i].sh_type == SHT_SYMTAB && !symsect) {
+      symsect = &shdrs[i];
+      symndx = i;
+    } else if (shdrs[i].sh_type == SHT_DYNSYM && !dynsect) {
+      dynsect = &shdrs[i];
+      dynndx = i;
+    }
+  }
+
+  if (!symsect) {
+    symsect = dynsect;
+    symndx = dynndx;
+  }
+
+  if (!symsect || symsect->sh_link >= ehdr->e_shnum ||
+      symsect->sh_offset + symsect->sh_size > image_size ||
+      shdrs[symsect->sh_link].sh_offset + shdrs[symsect->sh_link].sh_size >
+          image_size ||
+      symsect->sh_size < sizeof(lmon_elf_sym_t)) {
+    finalize();
+    e = func + " No symbol table section is found in " + path + " ";
+    throw symtab_exception_t(e, SDBG_SYMTAB_FAILED);
+  }
+
+  syms = (const lmon_elf_sym_t*)(image + symsect->sh_offset);
+  nsyms = symsect->sh_size / sizeof(lmon_elf_sym_t);
+  strtab = image + shdrs[symsect->sh_link].sh_offset;
+  strtab_size = shdrs[symsect->sh_link].sh_size;
+
+  for (i = 0; i < ehdr->e_shnum; ++i) {
+    if (shdrs[i].sh_link != symndx ||
+        shdrs[i].sh_offset + shdrs[i].sh_size > image_size) {
+      continue;
+    }
+    const Elf32_Word* tab = (const Elf32_Word*)(image + shdrs[i].sh_offset);
+    size_t nwords = shdrs[i].sh_size / sizeof(Elf32_Word);
+
+    //
+    // only take hash sections whose headers fit in the section
+    //
+    if (shdrs[i].sh_type == SHT_GNU_HASH && nwords >= 4 && tab[0] != 0 &&
+        tab[2] != 0 &&
+        4 + (size_t)tab[2] * (sizeof(lmon_elf_addr_t) / sizeof(Elf32_Word)) +
+                tab[0] <= nwords) {
+      gnu_hash = tab;
+      gnu_hash_words = nwords;
+    } else if (shdrs[i].sh_type == SHT_HASH && nwords >= 2 && tab[0] != 0 &&
+               2 + (size_t)tab[0] + tab[1] <= nwords) {
+      sysv_hash = tab;
+      sysv_hash_words = nwords;
+    }
+  }
+
+  return SDBG_SYMTAB_OK;
+}
+
+//!  PUBLIC:
+/*!  elf_symbol_resolver_t::finalize
+
+     unmaps the image and drops the index
+*/
+void elf_symbol_resolver_t::finalize() {
+  if (image) {
+    munmap(image, image_size);
+  }
+  image = NULL;
+  image_size = 0;
+  syms = NULL;
+  nsyms = 0;
+  strtab = NULL;
+  strtab_size = 0;
+  gnu_hash = NULL;
+  gnu_hash_words = 0;
+  sysv_hash = NULL;
+  sysv_hash_words = 0;
+  sorted.clear();
+}
+
+//!  PUBLIC:
+/*!  elf_symbol_resolver_t::lookup
+
+     returns the symbol named name, or NULL. Like the table the
+     engine used to build, only symbols with a non-zero value
+     count, and the first one wins if a name repeats.
+*/
+const lmon_elf_sym_t* elf_symbol_resolver_t::lookup(const char* name) {
+  if (!syms || !name || *name == '\0') {
+    return NULL;
+  }
+
+  if (gnu_hash) {
+    return gnu_hash_lookup(name);
+  } else if (sysv_hash) {
+    return sysv_hash_lookup(name);
+  }
+
+  return index_lookup(name);
+}
+
+//!  PRIVATE:
+/*!  elf_symbol_resolver_t::sym_name
+
+*/
+const char* elf_symbol_resolver_t::sym_name(const lmon_elf_sym_t* sym) const {
+  return (sym->st_name < strtab_size) ? strtab + sym->st_name : "";
+}
+
+//!  PRIVATE:
+/*!  elf_symbol_resolver_t::is_candidate
+
+*/
+bool elf_symbol_resolver_t::is_candidate(const lmon_elf_sym_t* sym) const {
+  return (sym->st_value != 0 && *sym_name(sym) != '\0');
+}
+
+//!  PRIVATE:
+/*!  elf_symbol_resolver_t::gnu_hash_lookup
+
+     walks the .gnu.hash bloom filter, bucket and chain for name
+*/
+const lmon_elf_sym_t* elf_symbol_resolver_t::gnu_hash_lookup(
+    const char* name) const {
+  const size_t wbits = sizeof(lmon_elf_addr_t) * 8;
+  Elf32_Word nbuckets = gnu_hash[0];
+  Elf32_Word symoffset = gnu_hash[1];
+  Elf32_Word bloom_size = gnu_hash[2];
+  Elf32_Word bloom_shift = gnu_hash[3];
+  const lmon_elf_addr_t* bloom = (const lmon_elf_addr_t*)&gnu_hash[4];
+  const Elf32_Word* buckets;
+  const Elf32_Word* chain;
+  Elf32_Word h = 5381;
+  Elf32_Word symix;
+  const unsigned char* c;
+
+  buckets = (const Elf32_Word*)&bloom[bloom_size];
+  chain = &buckets[nbuckets];
+
+  for (c = (const unsigned char*)name; *c; ++c) {
+    h = h * 33 + *c;
+  }
+
+  lmon_elf_addr_t word = bloom[(h / wbits) % bloom_size];
+  lmon_elf_addr_t mask = ((lmon_elf_addr_t)1 << (h % wbits)) |
+                         ((lmon_elf_addr_t)1 << ((h >> bloom_shift) % wbits));
+  if ((word & mask) != mask) {
+    return NULL;
+  }
+
+  symix = buckets[h % nbuckets];
+  if (symix < symoffset) {
+    return NULL;
+  }
+
+  for (; symix < nsyms; ++symix) {
+    const Elf32_Word* link = &chain[symix - symoffset];
+    if ((const char*)(link + 1) > (const char*)(gnu_hash + gnu_hash_words)) {
+      break;
+    }
+    if (((*link | 1) == (h | 1)) && is_candidate(&syms[symix]) &&
+        strcmp(name, sym_name(&syms[symix])) == 0) {
+      return &syms[symix];
+    }
+    if (*link & 1) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+//!  PRIVATE:
+/*!  elf_symbol_resolver_t::sysv_hash_lookup
+
+     walks the SysV .hash bucket and chain for name
+*/
+const lmon_elf_sym_t* elf_symbol_resolver_t::sysv_hash_lookup(
+    const char* name) const {
+  Elf32_Word nbucket = sysv_hash[0];
+  Elf32_Word nchain = sysv_hash[1];
+  const Elf32_Word* bucket = &sysv_hash[2];
+  const Elf32_Word* chain = &bucket[nbucket];
+  Elf32_Word h = 0, g;
+  Elf32_Word i, steps;
+  const unsigned char* c;
+
+  for (c = (const unsigned char*)name; *c; ++c) {
+    h = (h << 4) + *c;
+    if ((g = h & 0xf0000000)) {
+      h ^= g >> 24;
+    }
+    h &= ~g;
+  }
+
+  for (i = bucket[h % nbucket], steps = 0;
+       i != STN_UNDEF && i < nchain && i < nsyms && steps < nchain;
+       i = chain[i], ++steps) {
+    if (is_candidate(&syms[i]) && strcmp(name, sym_name(&syms[i])) == 0) {
+      return &syms[i];
+    }
+  }
+
+  return NULL;
+}
+
+//!  PRIVATE:
+/*!  elf_symbol_resolver_t::index_lookup
+
+     binary-searches the sorted index of symbol numbers, which is
+     built on the first call. The sort is stable, so the lowest
+     symbol number of a repeated name comes first.
+*/
+const lmon_elf_sym_t* elf_symbol_resolver_t::index_lookup(const char* name) {
+  std::vector<Elf32_Word>::const_iterator pos;
+  size_t i;
+
+  if (sorted.empty()) {
+    for (i = 0; i < nsyms; ++i) {
+      if (syms[i].st_name < strtab_size && is_candidate(&syms[i])) {
+        sorted.push_back((Elf32_Word)i);
+      }
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     elf_sym_name_less(syms, strtab));
+  }
+
+  pos = std::lower_bound(sorted.begin(), sorted.end(), name,
+                         elf_sym_name_less(syms, strtab));
+  if (pos == sorted.end() || strcmp(sym_name(&syms[*pos]), name) != 0) {
+    return NULL;
+  }
+
+  return &syms[*pos];
+}
+
+////////////////////////////////////////////////////////////////////
+//
+// PUBLIC INTERFACES (class elf_symbol_cache_t)
+//
+//
+
+static const char elf_symcache_magic[8] = {'L', 'M', 'S', 'Y',
+                                           'M', 'C', '0', '1'};
+
+//! struct elf_symcache_header_t
+/*!
+    leads a cache file; the key, padded to 8 bytes, the records
+    and the string table follow
+*/
+struct elf_symcache_header_t {
+  char magic[8];
+  uint32_t addr_size;
+  uint32_t key_len;
+  uint32_t nentries;
+  uint32_t strtab_size;
+};
+
+//! File scope symcache_align
+/*!
+
+*/
+static size_t symcache_align(size_t n) { return (n + 7) & ~((size_t)7); }
+
+//! File scope symcache_private_dir
+/*!
+    creates dir if need be, and accepts it only if it is ours and
+    nobody else can write into it
+*/
+static bool symcache_private_dir(const std::string &dir) {
+  struct stat sbuf;
+
+  if (mkdir(dir.c_str(), S_IRWXU) != 0 && errno != EEXIST) {
+    return false;
+  }
+
+  return (stat(dir.c_str(), &sbuf) == 0 && S_ISDIR(sbuf.st_mode) &&
+          sbuf.st_uid == getuid() && !(sbuf.st_mode & (S_IWGRP | S_IWOTH)));
+}
+
+//!  PUBLIC:
+/*!  elf_symbol_cache_t constructor & destructor
+
+*/
+elf_symbol_cache_t::elf_symbol_cache_t()
+    : cache_image(NULL),
+      cache_image_size(0),
+      entries(NULL),
+      nentries(0),
+      strtab(NULL),
+      strtab_size(0) {}
+
+elf_symbol_cache_t::~elf_symbol_cache_t() { close(); }
+
+//!  PUBLIC:
+/*!  elf_symbol_cache_t::cache_dir
+
+     returns the cache directory, creating it if need be, or an
+     empty string if the cache is off or unusable
+*/
+std::string elf_symbol_cache_t::cache_dir() {
+  std::string dir;
+  const char *env;
+
+  if ((env = getenv("LMON_ENGINE_SYMCACHE")) && strcmp(env, "0") == 0) {
+    return std::string();
+  }
+
+  if ((env = getenv("LMON_ENGINE_SYMCACHE_DIR")) && *env) {
+    dir = env;
+  } else if ((env = getenv("XDG_CACHE_HOME")) && *env == '/') {
+    dir = std::string(env) + "/launchmon";
+  } else if ((env = getenv("HOME")) && *env == '/') {
+    std::string parent = std::string(env) + "/.cache";
+    if (mkdir(parent.c_str(), S_IRWXU) != 0 && errno != EEXIST) {
+      return std::string();
+    }
+    dir = parent + "/launchmon";
+  } else {
+    return std::string();
+  }
+
+  return symcache_private_dir(dir) ? dir : std::string();
+}
+
+//!  PUBLIC:
+/*!  elf_symbol_cache_t::open
+
+     computes the key of the image at path and maps its cache file
+     if there is a valid one. Returns true if records were loaded.
+*/
+bool elf_symbol_cache_t::open(const std::string &path) {
+  std::string dir;
+  uint64_t h = 14695981039346656037ULL;
+  std::string::const_iterator c;
+  char fn[32];
+
+  close();
+
+  if ((dir = cache_dir()).empty() || !make_key(path)) {
+    key.clear();
+    return false;
+  }
+
+  //
+  // FNV-1a of the path names the file, so that a rebuilt image
+  // overwrites the file of its predecessor rather than adding
+  // one; the key tells whether the file still matches the image
+  //
+  for (c = path.begin(); c != path.end(); ++c) {
+    h ^= (unsigned char)*c;
+    h *= 1099511628211ULL;
+  }
+  snprintf(fn, sizeof(fn), "/%016llx.symc", (unsigned long long)h);
+  cache_fn = dir + fn;
+
+  return load();
+}
+
+//!  PUBLIC:
+/*!  elf_symbol_cache_t::close
+
+     writes the records added since the file was mapped, if any,
+     then unmaps the cache file and forgets the image
+*/
+void elf_symbol_cache_t::close() {
+  if (!key.empty() && !added.empty()) {
+    flush();
+  }
+
+  if (cache_image) {
+    munmap(cache_image, cache_image_size);
+  }
+  cache_image = NULL;
+  cache_image_size = 0;
+  entries = NULL;
+  nentries = 0;
+  strtab = NULL;
+  strtab_size = 0;
+  added.clear();
+  key.clear();
+  cache_fn.clear();
+}
+
+//!  PUBLIC:
+/*!  elf_symbol_cache_t::lookup
+
+     returns 1 and fills sym if name is cached as a symbol, 0 if
+     it is cached as missing and -1 if it isn't cached.
+*/
+int elf_symbol_cache_t::lookup(const char *name, lmon_elf_sym_t *sym) const {
+  const elf_symcache_entry_t *e = NULL;
+  std::map<std::string, elf_symcache_entry_t>::const_iterator pos;
+
+  if (key.empty()) {
+    return -1;
+  }
+
+  if (entries) {
+    uint32_t lo = 0, hi = nentries;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      int cmp = strcmp(strtab + entries[mid].name, name);
+      if (cmp == 0) {
+        e = &entries[mid];
+        break;
+      } else if (cmp < 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+  }
+
+  if (!e && (pos = added.find(name)) != added.end()) {
+    e = &(pos->second);
+  }
+
+  if (!e) {
+    return -1;
+  }
+
+  if (!e->found) {
+    return 0;
+  }
+
+  memset(sym, 0, sizeof(*sym));
+  sym->st_value = (lmon_elf_addr_t)e->value;
+  sym->st_shndx = e->shndx;
+  sym->st_info = e->info;
+  sym->st_other = e->other;
+
+  return 1;
+}
+
+//!  PUBLIC:
+/*!  elf_symbol_cache_t::record
+
+     caches the outcome of looking up name, sym being NULL if the
+     image has no such symbol. The file is written by close.
+*/
+void elf_symbol_cache_t::record(const char *name, const lmon_elf_sym_t *sym) {
+  elf_symcache_entry_t e;
+  lmon_elf_sym_t dummy;
+
+  if (key.empty() || lookup(name, &dummy) >= 0) {
+    return;
+  }
+
+  memset(&e, 0, sizeof(e));
+  if (sym) {
+    e.value = (uint64_t)sym->st_value;
+    e.found = 1;
+    e.shndx = sym->st_shndx;
+    e.info = sym->st_info;
+    e.other = sym->st_other;
+  }
+  added[name] = e;
+}
+
+//!  PRIVATE:
+/*!  elf_symbol_cache_t::make_key
+
+     keys the image by its GNU build-id note or, lacking one, by
+     its path, device, inode, mtime and size. Either is followed
+     by the kind and size of the symbol table the resolver would
+     pick, as stripping an image keeps its build-id.
+*/
+bool elf_symbol_cache_t::make_key(const std::string &path) {
+  const lmon_elf_ehdr_t *ehdr;
+  const lmon_elf_shdr_t *shdrs;
+  const lmon_elf_shdr_t *symsect = NULL;
+  const lmon_elf_shdr_t *dynsect = NULL;
+  struct stat sbuf;
+  char *image;
+  char buf[PATH_MAX + 128];
+  std::string tabkey = ":nosyms";
+  size_t i;
+  int fd;
+
+  key.clear();
+
+  if ((fd = ::open(path.c_str(), O_RDONLY)) == -1) {
+    return false;
+  }
+
+  if (fstat(fd, &sbuf) != 0 || (size_t)sbuf.st_size < sizeof(*ehdr)) {
+    ::close(fd);
+    return false;
+  }
+
+  image = (char *)mmap(NULL, sbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (image == MAP_FAILED) {
+    return false;
+  }
+
+  ehdr = (const lmon_elf_ehdr_t *)image;
+  if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) == 0 &&
+      ehdr->e_shentsize == sizeof(lmon_elf_shdr_t) &&
+      ehdr->e_shoff + (size_t)ehdr->e_shnum * sizeof(lmon_elf_shdr_t) <=
+          (size_t)sbuf.st_size) {
+    shdrs = (const lmon_elf_shdr_t *)(image + ehdr->e_shoff);
+
+    for (i = 0; i < ehdr->e_shnum; ++i) {
+      if (shdrs[i].sh_type == SHT_SYMTAB && !symsect) {
+        symsect = &shdrs[i];
+      } else if (shdrs[i].sh_type == SHT_DYNSYM && !dynsect) {
+        dynsect = &shdrs[i];
+      }
+    }
+
+    //
+    // .symtab if present, .dynsym otherwise, like the resolver
+    //
+    if (symsect || dynsect) {
+      snprintf(buf, sizeof(buf), ":%s:%llu", symsect ? "symtab" : "dynsym",
+               (unsigned long long)(symsect ? symsect : dynsect)->sh_size);
+      tabkey = buf;
+    }
+
+    for (i = 0; i < ehdr->e_shnum && key.empty(); ++i) {
+      size_t off = shdrs[i].sh_offset;
+      size_t end = off + shdrs[i].sh_size;
+
+      if (shdrs[i].sh_type != SHT_NOTE || end > (size_t)sbuf.st_size) {
+        continue;
+      }
+
+      //
+      // ELF notes use the same layout for both classes
+      //
+      while (off + sizeof(Elf32_Nhdr) <= end) {
+        const Elf32_Nhdr *nh = (const Elf32_Nhdr *)(image + off);
+        size_t name_at = off + sizeof(Elf32_Nhdr);
+        size_t desc_at = name_at + ((nh->n_namesz + 3) & ~3U);
+        if (desc_at + nh->n_descsz > end) {
+          break;
+        }
+
+        if (nh->n_type == NT_GNU_BUILD_ID && nh->n_namesz == 4 &&
+            memcmp(image + name_at, "GNU", 4) == 0 && nh->n_descsz > 0) {
+          const unsigned char *d = (const unsigned char *)(image + desc_at);
+          uint32_t k;
+
+          key = "build-id:";
+          for (k = 0; k < nh->n_descsz; ++k) {
+            snprintf(buf, sizeof(buf), "%02x", d[k]);
+            key += buf;
+          }
+          break;
+        }
+
+        off = desc_at + ((nh->n_descsz + 3) & ~3U);
+      }
+    }
+  }
+
+  munmap(image, sbuf.st_size);
+
+  if (key.empty()) {
+    snprintf(buf, sizeof(buf), "file:%s:%llu:%llu:%lld.%09ld:%lld",
+             path.c_str(), (unsigned long long)sbuf.st_dev,
+             (unsigned long long)sbuf.st_ino, (long long)sbuf.st_mtim.tv_sec,
+             (long)sbuf.st_mtim.tv_nsec, (long long)sbuf.st_size);
+    key = buf;
+  }
+  key += tabkey;
+
+  return true;
+}
+
+//!  PRIVATE:
+/*!  elf_symbol_cache_t::load
+
+     maps cache_fn and accepts it only if its header, key and
+     sizes all check out
+*/
+bool elf_symbol_cache_t::load() {
+  const elf_symcache_header_t *hdr;
+  struct stat sbuf;
+  size_t need;
+  int fd;
+
+  if ((fd = ::open(cache_fn.c_str(), O_RDONLY)) == -1) {
+    return false;
+  }
+
+  if (fstat(fd, &sbuf) != 0 || (size_t)sbuf.st_size < sizeof(*hdr)) {
+    ::close(fd);
+    return false;
+  }
+
+  cache_image =
+      (char *)mmap(NULL, sbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (cache_image == MAP_FAILED) {
+    cache_image = NULL;
+    return false;
+  }
+  cache_image_size = sbuf.st_size;
+
+  hdr = (const elf_symcache_header_t *)cache_image;
+  need = symcache_align(sizeof(*hdr) + hdr->key_len) +
+         (size_t)hdr->nentries * sizeof(elf_symcache_entry_t) +
+         hdr->strtab_size;
+
+  if (memcmp(hdr->magic, elf_symcache_magic, sizeof(hdr->magic)) != 0 ||
+      hdr->addr_size != sizeof(lmon_elf_addr_t) || need != cache_image_size ||
+      hdr->key_len != key.size() ||
+      memcmp(cache_image + sizeof(*hdr), key.data(), key.size()) != 0 ||
+      (hdr->strtab_size > 0 &&
+       cache_image[cache_image_size - 1] != '\0')) {
+    munmap(cache_image, cache_image_size);
+    cache_image = NULL;
+    cache_image_size = 0;
+    return false;
+  }
+
+  nentries = hdr->nentries;
+  entries = (const elf_symcache_entry_t *)(cache_image +
+                                           symcache_align(sizeof(*hdr) +
+                                                          hdr->key_len));
+  strtab = (const char *)(entries + nentries);
+  strtab_size = hdr->strtab_size;
+
+  for (uint32_t i = 0; i < nentries; ++i) {
+    if (entries[i].name >= strtab_size) {
+      munmap(cache_image, cache_image_size);
+      cache_image = NULL;
+      cache_image_size = 0;
+      entries = NULL;
+      nentries = 0;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//!  PRIVATE:
+/*!  elf_symbol_cache_t::flush
+
+     writes the mapped and the new records, merged and sorted by
+     name, to a temporary file and renames it over cache_fn, so
+     that concurrent engines only ever see complete files
+*/
+bool elf_symbol_cache_t::flush() {
+  std::map<std::string, elf_symcache_entry_t> all(added);
+  std::map<std::string, elf_symcache_entry_t>::iterator iter;
+  std::vector<elf_symcache_entry_t> recs;
+  std::string names;
+  elf_symcache_header_t hdr;
+  std::string tmpfn = cache_fn + ".XXXXXX";
+  std::vector<char> tmpbuf(tmpfn.begin(), tmpfn.end());
+  std::vector<char> out;
+  uint32_t i;
+  int fd;
+
+  for (i = 0; i < nentries; ++i) {
+    all.insert(std::make_pair(std::string(strtab + entries[i].name),
+                              entries[i]));
+  }
+
+  for (iter = all.begin(); iter != all.end(); ++iter) {
+    iter->second.name = (uint32_t)names.size();
+    names.append(iter->first.c_str(), iter->first.size() + 1);
+    recs.push_back(iter->second);
+  }
+
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, elf_symcache_magic, sizeof(hdr.magic));
+  hdr.addr_size = sizeof(lmon_elf_addr_t);
+  hdr.key_len = (uint32_t)key.size();
+  hdr.nentries = (uint32_t)recs.size();
+  hdr.strtab_size = (uint32_t)names.size();
+
+  out.resize(symcache_align(sizeof(hdr) + key.size()), '\0');
+  memcpy(&out[0], &hdr, sizeof(hdr));
+  memcpy(&out[sizeof(hdr)], key.data(), key.size());
+  if (!recs.empty()) {
+    const char *r = (const char *)&recs[0];
+    out.insert(out.end(), r, r + recs.size() * sizeof(elf_symcache_entry_t));
+  }
+  out.insert(out.end(), names.begin(), names.end());
+
+  tmpbuf.push_back('\0');
+  if ((fd = mkstemp(&tmpbuf[0])) == -1) {
+    return false;
+  }
+
+  size_t done = 0;
+  while (done < out.size()) {
+    ssize_t n = write(fd, &out[done], out.size() - done);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    done += n;
+  }
+
+  if (::close(fd) != 0 || done != out.size() ||
+      rename(&tmpbuf[0], cache_fn.c_str()) != 0) {
+    unlink(&tmpbuf[0]);
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * ts=2 sw=2 expandtab
+ */
@@ -0,0 +1,180 @@
+/*
+ *--------------------------------------------------------------------------------
+ * Copyright (c) 2008, Lawrence Livermore National Security, LLC. Produced at
+ * the Lawrence Livermore National Laboratory. Written by Dong H. Ahn
+ * <ahn1@llnl.gov>. LLNL-CODE-409469. All rights reserved.
+ *
+ * This file is part of LaunchMON. For details, see
+ * https://computing.llnl.gov/?set=resources&page=os_projects
+ *
+ * Please also read LICENSE.txt -- Our Notice and GNU Lesser General Public
+ * License.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the terms and conditions of the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple
+ * Place, Suite 330, Boston, MA 02111-1307 USA
+ *--------------------------------------------------------------------------------
+ */
+
+#ifndef SDBG_LINUX_ELFSYM_HXX
+#define SDBG_LINUX_ELFSYM_HXX 1
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <elf.h>
+}
+
+#include "sdbg_std.hxx"
+#include "sdbg_base_symtab.hxx"
+
+#if BIT64
+typedef Elf64_Ehdr lmon_elf_ehdr_t;
+typedef Elf64_Shdr lmon_elf_shdr_t;
+typedef Elf64_Sym lmon_elf_sym_t;
+typedef Elf64_Addr lmon_elf_addr_t;
+#else
+typedef Elf32_Ehdr lmon_elf_ehdr_t;
+typedef Elf32_Shdr lmon_elf_shdr_t;
+typedef Elf32_Sym lmon_elf_sym_t;
+typedef Elf32_Addr lmon_elf_addr_t;
+#endif
+
+//!
+/*! elf_symbol_resolver_t
+
+    resolves linkage symbols by name straight out of an mmap'ed
+    ELF image without materializing its symbol table. A symbol
+    table that a .gnu.hash or .hash section covers is searched
+    through it; otherwise, e.g. for the full .symtab, a sorted
+    index of symbol numbers is built on the first lookup.
+*/
+class elf_symbol_resolver_t {
+ public:
+  //
+  // constructors & destructor
+  //
+  elf_symbol_resolver_t();
+  ~elf_symbol_resolver_t();
+
+  symtab_error_e init(const std::string& path) throw(symtab_exception_t);
+  void finalize();
+
+  const lmon_elf_sym_t* lookup(const char* name);
+  size_t get_num_symbols() const { return nsyms; }
+  bool is_open() const { return (image != NULL); }
+
+ private:
+  elf_symbol_resolver_t(const elf_symbol_resolver_t& r);
+  elf_symbol_resolver_t& operator=(const elf_symbol_resolver_t& r);
+
+  const char* sym_name(const lmon_elf_sym_t* sym) const;
+  bool is_candidate(const lmon_elf_sym_t* sym) const;
+  const lmon_elf_sym_t* gnu_hash_lookup(const char* name) const;
+  const lmon_elf_sym_t* sysv_hash_lookup(const char* name) const;
+  const lmon_elf_sym_t* index_lookup(const char* name);
+
+  char* image;
+  size_t image_size;
+  const lmon_elf_sym_t* syms;
+  size_t nsyms;
+  const char* strtab;
+  size_t strtab_size;
+  const Elf32_Word* gnu_hash;
+  size_t gnu_hash_words;
+  const Elf32_Word* sysv_hash;
+  size_t sysv_hash_words;
+  std::vector<Elf32_Word> sorted;
+};
+
+//! struct elf_symcache_entry_t
+/*!
+    a symbol cache record: a symbol the engine looked up, or a
+    name found not to exist in the image (found == 0)
+*/
+struct elf_symcache_entry_t {
+  uint64_t value;
+  uint32_t name;
+  uint32_t found;
+  uint16_t shndx;
+  uint8_t info;
+  uint8_t other;
+  uint32_t reserved;
+};
+
+//!
+/*! elf_symbol_cache_t
+
+    persistent per-user cache of the linkage symbols the engine
+    looks up in an image. Each image path has a small file, keyed
+    by the image's GNU build-id or, lacking one, by its path,
+    inode, mtime and size, plus the kind and size of its symbol
+    table. The file holds a header, the key, records sorted by
+    name and their string table, so it can be mmap'ed and
+    binary-searched as is. New records are kept in memory and
+    written out once, by replacing the file, when the cache is
+    closed. A file whose key no longer matches is thus replaced by
+    the first session that uses the new image, but files of paths
+    that are gone are never removed.
+
+    The cache lives in $LMON_ENGINE_SYMCACHE_DIR, else in
+    $XDG_CACHE_HOME/launchmon or $HOME/.cache/launchmon; setting
+    LMON_ENGINE_SYMCACHE to 0 turns it off.
+*/
+class elf_symbol_cache_t {
+ public:
+  //
+  // constructors & destructor
+  //
+  elf_symbol_cache_t();
+  ~elf_symbol_cache_t();
+
+  bool open(const std::string& path);
+  void close();
+
+  bool is_loaded() const { return (cache_image != NULL); }
+  const std::string& get_key() const { return key; }
+
+  int lookup(const char* name, lmon_elf_sym_t* sym) const;
+  void record(const char* name, const lmon_elf_sym_t* sym);
+
+  static std::string cache_dir();
+
+ private:
+  elf_symbol_cache_t(const elf_symbol_cache_t& c);
+  elf_symbol_cache_t& operator=(const elf_symbol_cache_t& c);
+
+  bool make_key(const std::string& path);
+  bool load();
+  bool flush();
+
+  std::string key;
+  std::string cache_fn;
+  char* cache_image;
+  size_t cache_image_size;
+  const elf_symcache_entry_t* entries;
+  uint32_t nentries;
+  const char* strtab;
+  uint32_t strtab_size;
+  std::map<std::string, elf_symcache_entry_t> added;
+};
+
+#endif  // SDBG_LINUX_ELFSYM_HXX
+
+/*
+ * ts=2 sw=2 expandtab
+ */
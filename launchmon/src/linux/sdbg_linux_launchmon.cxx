@@ -124,17 +124,23 @@ extern "C" {
 #include <libgen.h>
 #include <limits.h>
 #include <link.h>
+#include <pthread.h>
+#include <signal.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <thread_db.h>
 }
 
+#include <algorithm>
+
 #include "sdbg_base_mach.hxx"
 #include "sdbg_base_mach_impl.hxx"
 #include "sdbg_base_symtab.hxx"
 #include "sdbg_base_symtab_impl.hxx"
 #include "sdbg_base_tracer.hxx"
+#include "sdbg_engine_stats.hxx"
 #include "sdbg_self_trace.hxx"
 
 #include "sdbg_base_launchmon.hxx"
@@ -351,6 +357,11 @@ launchmon_rc_e linux_launchmon_t::init_API(opts_args_t *opt) {
   // setting API mode flag
   //
   set_API_mode(true);
+  set_rpdtab_enc(
+      str_to_rpdtab_enc(opt->get_my_opt()->rpdtab_enc.c_str()));
+  if (opt->get_my_opt()->rpdtab_chunk > 0) {
+    set_rpdtab_chunk((unsigned int)opt->get_my_opt()->rpdtab_chunk);
+  }
 
   {
     self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
@@ -438,25 +449,21 @@ bool linux_launchmon_t::launch_tool_daemons(
     // using the API mode.
     //
 
-    map<string, vector<MPIR_PROCDESC_EXT *> >::const_iterator pos;
-    vector<MPIR_PROCDESC_EXT *>::const_iterator vpos;
-    char *execname = NULL;
+    proctab_t &pt = get_proctable_copy();
+    size_t h, i;
 
-    for (pos = get_proctable_copy().begin(); pos != get_proctable_copy().end();
-         pos++) {
+    for (h = 0; h < pt.num_hosts(); h++) {
       string pidlist;
-      for (vpos = pos->second.begin(); vpos != pos->second.end(); vpos++) {
-        char pidbuf[10];
-        sprintf(pidbuf, "%d:", (*vpos)->pd.pid);
+      for (i = pt.host_begin(h); i < pt.host_end(h); i++) {
+        char pidbuf[16];
+        sprintf(pidbuf, "%d:", pt.task_pid(i));
         pidlist = pidlist + string(pidbuf);
-
-        if (!execname) execname = strdup((*vpos)->pd.executable_name);
       }
 
       //
       // envVar looks like LAUNCHMON_alc0=12376:23452
       //
-      string envname = string("LAUNCHMON_") + string(pos->first);
+      string envname = string("LAUNCHMON_") + string(pt.host_name(h));
       setenv(envname.c_str(), pidlist.c_str(), 1);
     }
   }
@@ -466,16 +473,13 @@ bool linux_launchmon_t::launch_tool_daemons(
     // mpirun model checker support
     //
 
-    map<string, vector<MPIR_PROCDESC_EXT *> >::const_iterator pos;
-    vector<MPIR_PROCDESC_EXT *>::const_iterator vpos;
+    proctab_t &pt = get_proctable_copy();
+    size_t i;
 
-    for (pos = get_proctable_copy().begin(); pos != get_proctable_copy().end();
-         pos++) {
-      for (vpos = pos->second.begin(); vpos != pos->second.end(); vpos++) {
-        self_trace_t::trace(1, MODULENAME, 0, "MODEL CHECKER: %s, %d, %s",
-                            (*vpos)->pd.host_name, (*vpos)->pd.pid,
-                            (*vpos)->pd.executable_name);
-      }
+    for (i = 0; i < pt.size(); i++) {
+      self_trace_t::trace(1, MODULENAME, 0, "MODEL CHECKER: %s, %d, %s",
+                          pt.task_host_name(i), pt.task_pid(i),
+                          pt.task_executable_name(i));
     }
     return LAUNCHMON_OK;
   }
@@ -559,21 +563,17 @@ bool linux_launchmon_t::launch_tool_daemons(
       }
     }
 
-    std::map<std::string, std::vector<MPIR_PROCDESC_EXT *> >::const_iterator
-        pos;
-    int count = 0;
-    for (pos = get_proctable_copy().begin(); pos != get_proctable_copy().end();
-         ++pos) {
-      hnstream << pos->first;
-      count++;
+    size_t h;
+    for (h = 0; h < get_proctable_copy().num_hosts(); ++h) {
+      hnstream << get_proctable_copy().host_name(h);
       hnstream << "\n";
     }
     hnstream.flush();
     hnstream.close();
 
-    p.rmgr()->set_paramset(get_proctable_copy().size(),
-                           get_proctable_copy().size(), sharedsecret, randomID,
-                           get_resid(), hnfn);
+    p.rmgr()->set_paramset(get_proctable_copy().num_hosts(),
+                           get_proctable_copy().num_hosts(), sharedsecret,
+                           randomID, get_resid(), hnfn);
 
     free(tokenize2);
 
@@ -590,6 +590,14 @@ bool linux_launchmon_t::launch_tool_daemons(
     //
     set_toollauncherpid(fork());
     if (!get_toollauncherpid()) {
+      //
+      // The event manager blocks SIGCHLD to read it from a
+      // signalfd; the mask survives exec, so clear it here.
+      //
+      sigset_t mask;
+      sigemptyset(&mask);
+      sigprocmask(SIG_SETMASK, &mask, NULL);
+
       char **av = (char **)malloc((alist.size() + 1) * sizeof(char *));
       size_t indx = 0;
       std::list<std::string>::iterator iter;
@@ -616,10 +624,55 @@ bool linux_launchmon_t::launch_tool_daemons(
   return LAUNCHMON_OK;
 }
 
+//! PRIVATE: linux_launchmon_t::launch_and_ship_proctab
+/*!
+    launches the tool daemons and then hands the freshly acquired
+    RPDTAB, resource handle and RM info over to the FE, followed by
+    stop_msg. The daemon launcher only needs the unique host set,
+    so forking it first lets the RM start the daemons while the
+    proctable is still being shipped.
+*/
+bool linux_launchmon_t::launch_and_ship_proctab(
+    process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
+    lmonp_fe_to_fe_msg_e stop_msg) {
+  uint64_t begin_ts = engine_stats_t::now_usec();
+  uint64_t forked_ts, shipped_ts;
+  bool rc;
+
+  rc = launch_tool_daemons(p);
+  forked_ts = engine_stats_t::now_usec();
+
+  ship_proctab_msg(lmonp_proctable_avail);
+  ship_resourcehandle_msg(lmonp_resourcehandle_avail, get_resid());
+  ship_rminfo_msg(lmonp_rminfo, (int)p.get_pid(false),
+                  p.rmgr()->get_resource_manager().get_rm());
+  say_fetofe_msg(stop_msg);
+  shipped_ts = engine_stats_t::now_usec();
+
+  {
+    self_trace_t::trace(LEVELCHK(level1), MODULENAME, 0,
+                        "%lu tasks on %lu hosts: daemon launcher (pid %d) "
+                        "forked in %llu usec, proctable shipped in %llu usec "
+                        "while the daemons start up",
+                        (unsigned long)get_proctable_copy().size(),
+                        (unsigned long)get_proctable_copy().num_hosts(),
+                        (int)get_toollauncherpid(),
+                        (unsigned long long)(forked_ts - begin_ts),
+                        (unsigned long long)(shipped_ts - forked_ts));
+  }
+
+  return rc;
+}
+
 //! PRIVATE: handle_bp_prologue
 /*!
     performs the breakpoint event prologue. It includes
-    stepping over the target breakpoint.
+    stepping over the target breakpoint: by emulating the
+    instruction under it if possible, in which case
+    LAUNCHMON_OK is returned and the event can be handled
+    right away, and otherwise by single-stepping the original
+    instruction, in which case LAUNCHMON_BP_PROLOGUE is
+    returned and the event is handled on the next stop.
 */
 launchmon_rc_e linux_launchmon_t::handle_bp_prologue(
     process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
@@ -648,11 +701,49 @@ launchmon_rc_e linux_launchmon_t::handle_bp_prologue(
     }
 
     bp->set_return_addr(retaddr);
+
+    if (!bp->get_use_indirection()) {
+      //
+      // Most breakpoints sit on a function entry instruction
+      // that is easily emulated. Doing so leaves the breakpoint
+      // in place and lets the handler run on this very stop,
+      // sparing the single-step stop and the reinsertion.
+      //
+      T_IT orig_insn = bp->get_orig_instruction();
+      unsigned char insn[sizeof(T_IT)];
+      T_VA store_addr = T_UNINIT_HEX;
+      T_WT store[2];
+      int nstore = 0;
+
+      memcpy(insn, &orig_insn, sizeof(insn));
+      if (p.get_gprset(use_cxt)->emulate_bp_insn(
+              bp->get_address_at(), insn, sizeof(insn), retaddr, store_addr,
+              store, nstore)) {
+        if (nstore > 0) {
+          get_tracer()->tracer_write(p, store_addr, store,
+                                     nstore * sizeof(T_WT), use_cxt);
+        }
+        get_tracer()->tracer_setregs(p, use_cxt);
+        engine_stats_t::stats().count_bp_stepover(true);
+
+        {
+          self_trace_t::trace(
+              LEVELCHK(level3), MODULENAME, 0,
+              "breakpoint instruction emulated. [pc=0x%lx, next pc=0x%lx]",
+              (unsigned long)pc,
+              (unsigned long)p.get_gprset(use_cxt)->get_pc());
+        }
+
+        return LAUNCHMON_OK;
+      }
+    }
+
     get_tracer()->disable_breakpoint(p, *bp, use_cxt);
     adjusted_pc = bp->get_address_at();
     p.get_gprset(use_cxt)->set_pc(adjusted_pc);
     get_tracer()->tracer_setregs(p, use_cxt);
     get_tracer()->tracer_singlestep(p, use_cxt);
+    engine_stats_t::stats().count_bp_stepover(false);
 
     {
       self_trace_t::trace(LEVELCHK(level3), MODULENAME, 0,
@@ -739,15 +830,7 @@ bool linux_launchmon_t::continue_on_attach(
     //
     // fetching the RPDTAB size
     //
-    symbol_base_t<T_VA> debug_ps =
-        main_im->get_a_symbol(p.get_launch_proctable_size());
-
-    if (!debug_ps && p.get_myrmso_image()) {
-      debug_ps =
-          p.get_myrmso_image()->get_a_symbol(p.get_launch_proctable_size());
-    }
-
-    T_VA procsize_addr = debug_ps.get_relocated_address();
+    T_VA procsize_addr = get_mpir_addrs(p).proctable_size;
 
     get_tracer()->tracer_read(p, procsize_addr, &(local_pcount),
                               sizeof(local_pcount), use_cxt);
@@ -789,6 +872,281 @@ bool linux_launchmon_t::continue_on_attach(
   }
 }
 
+//! File scope string_fetch_range_t
+/*!
+    a range of remote memory holding the strings addrs[first..last]
+*/
+struct string_fetch_range_t {
+  size_t first;
+  size_t last;
+  T_VA start;
+  T_VA end;
+};
+
+//! File scope resolve_range_strings
+/*!
+    resolves the strings of range r from rbuf, a copy of the range's
+    remote memory. Indices of strings that continue past the end of
+    the range are appended to missed.
+*/
+static void resolve_range_strings(const char *rbuf,
+                                  const string_fetch_range_t &r,
+                                  const std::vector<T_VA> &addrs,
+                                  std::vector<std::string> &strs,
+                                  std::vector<size_t> &missed) {
+  size_t k;
+
+  for (k = r.first; k <= r.last; ++k) {
+    size_t off = (size_t)(addrs[k] - r.start);
+    size_t maxlen = (size_t)(r.end - addrs[k]);
+    if (maxlen > (size_t)MAX_STRING_SIZE) {
+      maxlen = MAX_STRING_SIZE;
+    }
+
+    const char *nul = (const char *)memchr(rbuf + off, '\0', maxlen);
+    if (nul || maxlen == (size_t)MAX_STRING_SIZE) {
+      strs[k].assign(rbuf + off,
+                     nul ? (size_t)(nul - (rbuf + off)) : maxlen - 1);
+    } else {
+      missed.push_back(k);
+    }
+  }
+}
+
+#if HAVE_PROCESS_VM_READV
+//! File scope string_fetch_worker_t
+/*!
+    the share of string_fetch_worker: ranges [begin, end). Ranges that
+    cannot be read with process_vm_readv are left in failed for the
+    engine thread, which can fall back to ptrace.
+*/
+struct string_fetch_worker_t {
+  pthread_t thr;
+  pid_t pid;
+  const std::vector<T_VA> *addrs;
+  std::vector<std::string> *strs;
+  const string_fetch_range_t *ranges;
+  size_t begin;
+  size_t end;
+  std::vector<size_t> failed;
+  std::vector<size_t> missed;
+  size_t nreads;
+  size_t nbytes;
+};
+
+//! File scope string_fetch_worker
+/*!
+    reads each range of its share into its own arena with
+    process_vm_readv and resolves the strings it holds. Workers write
+    to disjoint elements of strs and never touch the tracer, whose
+    ptrace requests must come from the engine thread.
+*/
+static void *string_fetch_worker(void *arg) {
+  string_fetch_worker_t *w = (string_fetch_worker_t *)arg;
+  char *arena;
+  size_t j;
+
+  if (!(arena = (char *)malloc(MAX_STRING_FETCH_RANGE + MAX_STRING_SIZE))) {
+    for (j = w->begin; j < w->end; ++j) w->failed.push_back(j);
+    return NULL;
+  }
+
+  for (j = w->begin; j < w->end; ++j) {
+    const string_fetch_range_t &r = w->ranges[j];
+    struct iovec local;
+    struct iovec remote;
+    ssize_t n;
+
+    local.iov_base = arena;
+    local.iov_len = (size_t)(r.end - r.start);
+    remote.iov_base = (void *)r.start;
+    remote.iov_len = local.iov_len;
+
+    n = process_vm_readv(w->pid, &local, 1, &remote, 1, 0);
+    w->nreads++;
+    if (n != (ssize_t)local.iov_len) {
+      w->failed.push_back(j);
+      continue;
+    }
+
+    w->nbytes += local.iov_len;
+    resolve_range_strings(arena, r, *(w->addrs), *(w->strs), w->missed);
+  }
+
+  free(arena);
+
+  return NULL;
+}
+#endif
+
+//! PRIVATE: linux_launchmon_t::fetch_proctable_strings
+/*!
+    fetches the host and executable names pointed by the n entries
+    of tab. Remote string addresses are deduplicated and sorted;
+    neighboring addresses are then coalesced into ranges that are
+    fetched with a single read each, and the strings are resolved
+    locally from those buffers. On return, strs[k] holds the string
+    at addrs[k] and addrs is sorted for lower_bound lookups.
+
+    Adjacent addresses in a range are never more than a page apart
+    and a range ends at the page that contains its last address, so
+    a range never touches a page that does not hold one of the strings.
+
+    With more than one fetch thread, the ranges are partitioned
+    across a pool of workers that read them concurrently while the
+    launcher stays stopped; whatever the workers could not read is
+    then fetched through the tracer.
+*/
+bool linux_launchmon_t::fetch_proctable_strings(
+    process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p, bool use_cxt,
+    const MPIR_PROCDESC *tab, unsigned long long n, std::vector<T_VA> &addrs,
+    std::vector<std::string> &strs) {
+  using namespace std;
+
+  const T_VA pgsz = (T_VA)sysconf(_SC_PAGESIZE);
+  uint64_t begin_ts = engine_stats_t::now_usec();
+  unsigned long long i;
+  size_t first, last, j;
+  size_t nreads = 0;
+  size_t nbytes = 0;
+  int nthreads = 1;
+  std::vector<string_fetch_range_t> ranges;
+  std::vector<size_t> todo;
+  std::vector<size_t> missed;
+  char *rbuf;
+
+  addrs.clear();
+  addrs.reserve(2 * n);
+  for (i = 0; i < n; ++i) {
+    addrs.push_back((T_VA)tab[i].host_name);
+    addrs.push_back((T_VA)tab[i].executable_name);
+  }
+  sort(addrs.begin(), addrs.end());
+  addrs.erase(unique(addrs.begin(), addrs.end()), addrs.end());
+  strs.assign(addrs.size(), string());
+
+  for (first = 0; first < addrs.size(); first = last + 1) {
+    //
+    // growing the range while the next address is close enough
+    //
+    last = first;
+    while (last + 1 < addrs.size() && addrs[last + 1] - addrs[last] <= pgsz &&
+           addrs[last + 1] - addrs[first] < (T_VA)MAX_STRING_FETCH_RANGE) {
+      last++;
+    }
+
+    string_fetch_range_t r;
+    r.first = first;
+    r.last = last;
+    r.start = addrs[first];
+    r.end = addrs[last] + MAX_STRING_SIZE;
+    T_VA pgend = (addrs[last] / pgsz + 1) * pgsz;
+    if (r.end > pgend) {
+      r.end = pgend;
+    }
+    ranges.push_back(r);
+  }
+
+#if HAVE_PROCESS_VM_READV
+  nthreads = p.get_myopts()->get_my_opt()->fetch_threads;
+  if (nthreads > (int)ranges.size()) {
+    nthreads = (int)ranges.size();
+  }
+
+  if (nthreads > 1) {
+    std::vector<string_fetch_worker_t> workers(nthreads);
+    int t, nstarted = 0;
+
+    for (t = 0; t < nthreads; ++t) {
+      string_fetch_worker_t &w = workers[t];
+      w.pid = p.get_pid(use_cxt);
+      w.addrs = &addrs;
+      w.strs = &strs;
+      w.ranges = &ranges[0];
+      w.begin = ranges.size() * t / nthreads;
+      w.end = ranges.size() * (t + 1) / nthreads;
+      w.nreads = 0;
+      w.nbytes = 0;
+    }
+
+    for (t = 0; t < nthreads; ++t) {
+      if (pthread_create(&(workers[t].thr), NULL, string_fetch_worker,
+                         &workers[t]) != 0) {
+        break;
+      }
+      nstarted++;
+    }
+
+    for (t = 0; t < nthreads; ++t) {
+      string_fetch_worker_t &w = workers[t];
+
+      if (t < nstarted) {
+        pthread_join(w.thr, NULL);
+      } else {
+        for (j = w.begin; j < w.end; ++j) todo.push_back(j);
+      }
+      todo.insert(todo.end(), w.failed.begin(), w.failed.end());
+      missed.insert(missed.end(), w.missed.begin(), w.missed.end());
+      engine_stats_t::stats().count_mem_reads(w.nreads, w.nbytes);
+      nreads += w.nreads;
+      nbytes += w.nbytes;
+    }
+
+    if (!todo.empty()) {
+      self_trace_t::trace(LEVELCHK(level1), MODULENAME, 0,
+                          "%lu of %lu ranges left to the tracer",
+                          (unsigned long)todo.size(),
+                          (unsigned long)ranges.size());
+    }
+  } else
+#endif
+  {
+    nthreads = 1;
+    for (j = 0; j < ranges.size(); ++j) todo.push_back(j);
+  }
+
+  if (!todo.empty() || !missed.empty()) {
+    if (!(rbuf = (char *)malloc(MAX_STRING_FETCH_RANGE + MAX_STRING_SIZE))) {
+      self_trace_t::trace(true, MODULENAME, 1, "Out of memory!");
+      return false;
+    }
+
+    for (j = 0; j < todo.size(); ++j) {
+      const string_fetch_range_t &r = ranges[todo[j]];
+
+      get_tracer()->tracer_read(p, r.start, rbuf, (int)(r.end - r.start),
+                                use_cxt);
+      nreads++;
+      nbytes += (size_t)(r.end - r.start);
+      resolve_range_strings(rbuf, r, addrs, strs, missed);
+    }
+
+    for (j = 0; j < missed.size(); ++j) {
+      //
+      // the string continues past its range; fetch it separately.
+      //
+      get_tracer()->tracer_read_string(p, addrs[missed[j]], (void *)rbuf,
+                                       MAX_STRING_SIZE, use_cxt);
+      rbuf[MAX_STRING_SIZE - 1] = '\0';
+      strs[missed[j]] = rbuf;
+    }
+
+    free(rbuf);
+  }
+
+  {
+    self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                        "%llu tasks: fetched %lu distinct strings with %lu "
+                        "reads (%lu bytes) on %d thread(s) in %llu usec",
+                        n, (unsigned long)addrs.size(), (unsigned long)nreads,
+                        (unsigned long)nbytes, nthreads,
+                        (unsigned long long)(engine_stats_t::now_usec() -
+                                             begin_ts));
+  }
+
+  return true;
+}
+
 //! PRIVATE: linux_launchmon_t::acquire_proctable
 /*!
     acquires RPDTAB as well as the resource ID if available.
@@ -820,15 +1178,7 @@ bool linux_launchmon_t::acquire_proctable(
     //
     // fetching the RPDTAB size
     //
-    symbol_base_t<T_VA> debug_ps =
-        main_im->get_a_symbol(p.get_launch_proctable_size());
-
-    if (!debug_ps && p.get_myrmso_image()) {
-      debug_ps =
-          p.get_myrmso_image()->get_a_symbol(p.get_launch_proctable_size());
-    }
-
-    T_VA procsize_addr = debug_ps.get_relocated_address();
+    T_VA procsize_addr = get_mpir_addrs(p).proctable_size;
 
     get_tracer()->tracer_read(p, procsize_addr, &(local_pcount),
                               sizeof(local_pcount), use_cxt);
@@ -854,67 +1204,61 @@ bool linux_launchmon_t::acquire_proctable(
       return false;
     }
 
-    symbol_base_t<T_VA> debug_pt =
-        main_im->get_a_symbol(p.get_launch_proctable());
-    if (!debug_pt && p.get_myrmso_image()) {
-      debug_pt = p.get_myrmso_image()->get_a_symbol(p.get_launch_proctable());
-    }
-
-    T_VA proctable_addr = debug_pt.get_relocated_address();
+    T_VA proctable_addr = get_mpir_addrs(p).proctable;
     get_tracer()->tracer_read(p, proctable_addr, &proctable_loc,
                               sizeof(proctable_loc), use_cxt);
     get_tracer()->tracer_read(p, proctable_loc, launcher_proctable,
                               (sizeof(MPIR_PROCDESC) * get_pcount()), use_cxt);
 
     //
-    // fetching each proctable entry including strings pointed by
-    // C pointers.
+    // fetching all of the distinct strings pointed by C pointers
+    // of the entries with a few large reads.
     //
     maxcount = (unsigned long long)get_pcount();
-    for (i = 0; i < maxcount; ++i) {
-      MPIR_PROCDESC_EXT *an_entry =
-          (MPIR_PROCDESC_EXT *)malloc(sizeof(MPIR_PROCDESC_EXT));
+    std::vector<T_VA> str_addrs;
+    std::vector<std::string> strs;
+    if (!fetch_proctable_strings(p, use_cxt, launcher_proctable, maxcount,
+                                 str_addrs, strs)) {
+      free(launcher_proctable);
+      return false;
+    }
 
-      if (!an_entry) {
-        self_trace_t::trace(true, MODULENAME, 1, "Out of memory!");
+    //
+    // interning the distinct strings once and filling the per-task
+    // columns.
+    //
+    proctab_t &pt = get_proctable_copy();
+    std::vector<proctab_t::str_id_t> str_ids(strs.size());
+    size_t k;
 
-        return false;
-      }
+    pt.clear();
+    pt.reserve(maxcount);
+    for (k = 0; k < strs.size(); ++k) {
+      str_ids[k] = pt.intern(strs[k].c_str());
+    }
+
+    for (i = 0; i < maxcount; ++i) {
+      size_t hn = lower_bound(str_addrs.begin(), str_addrs.end(),
+                              (T_VA)launcher_proctable[i].host_name) -
+                  str_addrs.begin();
+      size_t en = lower_bound(str_addrs.begin(), str_addrs.end(),
+                              (T_VA)launcher_proctable[i].executable_name) -
+                  str_addrs.begin();
 
       //
-      // allocating storages for "an_entry"
+      // The mpi rank is the index into the global tab
       //
-      an_entry->pd.host_name = (char *)malloc(MAX_STRING_SIZE);
-      an_entry->pd.executable_name = (char *)malloc(MAX_STRING_SIZE);
 #if SUB_ARCH_BGQ
-      an_entry->cnodeid = launcher_proctable[i].pid;
+      pt.append(str_ids[hn], str_ids[en], (int)i, (int)i,
+                launcher_proctable[i].pid);
 #else
-      an_entry->pd.pid = launcher_proctable[i].pid;
-      an_entry->cnodeid = -1;
+      pt.append(str_ids[hn], str_ids[en], launcher_proctable[i].pid, (int)i,
+                -1);
 #endif
-      an_entry->mpirank = i; /* The mpi rank is the index into the global tab */
-
-#if SUB_ARCH_BGQ
-      an_entry->pd.pid = i; /* The mpi rank is the index into the global tab */
-#endif
-
-      //
-      // memory-fetching to get the "host_name"
-      //
-      get_tracer()->tracer_read_string(p, (T_VA)launcher_proctable[i].host_name,
-                                       (void *)(an_entry->pd.host_name),
-                                       MAX_STRING_SIZE, use_cxt);
-
-      //
-      // memory-fetching to get the "executable name"
-      //
-      get_tracer()->tracer_read_string(
-          p, (T_VA)launcher_proctable[i].executable_name,
-          (void *)an_entry->pd.executable_name, MAX_STRING_SIZE, use_cxt);
-
-      get_proctable_copy()[an_entry->pd.host_name].push_back(an_entry);
     }
 
+    pt.finalize();
+
     free(launcher_proctable);
 
     if (get_proctable_copy().empty()) {
@@ -1004,17 +1348,18 @@ bool linux_launchmon_t::disable_all_BPs(
     bool change_state) {
   try {
     tracer_base_t<SDBG_LINUX_DFLT_INSTANTIATION> *tr = get_tracer();
+    std::vector<breakpoint_base_t<T_VA, T_IT> *> bps;
 
     if (p.get_launch_hidden_bp()) {
-      tr->disable_breakpoint(p, *(p.get_launch_hidden_bp()), use_cxt,
-                             change_state);
+      bps.push_back(p.get_launch_hidden_bp());
     }
 
     if (p.get_loader_hidden_bp()) {
-      tr->disable_breakpoint(p, *(p.get_loader_hidden_bp()), use_cxt,
-                             change_state);
+      bps.push_back(p.get_loader_hidden_bp());
     }
 
+    tr->disable_breakpoints(p, bps, use_cxt, change_state);
+
     return true;
   } catch (symtab_exception_t e) {
     e.report();
@@ -1028,6 +1373,48 @@ bool linux_launchmon_t::disable_all_BPs(
   }
 }
 
+//!  PRIVATE: linux_launchmon_t::resolve_mpir_addr
+/*!
+     returns the relocated address of an MPIR variable or another
+     launcher symbol, looking in the RM SO when the launcher image
+     doesn't have it
+*/
+T_VA linux_launchmon_t::resolve_mpir_addr(
+    process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p, const std::string &sym) {
+  const symbol_base_t<T_VA> *var = &(p.get_myimage()->get_a_symbol(sym));
+
+  if (!(*var) && p.get_myrmso_image()) {
+    var = &(p.get_myrmso_image()->get_a_symbol(sym));
+  }
+
+  return (!(*var)) ? (T_VA)SYMTAB_UNINIT_ADDR : var->get_relocated_address();
+}
+
+//!  PRIVATE: linux_launchmon_t::get_mpir_addrs
+/*!
+     returns the MPIR variable addresses, resolving them on first
+     use. They are only kept once all of them are found and
+     relocated; handle_mpir_variables drops them whenever an image
+     that may define them gets (re)processed.
+*/
+const linux_launchmon_t::mpir_addrs_t &linux_launchmon_t::get_mpir_addrs(
+    process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p) {
+  if (!mpir_addrs.valid) {
+    mpir_addrs.debug_state = resolve_mpir_addr(p, p.get_launch_debug_state());
+    mpir_addrs.being_debug = resolve_mpir_addr(p, p.get_launch_being_debug());
+    mpir_addrs.proctable = resolve_mpir_addr(p, p.get_launch_proctable());
+    mpir_addrs.proctable_size =
+        resolve_mpir_addr(p, p.get_launch_proctable_size());
+    mpir_addrs.valid =
+        (mpir_addrs.debug_state != (T_VA)SYMTAB_UNINIT_ADDR &&
+         mpir_addrs.being_debug != (T_VA)SYMTAB_UNINIT_ADDR &&
+         mpir_addrs.proctable != (T_VA)SYMTAB_UNINIT_ADDR &&
+         mpir_addrs.proctable_size != (T_VA)SYMTAB_UNINIT_ADDR);
+  }
+
+  return mpir_addrs;
+}
+
 //!  PRIVATE: linux_launchmon_t::set_mpir_variables
 /*!
      set MPIR variables
@@ -1041,6 +1428,8 @@ bool linux_launchmon_t::handle_mpir_variables(
     T_VA debug_state_flag;
     int bdbg = 1;
 
+    mpir_addrs.valid = false;
+
     //
     // registering p.launch_hidden_bp
     //
@@ -1192,17 +1581,18 @@ bool linux_launchmon_t::enable_all_BPs(
     bool change_state) {
   try {
     tracer_base_t<SDBG_LINUX_DFLT_INSTANTIATION> *tr = get_tracer();
+    std::vector<breakpoint_base_t<T_VA, T_IT> *> bps;
 
     if (p.get_launch_hidden_bp()) {
-      tr->enable_breakpoint(p, *(p.get_launch_hidden_bp()), use_cxt,
-                            change_state);
+      bps.push_back(p.get_launch_hidden_bp());
     }
 
-    if (p.get_loader_hidden_bp()) {
-      tr->enable_breakpoint(p, *(p.get_loader_hidden_bp()), use_cxt,
-                            change_state);
+    if (p.get_loader_hidden_bp() && !p.get_loader_bp_retired()) {
+      bps.push_back(p.get_loader_hidden_bp());
     }
 
+    tr->enable_breakpoints(p, bps, use_cxt, change_state);
+
     return true;
   } catch (symtab_exception_t e) {
     e.report();
@@ -1216,11 +1606,126 @@ bool linux_launchmon_t::enable_all_BPs(
   }
 }
 
+//!  PRIVATE: linux_launchmon_t::dependent_SOs_found
+/*!
+     returns true once libc, libpthread and, if the RM needs it,
+     the RM SO have all been found in the link map. glibc 2.34 and
+     later have no separate libpthread: a libc that carries the
+     libthread_db data stands in for it.
+*/
+bool linux_launchmon_t::dependent_SOs_found(
+    process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p) {
+  image_base_t<T_VA, elf_wrapper> *thr_im = p.get_mythread_lib_image();
+  image_base_t<T_VA, elf_wrapper> *libc_im = p.get_mylibc_image();
+  image_base_t<T_VA, elf_wrapper> *rmso_im = p.get_myrmso_image();
+
+  return (thr_im && libc_im && rmso_im &&
+          (libc_im->get_image_base_address() != SYMTAB_UNINIT_ADDR) &&
+          ((thr_im->get_image_base_address() != SYMTAB_UNINIT_ADDR) ||
+           (libc_im->get_a_symbol(LIBC_NPTL_SYM).get_raw_address() !=
+            SYMTAB_UNINIT_ADDR)) &&
+          (!p.rmgr()->need_check_launcher_so() ||
+           rmso_im->get_image_base_address() != SYMTAB_UNINIT_ADDR));
+}
+
+//!  PRIVATE: linux_launchmon_t::retire_loader_bp
+/*!
+     pulls the loader breakpoint out of the RM process for good.
+     The breakpoint object is kept around so that a thread that
+     already trapped on it can still be recognized and rewound.
+*/
+bool linux_launchmon_t::retire_loader_bp(
+    process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p) {
+  bool use_cxt = true;
+
+  if (!p.get_loader_hidden_bp() || p.get_loader_bp_retired()) {
+    return false;
+  }
+
+  if (get_tracer()->disable_breakpoint(p, *(p.get_loader_hidden_bp()),
+                                      use_cxt) != SDBG_TRACE_OK) {
+    //
+    // The breakpoint isn't in, e.g. a prologue has it pulled out
+    // for a single-step; leave it to be retired on a later event.
+    //
+    return false;
+  }
+  p.set_loader_bp_retired(true);
+
+  {
+    self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                        "dependent libraries found; loader breakpoint "
+                        "retired.");
+  }
+
+  return true;
+}
+
+//!  PRIVATE: linux_launchmon_t::keep_thread_traced
+/*!
+     decides whether the new thread in the current context stays
+     traced. Unless LMON_ENGINE_THREAD_TRACE is set to selective,
+     all threads do. Otherwise, the RM config's RM_thread_trace
+     policy names the threads that can hit MPIR_Breakpoint: the main
+     thread only, or those whose start routine, which the thread
+     debug library reports, is listed. Detached threads must never
+     execute a breakpoint, so a thread is also kept while the loader
+     breakpoint is in and whenever its start routine is unknown.
+*/
+bool linux_launchmon_t::keep_thread_traced(
+    process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p) {
+  thread_trace_e policy = p.rmgr()->get_thread_trace();
+  int tid = p.get_cur_thread_ctx();
+  T_VA start;
+
+  if (!p.get_myopts()->get_my_opt()->selective_threads ||
+      policy == thr_trace_all || tid == p.get_master_thread_pid()) {
+    return true;
+  }
+
+  if (p.get_loader_hidden_bp() && !p.get_loader_bp_retired()) {
+    return true;
+  }
+
+  if (policy == thr_trace_main) {
+    return false;
+  }
+
+  if (kept_start_funcs.empty()) {
+    const std::vector<std::string> &funcs = p.rmgr()->get_thread_start_funcs();
+    std::vector<std::string>::const_iterator iter;
+
+    for (iter = funcs.begin(); iter != funcs.end(); ++iter) {
+      T_VA addr = resolve_mpir_addr(p, *iter);
+      if (addr != (T_VA)SYMTAB_UNINIT_ADDR) {
+        kept_start_funcs.insert(addr);
+      }
+    }
+
+    if (kept_start_funcs.empty()) {
+      return true;
+    }
+  }
+
+  if (!thread_db.get_start_func(p, get_tracer(), (lwpid_t)tid, start)) {
+    return true;
+  }
+
+  return (kept_start_funcs.find(start) != kept_start_funcs.end());
+}
+
 //!  PRIVATE: linux_launchmon_t::check_dependent_SOs
 /*!
      checks to see if libpthread is linked, and if so
      initializes the thread tracer
      Sep 13 2010, we now handle RM SO here as well.
+
+     The loader only ever appends to the link map, except when
+     it unloads objects. So the scan resumes from the last node
+     visited, and a pending dlclose (r_state RT_DELETE) or a tail
+     node whose l_name changed makes the next scan start over from
+     r_map. Once everything is found, the loader breakpoint is
+     retired.
 */
 bool linux_launchmon_t::check_dependent_SOs(
     process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p) {
@@ -1233,11 +1738,11 @@ bool linux_launchmon_t::check_dependent_SOs(
     image_base_t<T_VA, elf_wrapper> *thr_im;
     image_base_t<T_VA, elf_wrapper> *libc_im;
     image_base_t<T_VA, elf_wrapper> *rmso_im;
-    breakpoint_base_t<T_VA, T_IT> *frbp;
     T_VA where_to_read;
     struct r_debug r_debug_buf;
     struct link_map a_map;
     char lname[MAX_STRING_SIZE];
+    size_t nscanned = 0;
 
     thr_im = p.get_mythread_lib_image();
     libc_im = p.get_mylibc_image();
@@ -1252,15 +1757,14 @@ bool linux_launchmon_t::check_dependent_SOs(
       return false;
     }
 
-    if ((libc_im->get_image_base_address() != SYMTAB_UNINIT_ADDR) &&
-        (thr_im->get_image_base_address() != SYMTAB_UNINIT_ADDR) &&
-        (!p.rmgr()->need_check_launcher_so() ||
-         rmso_im->get_image_base_address() != SYMTAB_UNINIT_ADDR)) {
+    if (dependent_SOs_found(p)) {
       {
         self_trace_t::trace(LEVELCHK(level3), MODULENAME, 0,
                             "dependent libraries have been already found.");
       }
 
+      retire_loader_bp(p);
+
       return false;
     }
 
@@ -1275,20 +1779,34 @@ bool linux_launchmon_t::check_dependent_SOs(
 
     where_to_read = (T_VA)r_debug_buf.r_map;
 
-    do {
+    if (p.get_link_map_tail()) {
+      //
+      // Resume right after the tail unless it has been unlinked
+      // or reused since.
+      //
+      get_tracer()->tracer_read(p, p.get_link_map_tail(), &a_map,
+                                sizeof(struct link_map), use_cxt);
+      if ((T_VA)a_map.l_name == p.get_link_map_tail_name()) {
+        where_to_read = (T_VA)a_map.l_next;
+      }
+    }
+
+    while (where_to_read && where_to_read != T_UNINIT_HEX) {
       get_tracer()->tracer_read(p, where_to_read, &a_map,
                                 sizeof(struct link_map), use_cxt);
+      nscanned++;
+      p.set_link_map_tail(where_to_read);
+      p.set_link_map_tail_name((T_VA)a_map.l_name);
+
       if (a_map.l_name) {
         string slname;
-        char *cplname1, *cplname2, *dn, *bn;
+        const char *bn;
 
         get_tracer()->tracer_read_string(p, (T_VA)(a_map.l_name), lname,
                                          MAX_STRING_SIZE, use_cxt);
 
-        cplname1 = strdup(lname);
-        cplname2 = strdup(lname);
-        dn = dirname(cplname1);
-        bn = basename(cplname2);
+        bn = strrchr(lname, '/');
+        bn = bn ? bn + 1 : lname;
         slname = lname;
 
         if (strncmp(LIBPTHREAD_IDEN, bn, strlen(LIBPTHREAD_IDEN)) == 0) {
@@ -1346,14 +1864,28 @@ bool linux_launchmon_t::check_dependent_SOs(
             }
           }
         }
-
-        free(cplname1);
-        free(cplname2);
       }
 
       where_to_read = (T_VA)a_map.l_next;
+    }
 
-    } while (where_to_read && where_to_read != T_UNINIT_HEX);
+    if (r_debug_buf.r_state == r_debug::RT_DELETE) {
+      //
+      // objects are about to be unlinked; the tail may go away
+      //
+      p.set_link_map_tail(0);
+      p.set_link_map_tail_name(0);
+    }
+
+    {
+      self_trace_t::trace(LEVELCHK(level3), MODULENAME, 0,
+                          "scanned %lu new link map entries.",
+                          (unsigned long)nscanned);
+    }
+
+    if (dependent_SOs_found(p)) {
+      retire_loader_bp(p);
+    }
 
     return rc;
   } catch (symtab_exception_t e) {
@@ -1383,6 +1915,7 @@ linux_launchmon_t::linux_launchmon_t()
     : MODULENAME(
           self_trace_t::self_trace().launchmon_module_trace.module_name) {
   // more initialization here
+  mpir_addrs.valid = false;
 }
 
 //! PUBLIC:
@@ -1415,8 +1948,6 @@ launchmon_rc_e linux_launchmon_t::init(opts_args_t *opt) {
   //
   lrc = init_API(opt);
 
-  set_last_seen(gettimeofdayD());
-
   return lrc;
 }
 
@@ -1559,7 +2090,6 @@ launchmon_rc_e linux_launchmon_t::handle_attach_event(
     process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p) {
   try {
     get_tracer()->tracer_attach(p, false, -1);
-    set_last_seen(gettimeofdayD());
     return LAUNCHMON_OK;
   } catch (symtab_exception_t e) {
     e.report();
@@ -1729,12 +2259,7 @@ launchmon_rc_e linux_launchmon_t::handle_trap_after_attach_event(
         //
         //
         acquire_proctable(p, use_cxt);
-        ship_proctab_msg(lmonp_proctable_avail);
-        ship_resourcehandle_msg(lmonp_resourcehandle_avail, get_resid());
-        ship_rminfo_msg(lmonp_rminfo, (int)p.get_pid(false),
-                        p.rmgr()->get_resource_manager().get_rm());
-        say_fetofe_msg(lmonp_stop_at_first_attach);
-        launch_tool_daemons(p);
+        launch_and_ship_proctab(p, lmonp_stop_at_first_attach);
         get_tracer()->tracer_continue(p, use_cxt);
       }
     }
@@ -1758,8 +2283,6 @@ launchmon_rc_e linux_launchmon_t::handle_trap_after_attach_event(
           MODULENAME, 0, "Just continued the RM process out of the first trap");
     }
 
-    set_last_seen(gettimeofdayD());
-
     return LAUNCHMON_OK;
   } catch (symtab_exception_t e) {
     e.report();
@@ -1929,7 +2452,6 @@ launchmon_rc_e linux_launchmon_t::handle_trap_after_exec_event(
           MODULENAME, 0, "Just continued the RM process out of the first trap");
     }
 
-    set_last_seen(gettimeofdayD());
     return LAUNCHMON_OK;
   } catch (symtab_exception_t e) {
     e.report();
@@ -1984,24 +2506,11 @@ launchmon_rc_e linux_launchmon_t::handle_launch_bp_event(
     }
 
     //
-    // looking up MPIR_debug_state
+    // reading MPIR_debug_state
     //
-    symbol_base_t<T_VA> debug_state_var =
-        main_im->get_a_symbol(p.get_launch_debug_state());
-    if (!debug_state_var && p.get_myrmso_image()) {
-      debug_state_var =
-          p.get_myrmso_image()->get_a_symbol(p.get_launch_debug_state());
-    }
-
-    debug_state_addr = debug_state_var.get_relocated_address();
+    debug_state_addr = get_mpir_addrs(p).debug_state;
     get_tracer()->tracer_read(p, debug_state_addr, &bdbg, sizeof(bdbg),
                               use_cxt);
-    symbol_base_t<T_VA> debug_state =
-        main_im->get_a_symbol(p.get_launch_being_debug());
-    if (!debug_state && p.get_myrmso_image()) {
-      debug_state =
-          p.get_myrmso_image()->get_a_symbol(p.get_launch_being_debug());
-    }
 
 #if MEASURE_TRACING_COST
     endTS = gettimeofdayD();
@@ -2027,9 +2536,9 @@ launchmon_rc_e linux_launchmon_t::handle_launch_bp_event(
           //
           // Apparently, MPI tasks have just been spawned.
           //   We want to acquire RPDTAB and the resource ID,
-          //   and to pass those along to the FE client.
-          //   Subsequently, we want to launch the specified tool
-          //   daemons before let go of the RM process.
+          //   to launch the specified tool daemons and to pass
+          //   those along to the FE client while the daemons start
+          //   up, all before we let go of the RM process.
           //
           {
             self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
@@ -2037,13 +2546,7 @@ launchmon_rc_e linux_launchmon_t::handle_launch_bp_event(
                                 "completing with MPIR_DEBUG_SPAWNED");
           }
           acquire_proctable(p, use_cxt);
-          ship_proctab_msg(lmonp_proctable_avail);
-          ship_resourcehandle_msg(lmonp_resourcehandle_avail, get_resid());
-          ship_rminfo_msg(lmonp_rminfo, (int)p.get_pid(false),
-                          p.rmgr()->get_resource_manager().get_rm());
-          say_fetofe_msg(lmonp_stop_at_launch_bp_spawned);
-
-          launch_tool_daemons(p);
+          launch_and_ship_proctab(p, lmonp_stop_at_launch_bp_spawned);
 
           set_engine_state(bdbg);
 
@@ -2087,8 +2590,8 @@ launchmon_rc_e linux_launchmon_t::handle_launch_bp_event(
           // const symbol_base_t<T_VA>& being_debugged
           //  = p.get_myimage()->get_a_symbol (p.get_launch_being_debug());
 
-          get_tracer()->tracer_write(p, debug_state.get_relocated_address(),
-                                     &bdbg, sizeof(bdbg), true);
+          get_tracer()->tracer_write(p, get_mpir_addrs(p).being_debug, &bdbg,
+                                     sizeof(bdbg), true);
 
           //
           // detach from all slave threads.
@@ -2158,8 +2661,6 @@ launchmon_rc_e linux_launchmon_t::handle_launch_bp_event(
       }
     }
 
-    set_last_seen(gettimeofdayD());
-
     return lrc;
   } catch (symtab_exception_t e) {
     e.report();
@@ -2208,14 +2709,7 @@ launchmon_rc_e linux_launchmon_t::handle_detach_cmd_event(
     //
     // unsetting "MPIR_being_debugged."
     //
-    symbol_base_t<T_VA> being_debugged =
-        p.get_myimage()->get_a_symbol(p.get_launch_being_debug());
-    if (!being_debugged && p.get_myrmso_image()) {
-      being_debugged =
-          p.get_myrmso_image()->get_a_symbol(p.get_launch_being_debug());
-    }
-
-    get_tracer()->tracer_write(p, being_debugged.get_relocated_address(), &bdbg,
+    get_tracer()->tracer_write(p, get_mpir_addrs(p).being_debug, &bdbg,
                                sizeof(bdbg), false);
 
     //
@@ -2279,7 +2773,6 @@ launchmon_rc_e linux_launchmon_t::handle_detach_cmd_event(
     // but it should leave its children RM_daemon process
     // in a running state.
     //
-    set_last_seen(gettimeofdayD());
 
     return LAUNCHMON_STOP_TRACE;
   } catch (symtab_exception_t e) {
@@ -2330,15 +2823,7 @@ launchmon_rc_e linux_launchmon_t::handle_kill_cmd_event(
     //
     // unsetting MPIR_being_debugged.
     //
-    symbol_base_t<T_VA> debug_state =
-        p.get_myimage()->get_a_symbol(p.get_launch_being_debug());
-
-    if (!debug_state && p.get_myrmso_image()) {
-      debug_state =
-          p.get_myrmso_image()->get_a_symbol(p.get_launch_being_debug());
-    }
-
-    debug_state_flag = debug_state.get_relocated_address();
+    debug_state_flag = get_mpir_addrs(p).being_debug;
     get_tracer()->tracer_write(p, debug_state_flag, &bdbg, sizeof(bdbg), false);
 
     //
@@ -2396,7 +2881,6 @@ launchmon_rc_e linux_launchmon_t::handle_kill_cmd_event(
     // daemon should have gotten a kill command if supported
     // at this point.
     //
-    set_last_seen(gettimeofdayD());
 
     return LAUNCHMON_STOP_TRACE;
   } catch (symtab_exception_t e) {
@@ -2417,7 +2901,7 @@ launchmon_rc_e linux_launchmon_t::handle_kill_cmd_event(
     the debugger its DSO load/unload, this handler gets
     invoked, fetching some information (e.g. the base link map for
     the pthread library.) Once it gleans all necessary info, it
-    stops poking the link map to optimize the perf.
+    retires the loader breakpoint altogether.
 */
 launchmon_rc_e linux_launchmon_t::handle_loader_bp_event(
     process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p) {
@@ -2430,6 +2914,29 @@ launchmon_rc_e linux_launchmon_t::handle_loader_bp_event(
 
     bool use_cxt = true;
 
+    if (p.get_loader_bp_retired()) {
+      //
+      // A thread trapped on the loader breakpoint before it was
+      // retired. The original instruction is back in place, so
+      // rewind the thread to re-execute it, but only if its pc sits
+      // right past the trap; any other stop must be left alone.
+      //
+      breakpoint_base_t<T_VA, T_IT> *bp = p.get_loader_hidden_bp();
+      get_tracer()->tracer_getregs(p, use_cxt);
+      if (p.get_gprset(use_cxt)->get_pc() == bp->get_where_pc_would_be()) {
+        p.get_gprset(use_cxt)->set_pc(bp->get_address_at());
+        get_tracer()->tracer_setregs(p, use_cxt);
+      }
+      get_tracer()->tracer_continue(p, use_cxt);
+
+#if MEASURE_TRACING_COST
+      endTS = gettimeofdayD();
+      accum += endTS - beginTS;
+      countHandler++;
+#endif
+      return LAUNCHMON_OK;
+    }
+
     if (!(is_bp_prologue_done(p, p.get_loader_hidden_bp()))) {
 #if MEASURE_TRACING_COST
       endTS = gettimeofdayD();
@@ -2459,8 +2966,6 @@ launchmon_rc_e linux_launchmon_t::handle_loader_bp_event(
     countHandler++;
 #endif
 
-    set_last_seen(gettimeofdayD());
-
     return LAUNCHMON_OK;
   } catch (symtab_exception_t e) {
     e.report();
@@ -2513,7 +3018,6 @@ launchmon_rc_e linux_launchmon_t::handle_newproc_forked_event(
     countHandler++;
 #endif
 
-    set_last_seen(gettimeofdayD());
     return LAUNCHMON_OK;
   } catch (symtab_exception_t e) {
     e.report();
@@ -2591,7 +3095,6 @@ launchmon_rc_e linux_launchmon_t::handle_exit_event(
     countHandler++;
 #endif
 
-    set_last_seen(gettimeofdayD());
     return rc;
   } catch (symtab_exception_t e) {
     e.report();
@@ -2637,8 +3140,6 @@ launchmon_rc_e linux_launchmon_t::handle_term_event(
   countHandler++;
 #endif
 
-  set_last_seen(gettimeofdayD());
-
   return LAUNCHMON_OK;
 }
 
@@ -2676,8 +3177,6 @@ launchmon_rc_e linux_launchmon_t::handle_thrcreate_request(
       p.get_thrlist().insert(make_pair(tinfo.ti_lid, thrinfo));
     }
 
-    set_last_seen(gettimeofdayD());
-
     return LAUNCHMON_OK;
   } catch (symtab_exception_t e) {
     e.report();
@@ -2718,7 +3217,6 @@ launchmon_rc_e linux_launchmon_t::handle_thrcreate_trap_event(
     handle_thrcreate_request(p, (int)newlwpid);
 
     get_tracer()->tracer_continue(p, use_cxt);
-    set_last_seen(gettimeofdayD());
 
     return LAUNCHMON_OK;
   } catch (symtab_exception_t e) {
@@ -2752,6 +3250,23 @@ launchmon_rc_e linux_launchmon_t::handle_newthread_trace_event(
                           "irrelevant stop event handler invoked");
     }
 
+    if (!keep_thread_traced(p)) {
+      int tid = p.get_cur_thread_ctx();
+
+      get_tracer()->tracer_detach(p, use_cxt);
+      delete p.get_thrlist()[tid];
+      p.get_thrlist().erase(tid);
+      engine_stats_t::stats().count_thread_detached();
+
+      {
+        self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                            "thread %d is not traced per RM_thread_trace.",
+                            tid);
+      }
+
+      return LAUNCHMON_OK;
+    }
+
     get_tracer()->tracer_setoptions(p, use_cxt, -1);
     p.get_thrlist()[p.get_cur_thread_ctx()]->set_traced(true);
     // cout << "[" << p.get_cur_thread_ctx() << "]" << endl;
@@ -2768,8 +3283,6 @@ launchmon_rc_e linux_launchmon_t::handle_newthread_trace_event(
     countHandler++;
 #endif
 
-    set_last_seen(gettimeofdayD());
-
     return LAUNCHMON_OK;
   } catch (symtab_exception_t e) {
     e.report();
@@ -2817,8 +3330,6 @@ launchmon_rc_e linux_launchmon_t::handle_not_interested_event(
     countHandler++;
 #endif
 
-    set_last_seen(gettimeofdayD());
-
     return LAUNCHMON_OK;
   } catch (symtab_exception_t e) {
     e.report();
@@ -2869,7 +3380,6 @@ launchmon_rc_e linux_launchmon_t::handle_relay_signal_event(
     countHandler++;
 #endif
 
-    set_last_seen(gettimeofdayD());
     return LAUNCHMON_OK;
   } catch (symtab_exception_t e) {
     e.report();
@@ -42,11 +42,14 @@
 #ifndef SDBG_LINUX_LAUNCHMON_HXX
 #define SDBG_LINUX_LAUNCHMON_HXX 1
 
+#include <set>
+#include <string>
 #include <vector>
 #include "lmon_api/lmon_proctab.h"
 #include "sdbg_base_launchmon.hxx"
 #include "sdbg_linux_mach.hxx"
 #include "sdbg_linux_std.hxx"
+#include "sdbg_linux_thread_db.hxx"
 
 //! class linux_launchmon_t<>
 /*!
@@ -121,6 +124,25 @@ class linux_launchmon_t
   //
   linux_launchmon_t(const linux_launchmon_t &l);
 
+  //! struct mpir_addrs_t
+  /*!
+      relocated addresses of the MPIR variables, resolved once
+      so that launch breakpoint hits need no symbol lookups
+  */
+  struct mpir_addrs_t {
+    bool valid;
+    T_VA debug_state;
+    T_VA being_debug;
+    T_VA proctable;
+    T_VA proctable_size;
+  };
+
+  T_VA resolve_mpir_addr(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
+                         const std::string &sym);
+
+  const mpir_addrs_t &get_mpir_addrs(
+      process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p);
+
   launchmon_rc_e handle_bp_prologue(
       process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
       breakpoint_base_t<T_VA, T_IT> *bp);
@@ -134,16 +156,31 @@ class linux_launchmon_t
   bool enable_all_BPs(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
                       bool use_context, bool change_state = true);
 
+  bool dependent_SOs_found(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p);
+
+  bool retire_loader_bp(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p);
+
   bool check_dependent_SOs(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p);
 
+  bool keep_thread_traced(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p);
+
   bool continue_on_attach(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
                           bool);
 
+  bool fetch_proctable_strings(
+      process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p, bool use_cxt,
+      const MPIR_PROCDESC *tab, unsigned long long n,
+      std::vector<T_VA> &addrs, std::vector<std::string> &strs);
+
   bool acquire_proctable(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
                          bool);
 
   bool launch_tool_daemons(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p);
 
+  bool launch_and_ship_proctab(
+      process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
+      lmonp_fe_to_fe_msg_e stop_msg);
+
   bool handle_mpir_variables(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
                              image_base_t<T_VA, elf_wrapper> &i);
 
@@ -165,6 +202,15 @@ class linux_launchmon_t
   // For self tracing
   //
   std::string MODULENAME;
+
+  mpir_addrs_t mpir_addrs;
+
+  // For the selective thread tracing: the thread debug library
+  // and the addresses of the start routines of the launcher
+  // threads the RM config keeps traced
+  //
+  linux_thread_db_t thread_db;
+  std::set<T_VA> kept_start_funcs;
 };
 
 #endif  // SDBG_LINUX_LAUNCHMON_HXX
@@ -103,6 +103,7 @@ linux_x86_gpr_set_t::linux_x86_gpr_set_t()
   gpr_writable_mask |= (1 << 12);
 
   gpr_writable_mask |= (1 << 16);  // rip (program counter) is writable
+  gpr_writable_mask |= (1 << 19);  // rsp, for emulate_bp_insn
 
 #endif /* X86_64_ARCHITECTURE */
 
@@ -186,6 +187,80 @@ void linux_x86_gpr_set_t::set_pc(T_VA addr) {
 #endif
 }
 
+//! PUBLIC: linux_x86_gpr_set_t
+/*!
+    emulate_bp_insn: steps over the instructions that typically
+    sit at the entry of the functions launchmon plants breakpoints
+    on (e.g., MPIR_Breakpoint and _dl_debug_state), so that a
+    breakpoint hit needs no single-step: endbr64, nop, push of a
+    general purpose register, mov %rsp,%rbp and ret. Only
+    supported on x86-64.
+*/
+bool linux_x86_gpr_set_t::emulate_bp_insn(T_VA at, const unsigned char* insn,
+                                          size_t len, T_VA ret_addr,
+                                          T_VA& store_addr, T_WT* store,
+                                          int& nstore) {
+#if X86_64_ARCHITECTURE
+  //
+  // in the order of the register numbers in the opcodes
+  //
+  T_WT regs[16] = {rs.rax, rs.rcx, rs.rdx, rs.rbx, rs.rsp, rs.rbp,
+                   rs.rsi, rs.rdi, rs.r8,  rs.r9,  rs.r10, rs.r11,
+                   rs.r12, rs.r13, rs.r14, rs.r15};
+  size_t ilen = 0;
+
+  nstore = 0;
+
+  if (len >= 4 && insn[0] == 0xf3 && insn[1] == 0x0f && insn[2] == 0x1e &&
+      insn[3] == 0xfa) {
+    // endbr64
+    ilen = 4;
+  } else if (len >= 1 && insn[0] == 0x90) {
+    // nop
+    ilen = 1;
+  } else if (len >= 2 && insn[0] == 0x66 && insn[1] == 0x90) {
+    // xchg %ax,%ax
+    ilen = 2;
+  } else if (len >= 5 && insn[0] == 0x0f && insn[1] == 0x1f &&
+             insn[2] == 0x44 && insn[3] == 0x00 && insn[4] == 0x00) {
+    // nopl 0x0(%rax,%rax,1)
+    ilen = 5;
+  } else if (len >= 1 && (insn[0] & 0xf8) == 0x50) {
+    // push %r
+    store[nstore++] = regs[insn[0] & 0x7];
+    ilen = 1;
+  } else if (len >= 2 && insn[0] == 0x41 && (insn[1] & 0xf8) == 0x50) {
+    // push %r8-%r15
+    store[nstore++] = regs[8 + (insn[1] & 0x7)];
+    ilen = 2;
+  } else if (len >= 3 && insn[0] == 0x48 && insn[1] == 0x89 &&
+             insn[2] == 0xe5) {
+    // mov %rsp,%rbp
+    rs.rbp = rs.rsp;
+    ilen = 3;
+  } else if ((len >= 1 && insn[0] == 0xc3) ||
+             (len >= 2 && (insn[0] == 0xf3 || insn[0] == 0xf2) &&
+              insn[1] == 0xc3)) {
+    // ret, repz ret and bnd ret
+    rs.rsp += sizeof(T_VA);
+    rs.rip = ret_addr;
+    return true;
+  } else {
+    return false;
+  }
+
+  if (nstore) {
+    rs.rsp -= sizeof(T_WT);
+    store_addr = rs.rsp;
+  }
+  rs.rip = at + ilen;
+
+  return true;
+#else
+  return false;
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////
 //
 // PUBLIC INTERFACES (class linux_x86_fpr_set_t)
@@ -1022,6 +1097,82 @@ const T_VA linux_aarch64_gpr_set_t::get_memloc_for_ret_addr() const {
 */
 void linux_aarch64_gpr_set_t::set_pc(T_VA addr) { rs.pc = addr; }
 
+//! PUBLIC: linux_aarch64_gpr_set_t
+/*!
+    emulate_bp_insn: steps over the instructions that typically
+    sit at the entry of the functions launchmon plants breakpoints
+    on, so that a breakpoint hit needs no single-step: nop, bti,
+    stp of a register pair with pre-index writeback, mov from sp
+    and ret. Pointer authentication instructions are left to
+    single-stepping.
+*/
+bool linux_aarch64_gpr_set_t::emulate_bp_insn(T_VA at,
+                                              const unsigned char* insn,
+                                              size_t len, T_VA ret_addr,
+                                              T_VA& store_addr, T_WT* store,
+                                              int& nstore) {
+  uint32_t i;
+
+  if (len < sizeof(i)) {
+    return false;
+  }
+
+  memcpy(&i, insn, sizeof(i));
+  nstore = 0;
+
+  if (i == 0xd503201f || (i & 0xffffff3f) == 0xd503241f) {
+    // nop and bti {c, j, jc}
+  } else if ((i & 0xfffffc1f) == 0xd65f0000) {
+    // ret Xn
+    rs.pc = rs.regs[(i >> 5) & 0x1f];
+    return true;
+  } else if ((i & 0xffffffe0) == 0x910003e0 && (i & 0x1f) != 31) {
+    // mov Xd, sp
+    rs.regs[i & 0x1f] = rs.sp;
+  } else if ((i & 0xffc00000) == 0xa9800000) {
+    // stp Xt1, Xt2, [Xn|sp, #imm]!
+    unsigned int rt = i & 0x1f;
+    unsigned int rn = (i >> 5) & 0x1f;
+    unsigned int rt2 = (i >> 10) & 0x1f;
+    int32_t imm7 = (int32_t)((i >> 15) & 0x7f);
+    T_VA base;
+
+    if (imm7 & 0x40) {
+      imm7 -= 0x80;
+    }
+
+    if (rn == 31) {
+      base = rs.sp;
+      if (base & 0xf) {
+        // let the hardware raise the alignment fault
+        return false;
+      }
+    } else {
+      base = rs.regs[rn];
+      if (rn == rt || rn == rt2) {
+        // unpredictable writeback
+        return false;
+      }
+    }
+
+    store_addr = base + (T_VA)((int64_t)imm7 * 8);
+    store[nstore++] = (rt == 31) ? 0 : rs.regs[rt];
+    store[nstore++] = (rt2 == 31) ? 0 : rs.regs[rt2];
+
+    if (rn == 31) {
+      rs.sp = store_addr;
+    } else {
+      rs.regs[rn] = store_addr;
+    }
+  } else {
+    return false;
+  }
+
+  rs.pc = at + sizeof(i);
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////
 //
 // PUBLIC INTERFACES (class linux_aarch64_fpr_set_t)
@@ -45,6 +45,7 @@ extern "C" {
 
 #include <string>
 #include "sdbg_base_mach.hxx"
+#include "sdbg_base_tracer.hxx"
 #include "sdbg_linux_std.hxx"
 #include "sdbg_linux_symtab.hxx"
 #include "sdbg_std.hxx"
@@ -173,6 +174,9 @@ class linux_x86_gpr_set_t : public register_set_base_t<T_GRS, T_VA, T_WT> {
   virtual T_VA const get_pc() const;
   virtual T_VA const get_ret_addr() const;
   virtual T_VA const get_memloc_for_ret_addr() const;
+  virtual bool emulate_bp_insn(T_VA at, const unsigned char* insn, size_t len,
+                               T_VA ret_addr, T_VA& store_addr, T_WT* store,
+                               int& nstore);
 
  private:
   bool LEVELCHK(self_trace_verbosity level) {
@@ -353,6 +357,7 @@ class linux_x86_process_t
 //
 struct ps_prochandle {
   process_base_t<SDBG_LINUX_DFLT_INSTANTIATION>* p;
+  tracer_base_t<SDBG_LINUX_DFLT_INSTANTIATION>* tracer;
 };
 
 #elif AARCH64_ARCHITECTURE
@@ -395,6 +400,9 @@ class linux_aarch64_gpr_set_t : public register_set_base_t<T_GRS, T_VA, T_WT> {
   virtual T_VA const get_pc() const;
   virtual T_VA const get_ret_addr() const;
   virtual T_VA const get_memloc_for_ret_addr() const;
+  virtual bool emulate_bp_insn(T_VA at, const unsigned char* insn, size_t len,
+                               T_VA ret_addr, T_VA& store_addr, T_WT* store,
+                               int& nstore);
 
  private:
   bool LEVELCHK(self_trace_verbosity level) {
@@ -514,6 +522,7 @@ class linux_aarch64_process_t
 //
 struct ps_prochandle {
   process_base_t<SDBG_LINUX_DFLT_INSTANTIATION>* p;
+  tracer_base_t<SDBG_LINUX_DFLT_INSTANTIATION>* tracer;
 };
 
 #elif PPC_ARCHITECTURE
@@ -732,6 +741,7 @@ class linux_ppc_process_t
 //
 struct ps_prochandle {
   process_base_t<SDBG_LINUX_DFLT_INSTANTIATION>* p;
+  tracer_base_t<SDBG_LINUX_DFLT_INSTANTIATION>* tracer;
 };
 
 #endif  // ARCHITECTURES
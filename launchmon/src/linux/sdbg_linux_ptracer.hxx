@@ -66,11 +66,35 @@ extern "C" {
 #endif
 }
 
+#include <map>
+#include <set>
+#include <vector>
 #include "sdbg_base_tracer.hxx"
 #include "sdbg_self_trace.hxx"
 
 const int LINUX_TRACER_EVENT_CLONE = PTRACE_EVENT_CLONE;
 
+//
+// reads of up to MaxCachedReadPages pages go through the per-stop
+// page cache, which holds up to MaxCachedPages pages per thread
+//
+const size_t MaxCachedReadPages = 2;
+const size_t MaxCachedPages = 64;
+
+//! enumerator linux_read_method_e
+/*!
+    Defines the backends that linux_ptracer_t can use to read
+    the memory of a traced process. The backend is chosen once per
+    traced pid: process_vm_readv first, then pread on /proc/<pid>/mem,
+    and PTRACE_PEEKDATA only if neither of the bulk methods works.
+*/
+enum linux_read_method_e {
+  LINUX_READ_UNKNOWN = 0,
+  LINUX_READ_VM_READV,
+  LINUX_READ_PROC_MEM,
+  LINUX_READ_PEEKDATA
+};
+
 //! class linux_tracer_exception_t : public tracer_exception_t
 /*!
 
@@ -121,7 +145,7 @@ class linux_ptracer_t : public tracer_base_t<SDBG_DEFAULT_TEMPLPARAM> {
  public:
   linux_ptracer_t();
   linux_ptracer_t(const linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM> &p);
-  virtual ~linux_ptracer_t() {}
+  virtual ~linux_ptracer_t();
 
   ////////////////////////////////////////////////////////////
   //
@@ -159,6 +183,11 @@ class linux_ptracer_t : public tracer_base_t<SDBG_DEFAULT_TEMPLPARAM> {
       process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p, VA addr, const void *buf,
       int size, bool use_cxt) throw(linux_tracer_exception_t);
 
+  virtual tracer_error_e tracer_write_batch(
+      process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p,
+      const std::vector<tracer_patch_t<VA> > &patches,
+      bool use_cxt) throw(linux_tracer_exception_t);
+
   virtual tracer_error_e tracer_continue(
       process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p,
       bool use_cxt) throw(linux_tracer_exception_t);
@@ -210,6 +239,16 @@ class linux_ptracer_t : public tracer_base_t<SDBG_DEFAULT_TEMPLPARAM> {
       process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p, breakpoint_base_t<VA, IT> &bp,
       bool use_cxt, bool change_state = true) throw(linux_tracer_exception_t);
 
+  virtual tracer_error_e enable_breakpoints(
+      process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p,
+      std::vector<breakpoint_base_t<VA, IT> *> &bps, bool use_cxt,
+      bool change_state = true) throw(linux_tracer_exception_t);
+
+  virtual tracer_error_e disable_breakpoints(
+      process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p,
+      std::vector<breakpoint_base_t<VA, IT> *> &bps, bool use_cxt,
+      bool change_state = true) throw(linux_tracer_exception_t);
+
   virtual tracer_error_e convert_error_code(int err) throw(
       linux_tracer_exception_t);
 
@@ -224,6 +263,60 @@ class linux_ptracer_t : public tracer_base_t<SDBG_DEFAULT_TEMPLPARAM> {
 
   long Pptrace(__ptrace_request request, pid_t pid, void *addr, void *data);
 
+  linux_read_method_e select_read_method(pid_t pid);
+  linux_read_method_e set_read_method(pid_t pid, linux_read_method_e m);
+
+  bool bulk_read(pid_t pid, VA addr, void *buf, size_t size);
+
+  bool bulk_read_string(pid_t pid, VA addr, void *buf, size_t size);
+
+  size_t bulk_write(pid_t pid, const std::vector<tracer_patch_t<VA> > &patches,
+                    size_t first);
+
+  bool on_ro_page(pid_t pid, VA addr, size_t size);
+
+  VA prepare_trap(process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p,
+                  breakpoint_base_t<VA, IT> &bp, bool use_cxt,
+                  IT &blend) throw(linux_tracer_exception_t);
+
+  VA patch_address(breakpoint_base_t<VA, IT> &bp);
+
+  void release_read_method(pid_t pid);
+
+  const char *read_method_str(linux_read_method_e m);
+
+  int cache_mode(process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p);
+
+  void fetch_regs(register_set_base_t<GRS, VA, WT> *regset,
+                  pid_t tpid) throw(linux_tracer_exception_t);
+
+  void read_uncached(pid_t tpid, VA addr, void *buf,
+                     int size) throw(linux_tracer_exception_t);
+
+  bool read_cached(pid_t tpid, VA addr, void *buf, size_t size);
+
+  void invalidate_stop_cache(pid_t tpid);
+
+  void invalidate_pages(VA addr, size_t size);
+
+  // Per-pid memory read backend and the open /proc/<pid>/mem
+  // descriptors when that backend is selected
+  //
+  std::map<pid_t, linux_read_method_e> read_methods;
+  std::map<pid_t, int> proc_mem_fds;
+
+  // Pages of each pid that process_vm_writev failed to write, i.e.,
+  // read-only text; batched writes to them go to PTRACE_POKEDATA
+  //
+  std::map<pid_t, std::set<VA> > ro_pages;
+
+  // Per-stop caches: the general purpose registers of each stopped
+  // thread and the pages read through it, valid until a thread is
+  // resumed or they are written
+  //
+  std::map<pid_t, GRS> regs_cache;
+  std::map<pid_t, std::map<VA, std::vector<char> > > page_cache;
+
   // For self tracing
   //
   std::string MODULENAME;
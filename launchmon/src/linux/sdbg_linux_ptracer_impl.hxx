@@ -55,6 +55,8 @@ extern "C" {
 
 #include <elf.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <signal.h>
 #include <sys/ptrace.h>
 #include <sys/types.h>
@@ -66,6 +68,7 @@ extern "C" {
 
 #include <fstream>
 #include <sstream>
+#include "sdbg_engine_stats.hxx"
 #include "sdbg_linux_ptracer.hxx"
 
 ////////////////////////////////////////////////////////////////////
@@ -88,6 +91,21 @@ linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::linux_ptracer_t(
   MODULENAME = pt.MODULENAME;
 }
 
+//! PUBLIC: ~linux_ptracer_t()
+/*!
+    linux_ptracer_t destructor: closes /proc/<pid>/mem descriptors
+    that are still open.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::~linux_ptracer_t() {
+  std::map<pid_t, int>::iterator iter;
+  for (iter = proc_mem_fds.begin(); iter != proc_mem_fds.end(); ++iter) {
+    close(iter->second);
+  }
+  proc_mem_fds.clear();
+  read_methods.clear();
+}
+
 //! PUBLIC: tracer_setregs
 /*!
     Methods that sets the general register set
@@ -113,6 +131,12 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_setregs(
 
   regset->set_ptr_to_regset();
 
+  //
+  // The kernel may not take every value as written, so the
+  // registers are fetched afresh next time
+  //
+  regs_cache.erase(tpid);
+
 #if AARCH64_ARCHITECTURE
 
   struct iovec iov;
@@ -166,8 +190,10 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_setregs(
 //! PUBLIC: tracer_getregs
 /*!
     It returns the general register set through
-    the process_base_t object. This method can throw
-    an exception of linux_tracer_exception_t type.
+    the process_base_t object. The registers of a thread are
+    fetched once per stop and served from the stop cache until the
+    thread is resumed or its registers are set. This method can
+    throw an exception of linux_tracer_exception_t type.
 */
 template <SDBG_DEFAULT_TEMPLATE_WIDTH>
 tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_getregs(
@@ -178,6 +204,7 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_getregs(
   string e;
   string func = "[linux_ptracer_t::tracer_getregs]";
   pid_t tpid = p.get_pid(use_cxt);
+  int mode = cache_mode(p);
 
   register_set_base_t<GRS, VA, WT>* regset = p.get_gprset(use_cxt);
 
@@ -186,47 +213,39 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_getregs(
     throw linux_tracer_exception_t(e, SDBG_TRACE_FAILED);
   }
 
-  regset->set_ptr_to_regset();
-
-#if AARCH64_ARCHITECTURE
-
-  struct iovec iov;
-  int ret;
+  typename map<pid_t, GRS>::iterator iter = regs_cache.find(tpid);
+
+  if (mode && iter != regs_cache.end()) {
+    engine_stats_t::stats().count_regs_cache(true);
+
+    if (mode > 1) {
+      fetch_regs(regset, tpid);
+      if (memcmp(&(regset->get_native_rs()), &(iter->second), sizeof(GRS)) !=
+          0) {
+        engine_stats_t::stats().count_cache_incoherent();
+        self_trace_t::trace(true, MODULENAME, 0,
+                            "stale registers cached for thread %d", tpid);
+        iter->second = regset->get_native_rs();
+      }
+      return SDBG_TRACE_OK;
+    }
 
-  iov.iov_base = (void*)regset->get_rs_ptr();
-  iov.iov_len = regset->size();
+    regset->set_ptr_to_regset();
+    memcpy((void*)regset->get_rs_ptr(), &(iter->second), sizeof(GRS));
 
-  // Read all general purpose registers in one go
-  ret = Pptrace(PTRACE_GETREGSET, tpid, (void*)NT_PRSTATUS, (void*)&iov);
-  if (ret < 0) {
-    e = func + ERRMSG_PTRACE + strerror(errno);
-    throw linux_tracer_exception_t(e, convert_error_code(errno));
+    return SDBG_TRACE_OK;
   }
 
-#else
+  fetch_regs(regset, tpid);
 
-  WT r;
-  VA offset = regset->get_offset_in_user();
-  unsigned int num_regs = regset->size_in_word();
-  unsigned int i;
-
-  for (i = 0; i < num_regs; i++) {
-    r = Pptrace(PTRACE_PEEKUSER, tpid, (void*)offset, NULL);
-
-    if (errno) {
-      e = func + ERRMSG_PTRACE + strerror(errno);
-      throw linux_tracer_exception_t(e, convert_error_code(errno));
-    }
-
-    regset->write_word_to_ptr(r);
-    regset->inc_ptr_by_word();
-    offset += sizeof(WT);
+  if (mode) {
+    engine_stats_t::stats().count_regs_cache(false);
+    regs_cache[tpid] = regset->get_native_rs();
   }
-#endif
 
   return SDBG_TRACE_OK;
 
-}  // tracer_error_e linux_ptracer_t::tracer_getfpregs
+}  // tracer_error_e linux_ptracer_t::tracer_getregs
 
 //! PUBLIC: tracer_getfpregs
 /*!
@@ -310,45 +329,38 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_setfpregs(
 //! PUBLIC: tracer_read
 /*!
     It reads from the target process, starting from vaddr. It fills
-    buf upto whatever the size in buf argument tells to do.
+    buf upto whatever the size in buf argument tells to do. Reads
+    of up to MaxCachedReadPages pages are served from the pages
+    cached for the stopped thread, which are fetched as a whole on
+    first use.
 */
 template <SDBG_DEFAULT_TEMPLATE_WIDTH>
 tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_read(
     process_base_t<SDBG_DEFAULT_TEMPLPARAM>& p, VA addr, void* buf, int size,
     bool use_cxt) throw(linux_tracer_exception_t) {
-  using namespace std;
-
-  WT r;
-  string e;
-  string func = "[linux_ptracer_t::tracer_read]";
+  static const size_t pgsz = (size_t)sysconf(_SC_PAGESIZE);
   pid_t tpid = p.get_pid(use_cxt);
-  VA addr_trav = addr;
-  VA trav_end = addr + size;
-  WT* buf_trav = (WT*)buf;
-
-  for (addr_trav = addr; (addr_trav + sizeof(WT)) <= trav_end;
-       addr_trav += sizeof(WT)) {
-    r = Pptrace(PTRACE_PEEKDATA, tpid, (void*)addr_trav, 0);
-
-    if (r == -1 && errno != 0) {
-      e = func + ERRMSG_PTRACE + strerror(errno);
-      throw linux_tracer_exception_t(e, convert_error_code(errno));
+  int mode = cache_mode(p);
+
+  if (mode && size > 0 && (size_t)size <= MaxCachedReadPages * pgsz &&
+      read_cached(tpid, addr, buf, (size_t)size)) {
+    if (mode > 1) {
+      std::vector<char> fresh(size);
+
+      read_uncached(tpid, addr, &fresh[0], size);
+      if (memcmp(&fresh[0], buf, size) != 0) {
+        engine_stats_t::stats().count_cache_incoherent();
+        self_trace_t::trace(true, MODULENAME, 0,
+                            "stale memory cached for thread %d at 0x%lx",
+                            tpid, (unsigned long)addr);
+        invalidate_pages(addr, (size_t)size);
+        memcpy(buf, &fresh[0], size);
+      }
     }
-
-    (*buf_trav) = r;
-    buf_trav++;
+    return SDBG_TRACE_OK;
   }
 
-  if (addr_trav != trav_end) {
-    r = Pptrace(PTRACE_PEEKDATA, tpid, (void*)addr_trav, 0);
-
-    if (r == -1 && errno != 0) {
-      e = func + ERRMSG_PTRACE + strerror(errno);
-      throw linux_tracer_exception_t(e, convert_error_code(errno));
-    }
-
-    memcpy((void*)buf_trav, (void*)&r, trav_end - addr_trav);
-  }
+  read_uncached(tpid, addr, buf, size);
 
   return SDBG_TRACE_OK;
 
@@ -376,6 +388,10 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_read_string(
   WT* buf_trav = (WT*)buf;
   bool end_of_string = false;
 
+  if (size > 0 && bulk_read_string(tpid, addr, buf, (size_t)size)) {
+    return SDBG_TRACE_OK;
+  }
+
   for (addr_trav = addr; (addr_trav + sizeof(WT)) <= trav_end;
        addr_trav += sizeof(WT)) {
     r = Pptrace(PTRACE_PEEKDATA, tpid, (void*)addr_trav, 0);
@@ -462,6 +478,10 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_write(
   VA trav_end = addr + size;
   WT* buf_trav = (WT*)buf;
 
+  if (size > 0) {
+    invalidate_pages(addr, (size_t)size);
+  }
+
   for (addr_trav = addr; (addr_trav + sizeof(WT)) <= trav_end;
        addr_trav += sizeof(WT)) {
     r = Pptrace(PTRACE_POKEDATA, tpid, (void*)addr_trav, (void*)*buf_trav);
@@ -495,6 +515,56 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_write(
 
 }  // linux_ptracer_t::tracer_write
 
+//! PUBLIC: tracer_write_batch
+/*!
+    Method that applies a list of non-overlapping patches to a thread
+    or a process. Patches are written with as few process_vm_writev
+    calls as possible; the ones it cannot write, which are mostly
+    those on read-only text pages, go through tracer_write.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_write_batch(
+    process_base_t<SDBG_DEFAULT_TEMPLPARAM>& p,
+    const std::vector<tracer_patch_t<VA> >& patches,
+    bool use_cxt) throw(linux_tracer_exception_t) {
+  pid_t tpid = p.get_pid(use_cxt);
+  std::vector<tracer_patch_t<VA> > bulk;
+  std::vector<tracer_patch_t<VA> > poke;
+  typename std::vector<tracer_patch_t<VA> >::const_iterator iter;
+  size_t i = 0;
+
+  for (iter = patches.begin(); iter != patches.end(); ++iter) {
+    if (iter->size == 0) continue;
+
+    invalidate_pages(iter->addr, iter->size);
+    if (on_ro_page(tpid, iter->addr, iter->size)) {
+      poke.push_back(*iter);
+    } else {
+      bulk.push_back(*iter);
+    }
+  }
+
+  while (i < bulk.size()) {
+    if ((i = bulk_write(tpid, bulk, i)) < bulk.size()) {
+      poke.push_back(bulk[i]);
+      i++;
+    }
+  }
+
+  for (iter = poke.begin(); iter != poke.end(); ++iter) {
+    tracer_write(p, iter->addr, iter->buf, (int)iter->size, use_cxt);
+  }
+
+  {
+    self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                        "batched %d patches to pid %d, %d through ptrace",
+                        (int)patches.size(), tpid, (int)poke.size());
+  }
+
+  return SDBG_TRACE_OK;
+
+}  // linux_ptracer_t::tracer_write_batch
+
 //! PUBLIC: tracer_continue
 /*!
     Method that continues a thread or a process
@@ -511,6 +581,8 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_continue(
   pid_t tpid = p.get_pid(use_cxt);
   errno = 0;
 
+  invalidate_stop_cache(tpid);
+
   if ((r = Pptrace(PTRACE_CONT, tpid, 0, 0)) != 0) {
     e = func + ERRMSG_PTRACE + strerror(errno);
     throw linux_tracer_exception_t(e, convert_error_code(errno));
@@ -541,6 +613,8 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_deliver_signal(
   pid_t tpid = p.get_pid(use_cxt);
   VA s = (VA)sig;
 
+  invalidate_stop_cache(tpid);
+
   if ((r = Pptrace(PTRACE_CONT, tpid, 0, (void*)s)) != 0) {
     e = func + ERRMSG_PTRACE + strerror(errno);
     throw linux_tracer_exception_t(e, convert_error_code(errno));
@@ -599,6 +673,8 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_kill(
   string func = "[linux_ptracer_t::tracer_kill]";
   pid_t tpid = p.get_pid(use_cxt);
 
+  invalidate_stop_cache(tpid);
+
   if ((r = Pptrace(PTRACE_KILL, tpid, 0, 0)) != 0) {
     e = func + ERRMSG_PTRACE + strerror(errno);
     throw linux_tracer_exception_t(e, convert_error_code(errno));
@@ -626,6 +702,8 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_singlestep(
   string func = "[linux_ptracer_t::tracer_singlestep]";
   pid_t tpid = p.get_pid(use_cxt);
 
+  invalidate_stop_cache(tpid);
+
   if ((r = Pptrace(PTRACE_SINGLESTEP, tpid, 0, 0)) != 0) {
     e = func + ERRMSG_PTRACE + strerror(errno);
     throw linux_tracer_exception_t(e, convert_error_code(errno));
@@ -657,6 +735,8 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_syscall(
   string func = "[linux_ptracer_t::tracer_syscall]";
   pid_t tpid = p.get_pid(use_cxt);
 
+  invalidate_stop_cache(tpid);
+
   if ((r = Pptrace(PTRACE_SYSCALL, tpid, 0, 0)) != 0) {
     e = func + ERRMSG_PTRACE + strerror(errno);
     throw linux_tracer_exception_t(e, convert_error_code(errno));
@@ -687,6 +767,10 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_detach(
   string func = "[linux_ptracer_t::tracer_detach]";
   pid_t tpid = p.get_pid(use_cxt);
 
+  release_read_method(tpid);
+  invalidate_stop_cache(tpid);
+  ro_pages.erase(tpid);
+
   if ((r = Pptrace(PTRACE_DETACH, tpid, 0, 0)) != 0) {
     errno = 0;
     return SDBG_TRACE_FAILED;
@@ -794,6 +878,12 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::tracer_attach(
     who_to_attach_to = newtid;
   }
 
+  //
+  // a recycled thread id must not inherit a stale cache
+  //
+  regs_cache.erase(who_to_attach_to);
+  page_cache.erase(who_to_attach_to);
+
   if ((r = Pptrace(PTRACE_ATTACH, who_to_attach_to, 0, 0)) != 0) {
     {
       self_trace_t::trace(true, MODULENAME, 0,
@@ -890,39 +980,14 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::enable_breakpoint(
     process_base_t<SDBG_DEFAULT_TEMPLPARAM>& p, breakpoint_base_t<VA, IT>& bp,
     bool use_cxt, bool change_state) throw(linux_tracer_exception_t) {
   IT blend;
-  IT origInst;
+  VA at;
 
   if (!(bp.is_set() || bp.is_disabled())) {
     return SDBG_TRACE_STATE_UNKNOWN;
   }
 
-  if (bp.get_use_indirection()) {
-    if (bp.get_indirect_address_at() == T_UNINIT_HEX) {
-      //
-      // The upper layer could have filled the
-      // indirect address to handle special cases.
-      //
-      VA indAddr;
-      tracer_read(p, bp.get_address_at(), &indAddr, sizeof(VA), use_cxt);
-      bp.set_indirect_address_at(indAddr);
-    }
-
-    tracer_read(p, bp.get_indirect_address_at(), &origInst, sizeof(IT),
-                use_cxt);
-  } else {
-    tracer_read(p, bp.get_address_at(), &origInst, sizeof(IT), use_cxt);
-  }
-
-  bp.set_orig_instruction(origInst);
-  blend = bp.get_orig_instruction();
-  blend &= bp.get_blend_mask();
-  blend = blend | bp.get_trap_instruction();
-
-  if (bp.get_use_indirection()) {
-    tracer_write(p, bp.get_indirect_address_at(), &blend, sizeof(IT), use_cxt);
-  } else {
-    tracer_write(p, bp.get_address_at(), &blend, sizeof(IT), use_cxt);
-  }
+  at = prepare_trap(p, bp, use_cxt, blend);
+  tracer_write(p, at, &blend, sizeof(IT), use_cxt);
 
   //
   // BP state transitioned to enabled
@@ -949,13 +1014,7 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::disable_breakpoint(
   }
 
   origInst = bp.get_orig_instruction();
-
-  if (bp.get_use_indirection()) {
-    tracer_write(p, bp.get_indirect_address_at(), &origInst, sizeof(IT),
-                 use_cxt);
-  } else {
-    tracer_write(p, bp.get_address_at(), &origInst, sizeof(IT), use_cxt);
-  }
+  tracer_write(p, patch_address(bp), &origInst, sizeof(IT), use_cxt);
 
   //
   // BP state transitioned to disabled
@@ -966,6 +1025,97 @@ tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::disable_breakpoint(
 
 }  // linux_ptracer_t::disable_breakpoint
 
+//! PUBLIC: enable_breakpoints
+/*!
+  enable_breakpoint for each of bps, with all the trap instructions
+  inserted by one batched write. Breakpoints that cannot be enabled
+  are skipped and make it return SDBG_TRACE_STATE_UNKNOWN.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::enable_breakpoints(
+    process_base_t<SDBG_DEFAULT_TEMPLPARAM>& p,
+    std::vector<breakpoint_base_t<VA, IT>*>& bps, bool use_cxt,
+    bool change_state) throw(linux_tracer_exception_t) {
+  std::vector<breakpoint_base_t<VA, IT>*> armed;
+  std::vector<tracer_patch_t<VA> > patches;
+  std::vector<IT> blends(bps.size());
+  tracer_error_e rc = SDBG_TRACE_OK;
+  size_t i;
+
+  for (i = 0; i < bps.size(); ++i) {
+    breakpoint_base_t<VA, IT>& bp = *(bps[i]);
+
+    if (!(bp.is_set() || bp.is_disabled())) {
+      rc = SDBG_TRACE_STATE_UNKNOWN;
+      continue;
+    }
+
+    tracer_patch_t<VA> patch;
+    patch.addr = prepare_trap(p, bp, use_cxt, blends[i]);
+    patch.buf = &blends[i];
+    patch.size = sizeof(IT);
+    patches.push_back(patch);
+    armed.push_back(&bp);
+  }
+
+  tracer_write_batch(p, patches, use_cxt);
+
+  if (change_state) {
+    for (i = 0; i < armed.size(); ++i) {
+      armed[i]->enable();
+    }
+  }
+
+  return rc;
+
+}  // linux_ptracer_t::enable_breakpoints
+
+//! PUBLIC: disable_breakpoints
+/*!
+  disable_breakpoint for each of bps, with all the original
+  instructions restored by one batched write. Breakpoints that are
+  not enabled are skipped and make it return SDBG_TRACE_STATE_UNKNOWN.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+tracer_error_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::disable_breakpoints(
+    process_base_t<SDBG_DEFAULT_TEMPLPARAM>& p,
+    std::vector<breakpoint_base_t<VA, IT>*>& bps, bool use_cxt,
+    bool change_state) throw(linux_tracer_exception_t) {
+  std::vector<breakpoint_base_t<VA, IT>*> armed;
+  std::vector<tracer_patch_t<VA> > patches;
+  std::vector<IT> origs(bps.size());
+  tracer_error_e rc = SDBG_TRACE_OK;
+  size_t i;
+
+  for (i = 0; i < bps.size(); ++i) {
+    breakpoint_base_t<VA, IT>& bp = *(bps[i]);
+
+    if (!bp.is_enabled()) {
+      rc = SDBG_TRACE_STATE_UNKNOWN;
+      continue;
+    }
+
+    tracer_patch_t<VA> patch;
+    origs[i] = bp.get_orig_instruction();
+    patch.addr = patch_address(bp);
+    patch.buf = &origs[i];
+    patch.size = sizeof(IT);
+    patches.push_back(patch);
+    armed.push_back(&bp);
+  }
+
+  tracer_write_batch(p, patches, use_cxt);
+
+  if (change_state) {
+    for (i = 0; i < armed.size(); ++i) {
+      armed[i]->disable();
+    }
+  }
+
+  return rc;
+
+}  // linux_ptracer_t::disable_breakpoints
+
 //! PUBLIC: convert_error_code
 /*!
 
@@ -1046,9 +1196,544 @@ long linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::Pptrace(__ptrace_request request,
                         request, pid, addr);
   }
 
+  engine_stats_t::stats().count_ptrace();
+  if (request == PTRACE_PEEKDATA || request == PTRACE_PEEKTEXT)
+    engine_stats_t::stats().count_peek(sizeof(long));
+  else if (request == PTRACE_POKEDATA || request == PTRACE_POKETEXT)
+    engine_stats_t::stats().count_poke(sizeof(long));
+
   return (ptrace(request, pid, addr, data));
 }
 
+//! PRIVATE: select_read_method
+/*!
+    returns the memory read backend of pid. On the first read from pid,
+    process_vm_readv is chosen if it is available; otherwise,
+    /proc/<pid>/mem. Backends that turn out not to work for this
+    pid are demoted by bulk_read.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+linux_read_method_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::select_read_method(
+    pid_t pid) {
+  std::map<pid_t, linux_read_method_e>::iterator iter = read_methods.find(pid);
+
+  if (iter != read_methods.end()) {
+    return iter->second;
+  }
+
+#if HAVE_PROCESS_VM_READV
+  return set_read_method(pid, LINUX_READ_VM_READV);
+#else
+  return set_read_method(pid, LINUX_READ_PROC_MEM);
+#endif
+}
+
+//! PRIVATE: set_read_method
+/*!
+    makes m the read backend of pid. For /proc/<pid>/mem, the file
+    is opened here and PTRACE_PEEKDATA is used instead if that fails.
+    Returns the backend actually chosen.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+linux_read_method_e linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::set_read_method(
+    pid_t pid, linux_read_method_e m) {
+  release_read_method(pid);
+
+  if (m == LINUX_READ_PROC_MEM) {
+    char memfile[PATH_MAX];
+    int fd;
+
+    snprintf(memfile, PATH_MAX, "/proc/%d/mem", pid);
+    if ((fd = open(memfile, O_RDONLY | O_CLOEXEC)) < 0) {
+      m = LINUX_READ_PEEKDATA;
+    } else {
+      proc_mem_fds[pid] = fd;
+    }
+  }
+
+  read_methods[pid] = m;
+
+  {
+    self_trace_t::trace(LEVELCHK(level1), MODULENAME, 0,
+                        "memory reads from pid %d use %s", pid,
+                        read_method_str(m));
+  }
+
+  errno = 0;
+  return m;
+}
+
+//! PRIVATE: bulk_read
+/*!
+    reads size bytes at addr of pid with one system call using the
+    backend selected for pid. Returns false if the range could not be
+    read in full; the caller should then use PTRACE_PEEKDATA which
+    also produces the precise error for bad addresses.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+bool linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::bulk_read(pid_t pid, VA addr,
+                                                         void* buf,
+                                                         size_t size) {
+  ssize_t n;
+  linux_read_method_e m;
+
+  while ((m = select_read_method(pid)) != LINUX_READ_PEEKDATA) {
+    if (m == LINUX_READ_VM_READV) {
+#if HAVE_PROCESS_VM_READV
+      struct iovec local;
+      struct iovec remote;
+
+      local.iov_base = buf;
+      local.iov_len = size;
+      remote.iov_base = (void*)addr;
+      remote.iov_len = size;
+
+      n = process_vm_readv(pid, &local, 1, &remote, 1, 0);
+      engine_stats_t::stats().count_mem_read((n > 0) ? (size_t)n : 0);
+      if (n == (ssize_t)size) {
+        return true;
+      }
+
+      if (n < 0 && (errno == EPERM || errno == ENOSYS)) {
+        //
+        // e.g., a kernel without CMA or a security policy
+        // that denies it. Try /proc/<pid>/mem next.
+        //
+        self_trace_t::trace(LEVELCHK(level1), MODULENAME, 0,
+                            "process_vm_readv on pid %d failed: %s", pid,
+                            strerror(errno));
+        set_read_method(pid, LINUX_READ_PROC_MEM);
+        continue;
+      }
+#endif
+      break;
+    } else if (m == LINUX_READ_PROC_MEM) {
+      n = pread(proc_mem_fds[pid], buf, size, (off_t)addr);
+      engine_stats_t::stats().count_mem_read((n > 0) ? (size_t)n : 0);
+      if (n == (ssize_t)size) {
+        return true;
+      }
+
+      if (n < 0 && (errno == EACCES || errno == EPERM)) {
+        self_trace_t::trace(LEVELCHK(level1), MODULENAME, 0,
+                            "reading /proc/%d/mem failed: %s", pid,
+                            strerror(errno));
+        set_read_method(pid, LINUX_READ_PEEKDATA);
+        continue;
+      }
+      break;
+    } else {
+      break;
+    }
+  }
+
+  //
+  // EFAULT, EIO or a short read: the range touches memory that is
+  // not mapped. Leave it to the word-at-a-time path.
+  //
+  errno = 0;
+  return false;
+}
+
+//! PRIVATE: bulk_read_string
+/*!
+    reads a NULL-terminated string at addr of pid into buf, up to
+    size bytes. Reads are split at page boundaries so that a string
+    ending right before an unmapped page can still be fetched, and it
+    stops at the first page chunk that contains the terminator.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+bool linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::bulk_read_string(pid_t pid,
+                                                                VA addr,
+                                                                void* buf,
+                                                                size_t size) {
+  static const VA pgsz = (VA)sysconf(_SC_PAGESIZE);
+  char* dst = (char*)buf;
+  VA cur = addr;
+  size_t left = size;
+
+  while (left > 0) {
+    size_t chunk = (size_t)(pgsz - (cur % pgsz));
+    if (chunk > left) chunk = left;
+
+    if (!bulk_read(pid, cur, dst, chunk)) {
+      return false;
+    }
+
+    if (memchr(dst, '\0', chunk)) {
+      break;
+    }
+
+    dst += chunk;
+    cur += chunk;
+    left -= chunk;
+  }
+
+  return true;
+}
+
+//! PRIVATE: bulk_write
+/*!
+    writes patches[first], patches[first + 1], ... to pid with one
+    process_vm_writev call, which is used whenever process_vm_readv
+    works for pid. Returns the index of the first patch that was not
+    written, patches.size() if all were. process_vm_writev does not
+    write read-only pages, unlike PTRACE_POKEDATA; the page of the
+    patch it stopped at is remembered so that later batches leave
+    that page to the caller right away.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+size_t linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::bulk_write(
+    pid_t pid, const std::vector<tracer_patch_t<VA> >& patches, size_t first) {
+#if HAVE_PROCESS_VM_WRITEV
+  static const VA pgsz = (VA)sysconf(_SC_PAGESIZE);
+  std::vector<struct iovec> local;
+  std::vector<struct iovec> remote;
+  size_t i, done, total = 0;
+  ssize_t n;
+
+  if (select_read_method(pid) != LINUX_READ_VM_READV) {
+    return first;
+  }
+
+  for (i = first; i < patches.size() && local.size() < (size_t)IOV_MAX; ++i) {
+    struct iovec iov;
+
+    iov.iov_base = (void*)patches[i].buf;
+    iov.iov_len = patches[i].size;
+    local.push_back(iov);
+    iov.iov_base = (void*)patches[i].addr;
+    remote.push_back(iov);
+    total += patches[i].size;
+  }
+
+  n = process_vm_writev(pid, &local[0], local.size(), &remote[0],
+                        remote.size(), 0);
+  engine_stats_t::stats().count_mem_write((n > 0) ? (size_t)n : 0);
+  if (n == (ssize_t)total) {
+    return i;
+  }
+
+  if (n < 0 && (errno == EPERM || errno == ENOSYS)) {
+    self_trace_t::trace(LEVELCHK(level1), MODULENAME, 0,
+                        "process_vm_writev on pid %d failed: %s", pid,
+                        strerror(errno));
+    set_read_method(pid, LINUX_READ_PROC_MEM);
+    return first;
+  }
+
+  //
+  // Transfers stop at the first iovec element that cannot be
+  // written in full.
+  //
+  done = (n > 0) ? (size_t)n : 0;
+  for (i = first; done >= patches[i].size; ++i) {
+    done -= patches[i].size;
+  }
+
+  ro_pages[pid].insert(patches[i].addr - (patches[i].addr % pgsz));
+  errno = 0;
+
+  return i;
+#else
+  return first;
+#endif
+}
+
+//! PRIVATE: on_ro_page
+/*!
+    returns true if [addr, addr + size) of pid touches a page that
+    bulk_write failed to write before
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+bool linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::on_ro_page(pid_t pid, VA addr,
+                                                          size_t size) {
+  static const VA pgsz = (VA)sysconf(_SC_PAGESIZE);
+  typename std::map<pid_t, std::set<VA> >::iterator iter = ro_pages.find(pid);
+  VA last = addr + size - 1;
+
+  if (iter == ro_pages.end()) {
+    return false;
+  }
+
+  return (iter->second.count(addr - (addr % pgsz)) != 0 ||
+          iter->second.count(last - (last % pgsz)) != 0);
+}
+
+//! PRIVATE: prepare_trap
+/*!
+    saves the original instruction under bp and computes the trap
+    instruction blended into it. Returns the address to write the
+    trap instruction to.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+VA linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::prepare_trap(
+    process_base_t<SDBG_DEFAULT_TEMPLPARAM>& p, breakpoint_base_t<VA, IT>& bp,
+    bool use_cxt, IT& blend) throw(linux_tracer_exception_t) {
+  IT origInst;
+
+  if (bp.get_use_indirection()) {
+    if (bp.get_indirect_address_at() == T_UNINIT_HEX) {
+      //
+      // The upper layer could have filled the
+      // indirect address to handle special cases.
+      //
+      VA indAddr;
+      tracer_read(p, bp.get_address_at(), &indAddr, sizeof(VA), use_cxt);
+      bp.set_indirect_address_at(indAddr);
+    }
+  }
+
+  tracer_read(p, patch_address(bp), &origInst, sizeof(IT), use_cxt);
+
+  bp.set_orig_instruction(origInst);
+  blend = bp.get_orig_instruction();
+  blend &= bp.get_blend_mask();
+  blend = blend | bp.get_trap_instruction();
+
+  return patch_address(bp);
+}
+
+//! PRIVATE: patch_address
+/*!
+    returns the address at which bp's trap instruction goes
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+VA linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::patch_address(
+    breakpoint_base_t<VA, IT>& bp) {
+  return bp.get_use_indirection() ? bp.get_indirect_address_at()
+                                  : bp.get_address_at();
+}
+
+//! PRIVATE: release_read_method
+/*!
+    forgets the read backend of pid and closes its /proc/<pid>/mem
+    descriptor if one is open. Called when we detach from pid.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+void linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::release_read_method(pid_t pid) {
+  std::map<pid_t, int>::iterator iter = proc_mem_fds.find(pid);
+
+  if (iter != proc_mem_fds.end()) {
+    close(iter->second);
+    proc_mem_fds.erase(iter);
+  }
+
+  read_methods.erase(pid);
+}
+
+//! PRIVATE: read_method_str
+/*!
+    returns a printable name of a read backend for self tracing.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+const char* linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::read_method_str(
+    linux_read_method_e m) {
+  switch (m) {
+    case LINUX_READ_VM_READV:
+      return "process_vm_readv";
+    case LINUX_READ_PROC_MEM:
+      return "/proc/<pid>/mem";
+    case LINUX_READ_PEEKDATA:
+      return "PTRACE_PEEKDATA";
+    default:
+      break;
+  }
+
+  return "unknown";
+}
+
+//! PRIVATE: cache_mode
+/*!
+    returns the per-stop cache mode chosen by the engine options:
+    0 for off, 1 for on and 2 for on with every hit verified.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+int linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::cache_mode(
+    process_base_t<SDBG_DEFAULT_TEMPLPARAM>& p) {
+  opts_args_t* o = p.get_myopts();
+
+  return (o && o->get_my_opt()) ? o->get_my_opt()->tracer_cache : 1;
+}
+
+//! PRIVATE: fetch_regs
+/*!
+    reads the general register set of tpid into regset
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+void linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::fetch_regs(
+    register_set_base_t<GRS, VA, WT>* regset,
+    pid_t tpid) throw(linux_tracer_exception_t) {
+  using namespace std;
+
+  string e;
+  string func = "[linux_ptracer_t::tracer_getregs]";
+
+  regset->set_ptr_to_regset();
+
+#if AARCH64_ARCHITECTURE
+
+  struct iovec iov;
+  int ret;
+
+  iov.iov_base = (void*)regset->get_rs_ptr();
+  iov.iov_len = regset->size();
+
+  // Read all general purpose registers in one go
+  ret = Pptrace(PTRACE_GETREGSET, tpid, (void*)NT_PRSTATUS, (void*)&iov);
+  if (ret < 0) {
+    e = func + ERRMSG_PTRACE + strerror(errno);
+    throw linux_tracer_exception_t(e, convert_error_code(errno));
+  }
+
+#else
+
+  WT r;
+  VA offset = regset->get_offset_in_user();
+  unsigned int num_regs = regset->size_in_word();
+  unsigned int i;
+
+  for (i = 0; i < num_regs; i++) {
+    r = Pptrace(PTRACE_PEEKUSER, tpid, (void*)offset, NULL);
+
+    if (errno) {
+      e = func + ERRMSG_PTRACE + strerror(errno);
+      throw linux_tracer_exception_t(e, convert_error_code(errno));
+    }
+
+    regset->write_word_to_ptr(r);
+    regset->inc_ptr_by_word();
+    offset += sizeof(WT);
+  }
+#endif
+}
+
+//! PRIVATE: read_uncached
+/*!
+    reads size bytes at addr of tpid with a single bulk read if
+    possible and a word at a time otherwise
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+void linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::read_uncached(
+    pid_t tpid, VA addr, void* buf, int size) throw(linux_tracer_exception_t) {
+  using namespace std;
+
+  WT r;
+  string e;
+  string func = "[linux_ptracer_t::tracer_read]";
+  VA addr_trav = addr;
+  VA trav_end = addr + size;
+  WT* buf_trav = (WT*)buf;
+
+  //
+  // Try to fetch the whole range with a single bulk read. Only if that
+  // is not possible, fall back to reading a word at a time.
+  //
+  if (size > 0 && bulk_read(tpid, addr, buf, (size_t)size)) {
+    return;
+  }
+
+  for (addr_trav = addr; (addr_trav + sizeof(WT)) <= trav_end;
+       addr_trav += sizeof(WT)) {
+    r = Pptrace(PTRACE_PEEKDATA, tpid, (void*)addr_trav, 0);
+
+    if (r == -1 && errno != 0) {
+      e = func + ERRMSG_PTRACE + strerror(errno);
+      throw linux_tracer_exception_t(e, convert_error_code(errno));
+    }
+
+    (*buf_trav) = r;
+    buf_trav++;
+  }
+
+  if (addr_trav != trav_end) {
+    r = Pptrace(PTRACE_PEEKDATA, tpid, (void*)addr_trav, 0);
+
+    if (r == -1 && errno != 0) {
+      e = func + ERRMSG_PTRACE + strerror(errno);
+      throw linux_tracer_exception_t(e, convert_error_code(errno));
+    }
+
+    memcpy((void*)buf_trav, (void*)&r, trav_end - addr_trav);
+  }
+}
+
+//! PRIVATE: read_cached
+/*!
+    copies size bytes at addr of tpid out of the pages cached for
+    tpid, fetching the missing ones. Returns false, leaving the
+    read to read_uncached, if a page cannot be fetched in full.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+bool linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::read_cached(pid_t tpid, VA addr,
+                                                           void* buf,
+                                                           size_t size) {
+  static const VA pgsz = (VA)sysconf(_SC_PAGESIZE);
+  std::map<VA, std::vector<char> >& pages = page_cache[tpid];
+  typename std::map<VA, std::vector<char> >::iterator iter;
+  char* dst = (char*)buf;
+  VA cur = addr;
+  VA end = addr + size;
+  bool hit = true;
+
+  while (cur < end) {
+    VA pg = cur - (cur % pgsz);
+    VA upto = (pg + pgsz < end) ? pg + pgsz : end;
+
+    if ((iter = pages.find(pg)) == pages.end()) {
+      std::vector<char> page(pgsz);
+
+      if (!bulk_read(tpid, pg, &page[0], (size_t)pgsz)) {
+        return false;
+      }
+      if (pages.size() >= MaxCachedPages) {
+        pages.clear();
+      }
+      iter = pages.insert(std::make_pair(pg, page)).first;
+      hit = false;
+    }
+
+    memcpy(dst, &(iter->second[cur - pg]), upto - cur);
+    dst += upto - cur;
+    cur = upto;
+  }
+
+  engine_stats_t::stats().count_mem_cache(hit);
+
+  return true;
+}
+
+//! PRIVATE: invalidate_stop_cache
+/*!
+    called as tpid is resumed: its registers are no longer valid,
+    and neither is memory, which it shares with the other threads
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+void linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::invalidate_stop_cache(
+    pid_t tpid) {
+  regs_cache.erase(tpid);
+  page_cache.clear();
+}
+
+//! PRIVATE: invalidate_pages
+/*!
+    drops the cached pages that overlap [addr, addr + size)
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+void linux_ptracer_t<SDBG_DEFAULT_TEMPLPARAM>::invalidate_pages(VA addr,
+                                                                size_t size) {
+  static const VA pgsz = (VA)sysconf(_SC_PAGESIZE);
+  typename std::map<pid_t, std::map<VA, std::vector<char> > >::iterator iter;
+  VA first = addr - (addr % pgsz);
+  VA pg;
+
+  for (iter = page_cache.begin(); iter != page_cache.end(); ++iter) {
+    for (pg = first; pg < addr + size; pg += pgsz) {
+      iter->second.erase(pg);
+    }
+  }
+}
+
 #endif  // __SDBG_LINUX_PTRACER_IMPL_HXX
 
 /*
@@ -136,6 +136,7 @@ const char *const LOADER_R_DEBUG = "_r_debug";
 const char *const LOADER_START = "_start";
 const char *const LIBC_IDEN = "libc.";
 const char *const LIBPTHREAD_IDEN = "libpthread.";
+const char *const LIBC_NPTL_SYM = "_thread_db_sizeof_pthread";
 const char *const RESOURCE_HANDLER_SYM = "totalview_jobid";
 const char *const ERRMSG_PTRACE = " error returned from ptrace ";
 const char *const ERRMSG_KILL = " error returned from kill ";
@@ -143,6 +144,7 @@ const char *const LIBTHREAD_DB = "libthread_db.so.1";
 
 const int MAX_LIB_PATH = 128;
 const int MAX_STRING_SIZE = 1024;
+const int MAX_STRING_FETCH_RANGE = 1048576;
 const int BPCHAINMAX = 128;
 
 //! my_thrinfo_t
@@ -45,6 +45,7 @@
 #define SDBG_LINUX_SYMTAB_HXX 1
 
 #include "sdbg_base_symtab.hxx"
+#include "sdbg_linux_elfsym.hxx"
 #include "sdbg_std.hxx"
 
 extern "C" {
@@ -55,6 +56,7 @@ extern "C" {
 #endif
 }
 
+
 #define LINUX_SYMTAB_TEMPLATELIST typename VA
 #define LINUX_SYMTAB_TEMPLPARAM VA
 #define LINUX_IMAGE_TEMPLATELIST typename VA
@@ -184,6 +186,8 @@ class linux_image_t : public image_base_t<VA, elf_wrapper> {
 
   virtual symtab_error_e init() throw(symtab_exception_t);
   virtual symtab_error_e read_linkage_symbols() throw(symtab_exception_t);
+  virtual symbol_base_t<VA>* lookup_linkage_symbol(
+      const std::string& key) const;
   virtual symtab_error_e fetch_DSO_info(std::string&,
                                         bool&) throw(symtab_exception_t);
   // virtual symtab_error_e read_debug_symbols() = 0;
@@ -206,6 +210,9 @@ class linux_image_t : public image_base_t<VA, elf_wrapper> {
   // For self tracing
   //
   std::string MODULENAME;
+
+  elf_symbol_resolver_t* resolver;
+  elf_symbol_cache_t* symcache;
 };
 
 #endif  // SDBG_LINUX_SYMTAB_HXX
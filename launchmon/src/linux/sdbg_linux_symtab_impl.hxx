@@ -71,6 +71,7 @@ extern "C" {
 #include <limits.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 }
 
 #include "sdbg_linux_std.hxx"
@@ -331,13 +332,15 @@ symtab_error_e elf_wrapper::finalize() {
 */
 template <LINUX_IMAGE_TEMPLATELIST>
 linux_image_t<LINUX_IMAGE_TEMPLPARAM>::linux_image_t()
-    : image_base_t<LINUX_IMAGE_TEMPLPARAM, elf_wrapper>() {
+    : image_base_t<LINUX_IMAGE_TEMPLPARAM, elf_wrapper>(), resolver(NULL),
+      symcache(NULL) {
   MODULENAME = self_trace_t::self_trace().symtab_module_trace.module_name;
 }
 
 template <LINUX_IMAGE_TEMPLATELIST>
 linux_image_t<LINUX_IMAGE_TEMPLPARAM>::linux_image_t(const std::string& lib)
-    : image_base_t<LINUX_IMAGE_TEMPLPARAM, elf_wrapper>(lib) {
+    : image_base_t<LINUX_IMAGE_TEMPLPARAM, elf_wrapper>(lib), resolver(NULL),
+      symcache(NULL) {
   MODULENAME =
       self_trace_t::self_trace().self_trace().symtab_module_trace.module_name;
 }
@@ -345,23 +348,30 @@ linux_image_t<LINUX_IMAGE_TEMPLPARAM>::linux_image_t(const std::string& lib)
 template <LINUX_IMAGE_TEMPLATELIST>
 linux_image_t<LINUX_IMAGE_TEMPLPARAM>::linux_image_t(
     const image_base_t<VA, elf_wrapper>& im)
-    : image_base_t<LINUX_IMAGE_TEMPLPARAM, elf_wrapper>(im) {
+    : image_base_t<LINUX_IMAGE_TEMPLPARAM, elf_wrapper>(im), resolver(NULL),
+      symcache(NULL) {
   MODULENAME = im.MODULENAME;
 }
 
 template <LINUX_IMAGE_TEMPLATELIST>
-linux_image_t<LINUX_IMAGE_TEMPLPARAM>::~linux_image_t() {}
+linux_image_t<LINUX_IMAGE_TEMPLPARAM>::~linux_image_t() {
+  if (resolver) delete resolver;
+  if (symcache) delete symcache;
+}
 
 //! PUBLIC: init
 /*!
-
+    checks that the image is readable and opens its entry in the
+    persistent symbol cache. Opening the entry maps the image just
+    long enough to read its section headers and build-id, which
+    key it; the symbol index is only built when a lookup misses
+    the cache, and libelf is only brought in by fetch_DSO_info.
 */
 template <LINUX_IMAGE_TEMPLATELIST>
 symtab_error_e linux_image_t<LINUX_IMAGE_TEMPLPARAM>::init() throw(
     symtab_exception_t) {
   using namespace std;
 
-  elf_wrapper* elfw;
   string e;
   string func = "[linux_image_t::init]";
 
@@ -370,21 +380,30 @@ symtab_error_e linux_image_t<LINUX_IMAGE_TEMPLPARAM>::init() throw(
     throw symtab_exception_t(e, SDBG_SYMTAB_FAILED);
   }
 
-  elfw = new elf_wrapper(get_path());
-
-  if (elfw->init() != SDBG_SYMTAB_OK) {
-    e = func + " ELF library init failed.";
+  if (access(get_path().c_str(), R_OK) != 0) {
+    e = func + " couldn't open executable " + get_path();
     throw symtab_exception_t(e, SDBG_SYMTAB_FAILED);
   }
-  set_native_exec_handler(elfw);
+
+  if (!resolver) {
+    resolver = new elf_symbol_resolver_t();
+  }
+  resolver->finalize();
+
+  if (!symcache) {
+    symcache = new elf_symbol_cache_t();
+  }
+  symcache->open(get_path());
 
   return SDBG_SYMTAB_OK;
 }
 
 //! PUBLIC: read_linkage_symbols
 /*!
-    It reads in all linkage symbols using the initialized
-    Elf handler.
+    It prepares the image for on-demand linkage symbol lookups;
+    symbols are only materialized as get_a_symbol asks for them.
+    If the symbol cache has an entry for the image, indexing its
+    symbol table is deferred until a lookup misses it.
 */
 template <LINUX_IMAGE_TEMPLATELIST>
 symtab_error_e
@@ -392,107 +411,98 @@ linux_image_t<LINUX_IMAGE_TEMPLPARAM>::read_linkage_symbols() throw(
     symtab_exception_t) {
   using namespace std;
 
-  string e;
-  string func = "[linux_image_t::read_linkage_symbols]";
-#if BIT64
-  Elf64_Shdr* shdr = NULL;
-  Elf64_Shdr* shdrdyn = NULL;
-  Elf64_Sym *first_sym, *last_sym;
-#else
-  Elf32_Shdr* shdr = NULL;
-  Elf32_Shdr* shdrdyn = NULL;
-  Elf32_Sym *first_sym, *last_sym;
-#endif
-  Elf_Data* elf_data = NULL;
-  Elf_Scn* symtab_sect = 0;
-  Elf_Scn* sect = 0;
-  Elf_Scn* dynsym_sect = 0;
-
-  Elf* elf_h = get_native_exec_handler()->get_elf_handler();
-
   {
     self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
                         "reading linkage symbol table for image[=%s]",
                         get_base_image_name().c_str());
   }
 
-  while ((sect = elf_nextscn(elf_h, sect)) != NULL) {
-#if BIT64
-    if ((shdr = elf64_getshdr(sect)) != NULL)
-#else
-    if ((shdr = elf32_getshdr(sect)) != NULL)
-#endif
+  if (!resolver || !symcache) {
+    init();
+  }
+
+  if (symcache->is_loaded()) {
     {
-      if (shdr->sh_type == SHT_SYMTAB) {
-        symtab_sect = sect;
-        break;
-      } else if (shdr->sh_type == SHT_DYNSYM) {
-        dynsym_sect = sect;
-        shdrdyn = shdr;
-      }
+      self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                          "symbol cache hit for image[=%s] key[=%s]",
+                          get_base_image_name().c_str(),
+                          symcache->get_key().c_str());
     }
+
+    return SDBG_SYMTAB_OK;
   }
 
-  if (!symtab_sect) {
-    if (dynsym_sect && shdrdyn) {
-      symtab_sect = dynsym_sect;
-      shdr = shdrdyn;
-    } else {
-      e = func + " No symbol table section is found in " +
-          get_base_image_name() + " ";
-      throw symtab_exception_t(e, SDBG_SYMTAB_FAILED);
-    }
+  resolver->init(get_path());
+
+  {
+    self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                        "%lu linkage symbols indexed for image[=%s]",
+                        (unsigned long)resolver->get_num_symbols(),
+                        get_base_image_name().c_str());
   }
 
-  if (((elf_data = elf_getdata(symtab_sect, elf_data)) == NULL) ||
-      elf_data->d_size == 0) {
-    e = func + " ELF data are not valid.";
-    throw symtab_exception_t(e, SDBG_SYMTAB_FAILED);
+  return SDBG_SYMTAB_OK;
+}
+
+//! PUBLIC: lookup_linkage_symbol
+/*!
+    resolves a single linkage symbol by name, through the symbol
+    cache first; returns NULL if the image has no such symbol or
+    has not been read yet.
+*/
+template <LINUX_IMAGE_TEMPLATELIST>
+symbol_base_t<VA>* linux_image_t<LINUX_IMAGE_TEMPLPARAM>::lookup_linkage_symbol(
+    const std::string& key) const {
+  using namespace std;
+
+  lmon_elf_sym_t cached;
+  const lmon_elf_sym_t* sym = NULL;
+
+  if (!resolver || !symcache) {
+    return NULL;
   }
 
-#if BIT64
-  first_sym = (Elf64_Sym*)elf_data->d_buf;
-  last_sym = (Elf64_Sym*)((char*)elf_data->d_buf + elf_data->d_size);
-#else
-  first_sym = (Elf32_Sym*)elf_data->d_buf;
-  last_sym = (Elf32_Sym*)((char*)(elf_data->d_buf) + elf_data->d_size);
-#endif
+  switch (symcache->lookup(key.c_str(), &cached)) {
+    case 1:
+      sym = &cached;
+      break;
 
-  while (first_sym < last_sym) {
-    //
-    // Some memory checkers complain symname is leaked, but
-    // we can't simply free it because it is unclear if it's safe
-    char* symname =
-        elf_strptr(elf_h, shdr->sh_link, (size_t)first_sym->st_name);
-
-    if (symname != 0 && (strcmp(symname, "") != 0) &&
-        (first_sym->st_value != 0)) {
-      const string ssym(symname);
-
-      linkage_symbol_t<VA>* a_linksym = new linkage_symbol_t<VA>(
-          ssym, get_base_image_name(), (const VA)first_sym->st_value,
-          (const VA)SYMTAB_UNINIT_ADDR);
-
-      string tmp;
-      decode_binding(first_sym->st_info, tmp);
-      a_linksym->set_binding(tmp);
-      a_linksym->set_vis(resolve_binding(first_sym->st_info));
-      decode_visibility(first_sym->st_other, tmp);
-      a_linksym->set_visibility(tmp);
-      decode_type(first_sym->st_info, tmp);
-      a_linksym->set_type(tmp);
-      a_linksym->set_defined((first_sym->st_shndx != SHN_UNDEF) ? true : false);
-
-      string keystr(symname);
-
-      get_linkage_symtab().insert(
-          make_pair(keystr, (symbol_base_t<VA>*)a_linksym));
-    }
+    case 0:
+      return NULL;
+
+    default:
+      if (!resolver->is_open()) {
+        try {
+          resolver->init(get_path());
+        } catch (symtab_exception_t e) {
+          e.report();
+          return NULL;
+        }
+      }
+      sym = resolver->lookup(key.c_str());
+      symcache->record(key.c_str(), sym);
+      break;
+  }
 
-    first_sym++;
+  if (!sym) {
+    return NULL;
   }
 
-  return SDBG_SYMTAB_OK;
+  linkage_symbol_t<VA>* a_linksym = new linkage_symbol_t<VA>(
+      key, get_base_image_name(), (const VA)sym->st_value,
+      (const VA)SYMTAB_UNINIT_ADDR);
+
+  string tmp;
+  decode_binding(sym->st_info, tmp);
+  a_linksym->set_binding(tmp);
+  a_linksym->set_vis(resolve_binding(sym->st_info));
+  decode_visibility(sym->st_other, tmp);
+  a_linksym->set_visibility(tmp);
+  decode_type(sym->st_info, tmp);
+  a_linksym->set_type(tmp);
+  a_linksym->set_defined((sym->st_shndx != SHN_UNDEF) ? true : false);
+
+  return a_linksym;
 }
 
 //! PUBLIC: fetch_DSO_info
@@ -528,6 +538,17 @@ symtab_error_e linux_image_t<LINUX_IMAGE_TEMPLPARAM>::fetch_DSO_info(
 #endif
   int sz;
 
+  if (!get_native_exec_handler()) {
+    elf_wrapper* elfw = new elf_wrapper(get_path());
+
+    if (elfw->init() != SDBG_SYMTAB_OK) {
+      delete elfw;
+      e = func + " ELF library init failed.";
+      throw symtab_exception_t(e, SDBG_SYMTAB_FAILED);
+    }
+    set_native_exec_handler(elfw);
+  }
+
   sect = 0;
   Elf* elf_h = get_native_exec_handler()->get_elf_handler();
 
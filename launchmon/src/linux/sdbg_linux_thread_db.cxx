@@ -0,0 +1,191 @@
+/*
+ *--------------------------------------------------------------------------------
+ * Copyright (c) 2008, Lawrence Livermore National Security, LLC. Produced at
+ * the Lawrence Livermore National Laboratory. Written by Dong H. Ahn
+ * <ahn1@llnl.gov>. LLNL-CODE-409469. All rights reserved.
+ *
+ * This file is part of LaunchMON. For details, see
+ * https://computing.llnl.gov/?set=resources&page=os_projects
+ *
+ * Please also read LICENSE.txt -- Our Notice and GNU Lesser General Public
+ * License.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the terms and conditions of the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple
+ * Place, Suite 330, Boston, MA 02111-1307 USA
+ *--------------------------------------------------------------------------------
+ */
+
+
+#ifndef HAVE_LAUNCHMON_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dlfcn.h>
+
+#include "sdbg_linux_thread_db.hxx"
+#include "sdbg_base_mach_impl.hxx"
+#include "sdbg_self_trace.hxx"
+
+////////////////////////////////////////////////////////////////////
+//
+// PUBLIC INTERFACES (class linux_thread_db_t)
+//
+//
+
+//! PUBLIC: linux_thread_db_t
+/*!
+    default constructor
+*/
+linux_thread_db_t::linux_thread_db_t()
+    : handle(NULL),
+      unusable(false),
+      agent(NULL),
+      ta_delete(NULL),
+      ta_map_lwp2thr(NULL),
+      thr_get_info(NULL),
+      MODULENAME(
+          self_trace_t::self_trace().launchmon_module_trace.module_name) {
+  ph.p = NULL;
+  ph.tracer = NULL;
+}
+
+//! PUBLIC: ~linux_thread_db_t
+/*!
+    destructor
+*/
+linux_thread_db_t::~linux_thread_db_t() { finalize(); }
+
+//! PUBLIC: get_start_func
+/*!
+    sets start to the address of the start routine of thread lid of
+    p, which must be stopped and be the current thread context of p.
+    Returns false if the thread debug library cannot tell, e.g.,
+    because it is not available or the thread is not a pthread.
+*/
+bool linux_thread_db_t::get_start_func(
+    process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
+    tracer_base_t<SDBG_LINUX_DFLT_INSTANTIATION> *tr, lwpid_t lid,
+    T_VA &start) {
+  td_thrhandle_t th;
+  td_thrinfo_t info;
+  td_err_e te;
+
+  if (!agent && !init(p, tr)) {
+    return false;
+  }
+
+  if ((te = ta_map_lwp2thr(agent, lid, &th)) != TD_OK) {
+    self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                        "td_ta_map_lwp2thr for %d failed: %d", lid, te);
+    return false;
+  }
+
+  if ((te = thr_get_info(&th, &info)) != TD_OK) {
+    self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                        "td_thr_get_info for %d failed: %d", lid, te);
+    return false;
+  }
+
+  start = (T_VA)info.ti_startfunc;
+
+  return (start != 0);
+}
+
+//! PUBLIC: finalize
+/*!
+    releases the thread agent and unloads the library
+*/
+void linux_thread_db_t::finalize() {
+  if (agent && ta_delete) {
+    ta_delete(agent);
+  }
+  agent = NULL;
+
+  if (handle) {
+    dlclose(handle);
+    handle = NULL;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//
+// PRIVATE INTERFACES (class linux_thread_db_t)
+//
+//
+
+//! PRIVATE: init
+/*!
+    loads the thread debug library and creates the thread agent of
+    p. A failure is remembered so that it is not retried on every
+    thread.
+*/
+bool linux_thread_db_t::init(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
+                             tracer_base_t<SDBG_LINUX_DFLT_INSTANTIATION> *tr) {
+  td_init_fn_t td_init_fn;
+  td_ta_new_fn_t ta_new;
+  td_err_e te;
+
+  if (unusable) {
+    return false;
+  }
+
+  if (!handle && !(handle = dlopen(LIBTHREAD_DB, RTLD_NOW))) {
+    self_trace_t::trace(LEVELCHK(level1), MODULENAME, 0,
+                        "cannot load %s: %s", LIBTHREAD_DB, dlerror());
+    unusable = true;
+    return false;
+  }
+
+  td_init_fn = (td_init_fn_t)dlsym(handle, "td_init");
+  ta_new = (td_ta_new_fn_t)dlsym(handle, "td_ta_new");
+  ta_delete = (td_ta_delete_fn_t)dlsym(handle, "td_ta_delete");
+  ta_map_lwp2thr = (td_ta_map_lwp2thr_fn_t)dlsym(handle, "td_ta_map_lwp2thr");
+  thr_get_info = (td_thr_get_info_fn_t)dlsym(handle, "td_thr_get_info");
+
+  if (!td_init_fn || !ta_new || !ta_delete || !ta_map_lwp2thr ||
+      !thr_get_info) {
+    self_trace_t::trace(LEVELCHK(level1), MODULENAME, 0,
+                        "%s lacks a required interface", LIBTHREAD_DB);
+    unusable = true;
+    return false;
+  }
+
+  ph.p = &p;
+  ph.tracer = tr;
+
+  if ((te = td_init_fn()) != TD_OK || (te = ta_new(&ph, &agent)) != TD_OK) {
+    //
+    // TD_NOLIBTHREAD and TD_VERSION may go away once the
+    // threads library is loaded and initialized; try again later.
+    //
+    self_trace_t::trace(LEVELCHK(level1), MODULENAME, 0,
+                        "cannot create a thread agent: %d", te);
+    agent = NULL;
+    unusable = (te != TD_NOLIBTHREAD && te != TD_VERSION);
+    return false;
+  }
+
+  {
+    self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                        "thread agent created for pid %d",
+                        p.get_master_thread_pid());
+  }
+
+  return true;
+}
+
+/*
+ * ts=2 sw=2 expandtab
+ */
@@ -0,0 +1,101 @@
+/*
+ *--------------------------------------------------------------------------------
+ * Copyright (c) 2008, Lawrence Livermore National Security, LLC. Produced at
+ * the Lawrence Livermore National Laboratory. Written by Dong H. Ahn
+ * <ahn1@llnl.gov>. LLNL-CODE-409469. All rights reserved.
+ *
+ * This file is part of LaunchMON. For details, see
+ * https://computing.llnl.gov/?set=resources&page=os_projects
+ *
+ * Please also read LICENSE.txt -- Our Notice and GNU Lesser General Public
+ * License.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the terms and conditions of the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple
+ * Place, Suite 330, Boston, MA 02111-1307 USA
+ *--------------------------------------------------------------------------------
+ */
+
+
+#ifndef SDBG_LINUX_THREAD_DB_HXX
+#define SDBG_LINUX_THREAD_DB_HXX 1
+
+#include "sdbg_std.hxx"
+
+#ifndef LINUX_CODE_REQUIRED
+#error This source file requires a LINUX OS
+#endif
+
+#include <thread_db.h>
+
+#include "sdbg_base_tracer.hxx"
+#include "sdbg_linux_mach.hxx"
+#include "sdbg_linux_std.hxx"
+
+//!
+/*! linux_thread_db_t
+
+    a thin wrapper of the thread debug library, which is only
+    loaded once a question about the threads of the RM process
+    comes up. It is bound to one process and the tracer that
+    accesses it, through which the library's proc service calls go.
+*/
+class linux_thread_db_t {
+ public:
+  //
+  // constructors & destructor
+  //
+  linux_thread_db_t();
+  ~linux_thread_db_t();
+
+  bool get_start_func(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
+                      tracer_base_t<SDBG_LINUX_DFLT_INSTANTIATION> *tr,
+                      lwpid_t lid, T_VA &start);
+  void finalize();
+
+ private:
+  bool LEVELCHK(self_trace_verbosity level) {
+    return (self_trace_t::self_trace().launchmon_module_trace.verbosity_level >=
+            level);
+  }
+
+  bool init(process_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &p,
+            tracer_base_t<SDBG_LINUX_DFLT_INSTANTIATION> *tr);
+
+  typedef td_err_e (*td_init_fn_t)(void);
+  typedef td_err_e (*td_ta_new_fn_t)(struct ps_prochandle *, td_thragent_t **);
+  typedef td_err_e (*td_ta_delete_fn_t)(td_thragent_t *);
+  typedef td_err_e (*td_ta_map_lwp2thr_fn_t)(const td_thragent_t *, lwpid_t,
+                                             td_thrhandle_t *);
+  typedef td_err_e (*td_thr_get_info_fn_t)(const td_thrhandle_t *,
+                                           td_thrinfo_t *);
+
+  void *handle;
+  bool unusable;
+  struct ps_prochandle ph;
+  td_thragent_t *agent;
+  td_ta_delete_fn_t ta_delete;
+  td_ta_map_lwp2thr_fn_t ta_map_lwp2thr;
+  td_thr_get_info_fn_t thr_get_info;
+
+  // For self tracing
+  //
+  std::string MODULENAME;
+};
+
+#endif  // SDBG_LINUX_THREAD_DB_HXX
+
+/*
+ * ts=2 sw=2 expandtab
+ */
@@ -103,6 +103,18 @@ struct user_desc {
 
 linux_ptracer_t<SDBG_LINUX_DFLT_INSTANTIATION> myprocess_tracer;
 
+//! File scope tracer_of
+/*!
+    the tracer to access ph with: the engine's own if it set one, so
+    that the thread debug library shares its per-stop caches
+*/
+static tracer_base_t<SDBG_LINUX_DFLT_INSTANTIATION> &tracer_of(
+    const struct ps_prochandle *ph) {
+  if (ph->tracer) return *(ph->tracer);
+
+  return myprocess_tracer;
+}
+
 //! PUBLIC: ps_pdread
 /*!
     a routine to read from the given process, which
@@ -111,8 +123,12 @@ linux_ptracer_t<SDBG_LINUX_DFLT_INSTANTIATION> myprocess_tracer;
 extern "C" ps_err_e ps_pdread(struct ps_prochandle *ph, psaddr_t addr,
                               void *buf, size_t size) {
   bool use_cxt = true;
-  if (myprocess_tracer.tracer_read(*(ph->p), (T_VA)addr, buf, size, use_cxt) !=
-      SDBG_TRACE_OK) {
+  try {
+    if (tracer_of(ph).tracer_read(*(ph->p), (T_VA)addr, buf, size,
+                                  use_cxt) != SDBG_TRACE_OK) {
+      return PS_ERR;
+    }
+  } catch (tracer_exception_t e) {
     return PS_ERR;
   }
 
@@ -127,8 +143,12 @@ extern "C" ps_err_e ps_pdread(struct ps_prochandle *ph, psaddr_t addr,
 extern "C" ps_err_e ps_pdwrite(struct ps_prochandle *ph, psaddr_t addr,
                                const void *buf, size_t size) {
   bool use_cxt = true;
-  if (myprocess_tracer.tracer_write(*(ph->p), (T_VA)addr, buf, size, use_cxt) !=
-      SDBG_TRACE_OK) {
+  try {
+    if (tracer_of(ph).tracer_write(*(ph->p), (T_VA)addr, buf, size,
+                                   use_cxt) != SDBG_TRACE_OK) {
+      return PS_ERR;
+    }
+  } catch (tracer_exception_t e) {
     return PS_ERR;
   }
 
@@ -164,7 +184,11 @@ extern "C" ps_err_e ps_lgetregs(struct ps_prochandle *ph, lwpid_t id,
                                 prgregset_t reg) {
   bool use_cxt = true;
 
-  if (myprocess_tracer.tracer_getregs(*(ph->p), use_cxt) != SDBG_TRACE_OK) {
+  try {
+    if (tracer_of(ph).tracer_getregs(*(ph->p), use_cxt) != SDBG_TRACE_OK) {
+      return PS_ERR;
+    }
+  } catch (tracer_exception_t e) {
     return PS_ERR;
   }
 
@@ -184,7 +208,11 @@ extern "C" ps_err_e ps_lsetregs(struct ps_prochandle *ph, lwpid_t id,
                                 const prgregset_t reg) {
   bool use_cxt = true;
 
-  if (myprocess_tracer.tracer_setregs(*(ph->p), use_cxt) != SDBG_TRACE_OK) {
+  try {
+    if (tracer_of(ph).tracer_setregs(*(ph->p), use_cxt) != SDBG_TRACE_OK) {
+      return PS_ERR;
+    }
+  } catch (tracer_exception_t e) {
     return PS_ERR;
   }
   // printf("Please implement ps_lsetregs\n");
@@ -200,7 +228,12 @@ extern "C" ps_err_e ps_lgetfpregs(struct ps_prochandle *ph, lwpid_t id,
                                   prfpregset_t *reg) {
   bool use_cxt = true;
 
-  if (myprocess_tracer.tracer_getfpregs(*(ph->p), use_cxt) != SDBG_TRACE_OK) {
+  try {
+    if (tracer_of(ph).tracer_getfpregs(*(ph->p), use_cxt) !=
+        SDBG_TRACE_OK) {
+      return PS_ERR;
+    }
+  } catch (tracer_exception_t e) {
     return PS_ERR;
   }
   // copy ph->p  FPR to reg
@@ -218,7 +251,12 @@ extern "C" ps_err_e ps_lsetfpregs(struct ps_prochandle *ph, lwpid_t id,
 {
   bool use_cxt = true;
 
-  if (myprocess_tracer.tracer_setfpregs(*(ph->p), use_cxt) != SDBG_TRACE_OK) {
+  try {
+    if (tracer_of(ph).tracer_setfpregs(*(ph->p), use_cxt) !=
+        SDBG_TRACE_OK) {
+      return PS_ERR;
+    }
+  } catch (tracer_exception_t e) {
     return PS_ERR;
   }
 
@@ -502,6 +540,23 @@ extern "C" ps_err_e ps_pglobal_lookup(struct ps_prochandle *ph,
     } else {
       error_code = PS_NOSYM;
     }
+  } else if (ph->p->get_mylibc_image() &&
+             (equal_base(objpath, ph->p->get_mylibc_image()->get_path()) ||
+              strncmp(object_name, LIBPTHREAD_IDEN,
+                      strlen(LIBPTHREAD_IDEN)) == 0)) {
+    //
+    // glibc 2.34 and later keep the NPTL symbols in libc and load
+    // no libpthread, though libthread_db may still ask for it
+    //
+    const symbol_base_t<T_VA> &asym =
+        ph->p->get_mylibc_image()->get_a_symbol(sym);
+    if (asym.get_raw_address() != SYMTAB_UNINIT_ADDR &&
+        asym.get_relocated_address()) {
+      (*sym_addr) = (psaddr_t)asym.get_relocated_address();
+      error_code = (*sym_addr) ? PS_OK : PS_ERR;
+    } else {
+      error_code = PS_NOSYM;
+    }
   } else if (equal_base(objpath, loader_path)) {
     const symbol_base_t<T_VA> &asym =
         ph->p->get_mydynloader_image()->get_a_symbol(sym);
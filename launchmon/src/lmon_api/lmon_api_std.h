@@ -48,6 +48,7 @@
 #define LMON_API_LMON_API_STD_H 1
 
 #include <lmon_api/common.h>
+#include <stdint.h>
 
 BEGIN_C_DECLS
 
@@ -59,6 +60,7 @@ BEGIN_C_DECLS
 #define LMON_SHRD_SEC_ENVNAME "LMON_SHARED_SECRET"
 #define LMON_SEC_CHK_ENVNAME  "LMON_SEC_CHK"
 #define LMON_VERBOSE_ENVNAME  "LMON_VERBOSITY"
+#define LMON_BE_PROCTAB_DIST_ENVNAME "LMON_BE_PROCTAB_DIST"
 #define LMON_KEY_LENGTH       16      /* 128 bits */
 #define LMON_MAX_USRPAYLOAD   4194304 /* 4 MB */
 #define LMON_MAX_NDAEMONS     8192
@@ -160,6 +162,52 @@ typedef enum _dist_req_opt_e {
 
 typedef int lmon_mw_mode_t;
 
+/*
+ * handle of a non-blocking daemon collective such as LMON_be_ibroadcast;
+ * LMON_be_test and LMON_be_wait reset it to LMON_REQUEST_NULL once the
+ * collective completes
+ */
+typedef void *lmon_request_t;
+#define LMON_REQUEST_NULL ((lmon_request_t)0)
+
+/*
+ * element types and reduction ops of LMON_be_reduce, LMON_be_allreduce
+ * and their LMON_mw_ counterparts. The logical and bitwise ops apply
+ * to integer types only; LMON_be_regReduceOp and LMON_mw_regReduceOp hand out
+ * the ids of user ops from LMON_OP_USER on.
+ */
+typedef enum _lmon_datatype_e {
+  LMON_TYPE_CHAR = 0,
+  LMON_TYPE_INT,
+  LMON_TYPE_UNSIGNED,
+  LMON_TYPE_LONG,
+  LMON_TYPE_UNSIGNED_LONG,
+  LMON_TYPE_LONG_LONG,
+  LMON_TYPE_UNSIGNED_LONG_LONG,
+  LMON_TYPE_FLOAT,
+  LMON_TYPE_DOUBLE
+} lmon_datatype_e;
+
+typedef enum _lmon_op_e {
+  LMON_OP_SUM = 0,
+  LMON_OP_PROD,
+  LMON_OP_MIN,
+  LMON_OP_MAX,
+  LMON_OP_LAND,
+  LMON_OP_LOR,
+  LMON_OP_BAND,
+  LMON_OP_BOR,
+  LMON_OP_BXOR,
+  LMON_OP_USER = 64
+} lmon_op_e;
+
+/*
+ * user reduction op: sets inout[i] to inout[i] op in[i] for count
+ * elements of type, where inout holds the data of the lower ranks
+ */
+typedef void (*lmon_reduce_fn_t)(void *inout, void *in, int count,
+                                 lmon_datatype_e type);
+
 typedef struct _dist_request_t {
   lmon_mw_mode_t md;      /* which volume is this request? */
   char *mw_daemon_path;   /* middleware daemon path */
@@ -176,6 +224,57 @@ typedef struct _dist_request_t {
   } option;
 } dist_request_t;
 
+/*
+ * LaunchMON engine statistics returned by LMON_fe_getEngineStats.
+ *
+ * Each handler event type gets a log-linear latency histogram of
+ * microseconds from the waitpid return that reported the event to
+ * the completion of its handler. Latencies below
+ * 2^LMON_STATS_SUB_BITS usec have a bucket each; above that, every
+ * power of two is split into 2^LMON_STATS_SUB_BITS buckets, and
+ * LMON_stats_bucket_floor(b) is the smallest latency in bucket b.
+ * The last bucket also holds everything beyond it.
+ */
+#define LMON_STATS_MAX_EVENTS       16
+#define LMON_STATS_EVENT_NAME_LEN   32
+#define LMON_STATS_SUB_BITS         3
+#define LMON_STATS_NUM_BUCKETS      224
+
+#define LMON_stats_bucket_floor(b)                                       \
+  ((b) < (1 << LMON_STATS_SUB_BITS)                                      \
+       ? (uint64_t)(b)                                                   \
+       : ((uint64_t)((1 << LMON_STATS_SUB_BITS) +                        \
+                     ((b) & ((1 << LMON_STATS_SUB_BITS) - 1)))           \
+          << (((b) >> LMON_STATS_SUB_BITS) - 1)))
+
+typedef struct _lmon_event_stats_t {
+  char name[LMON_STATS_EVENT_NAME_LEN];
+  uint64_t count;
+  uint64_t sum_usec;
+  uint64_t min_usec;
+  uint64_t max_usec;
+  uint32_t buckets[LMON_STATS_NUM_BUCKETS];
+} lmon_event_stats_t;
+
+typedef struct _lmon_engine_stats_t {
+  uint32_t num_events;
+  uint32_t reserved;
+  uint64_t ptrace_calls;      /* ptrace system calls issued */
+  uint64_t mem_read_calls;    /* process_vm_readv and /proc/<pid>/mem reads */
+  uint64_t bytes_read;        /* bytes read from traced processes */
+  uint64_t mem_write_calls;   /* process_vm_writev batched writes */
+  uint64_t bytes_written;     /* bytes written to traced processes */
+  uint64_t bp_emulated;       /* breakpoint hits stepped over by emulation */
+  uint64_t bp_singlestepped;  /* breakpoint hits stepped over by a single-step */
+  uint64_t regs_cache_hits;   /* register fetches served by the stop cache */
+  uint64_t regs_cache_misses; /* register fetches that went to the kernel */
+  uint64_t mem_cache_hits;    /* memory reads served by the stop cache */
+  uint64_t mem_cache_misses;  /* memory reads that had to fetch pages */
+  uint64_t cache_incoherent;  /* stale cache hits found in the check mode */
+  uint64_t threads_detached;  /* launcher threads left untraced */
+  lmon_event_stats_t events[LMON_STATS_MAX_EVENTS];
+} lmon_engine_stats_t;
+
 END_C_DECLS
 
 #endif /* LMON_API_LMON_API_STD_H */
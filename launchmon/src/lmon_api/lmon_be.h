@@ -76,6 +76,58 @@ lmon_rc_e LMON_be_scatter (
                 int numbyte_per_element,
                 void* recvbuf );
 
+lmon_rc_e LMON_be_gatherv (
+                void *sendbuf,
+                int numbyte,
+                void **recvbuf,
+                int *recvcounts );
+
+lmon_rc_e LMON_be_scatterv (
+                void *sendbuf,
+                int *sendcounts,
+                int *displs,
+                void *recvbuf,
+                int recvcount );
+
+lmon_rc_e LMON_be_regReduceOp (
+                lmon_reduce_fn_t fn,
+                int *op );
+
+lmon_rc_e LMON_be_reduce (
+                void *sendbuf,
+                void *recvbuf,
+                int count,
+                lmon_datatype_e type,
+                int op );
+
+lmon_rc_e LMON_be_allreduce (
+                void *sendbuf,
+                void *recvbuf,
+                int count,
+                lmon_datatype_e type,
+                int op );
+
+lmon_rc_e LMON_be_ibarrier (
+                lmon_request_t *req );
+
+lmon_rc_e LMON_be_ibroadcast (
+                void *buf,
+                int numbyte,
+                lmon_request_t *req );
+
+lmon_rc_e LMON_be_igather (
+                void *sendbuf,
+                int numbyte_per_elem,
+                void *recvbuf,
+                lmon_request_t *req );
+
+lmon_rc_e LMON_be_test (
+                lmon_request_t *req,
+                int *flag );
+
+lmon_rc_e LMON_be_wait (
+                lmon_request_t *req );
+
 lmon_rc_e LMON_be_finalize ();
 
 lmon_rc_e LMON_be_handshake ( void* udata );
@@ -92,6 +144,19 @@ lmon_rc_e LMON_be_getMyProctab (
 lmon_rc_e LMON_be_getMyProctabSize (
 		int *size );
 
+lmon_rc_e LMON_be_getMyProctabView (
+                lmon_proctab_view_t *view );
+
+lmon_rc_e LMON_be_fetchProctable ();
+
+lmon_rc_e LMON_be_getProctable (
+                MPIR_PROCDESC_EXT *proctabbuf,
+                int *size,
+                int proctab_num_elem );
+
+lmon_rc_e LMON_be_getProctableSize (
+		int *size );
+
 lmon_rc_e LMON_be_regPackForBeToFe (
                 int (*packBefe) 
                 ( void* udata,void* msgbuf,int msgbufmax,int* msgbuflen ) );
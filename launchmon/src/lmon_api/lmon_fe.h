@@ -150,6 +150,31 @@ lmon_rc_e LMON_fe_getProctableSize (
               int sessionHandle,
               unsigned int* size);
 
+lmon_rc_e LMON_fe_getProctableView (
+              int sessionHandle,
+              lmon_proctab_view_t* view);
+
+lmon_rc_e LMON_fe_getProctablePage (
+              int sessionHandle,
+              unsigned int offset,
+              unsigned int count,
+              lmon_proctab_view_t* page);
+
+lmon_rc_e LMON_fe_getProctableByHost (
+              int sessionHandle,
+              const char* hostname,
+              lmon_proctab_view_t* view);
+
+lmon_rc_e LMON_fe_getProctableByRank (
+              int sessionHandle,
+              int rank,
+              lmon_proctab_view_t* view,
+              int* index);
+
+lmon_rc_e LMON_fe_getEngineStats (
+              int sessionHandle,
+              lmon_engine_stats_t* stats);
+
 lmon_rc_e LMON_fe_getResourceHandle (
               int sessionHandle,
               char* handle,
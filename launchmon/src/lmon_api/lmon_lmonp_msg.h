@@ -202,6 +202,27 @@ typedef enum _lmonp_fe_to_fe_msg_e {
    */
   lmonp_cont_launch_bp,
 
+  /*
+   * FE->engine: please ship a statistics snapshot
+   */
+  lmonp_stats_req,
+
+  /*
+   * engine->FE: statistics snapshot (lmon_engine_stats_t)
+   */
+  lmonp_stats,
+
+  /*
+   * engine->FE: the proctable stream begins; the header carries
+   * the job size and the payload the host names in host order.
+   * lmonp_proctable_chunk messages follow, each carrying the entries
+   * of the next tasks and the strings they introduce, and then
+   * lmonp_proctable_end in place of lmonp_proctable_avail
+   */
+  lmonp_proctable_begin,
+  lmonp_proctable_chunk,
+  lmonp_proctable_end,
+
   /*
    * end of enumerator marker
    */
@@ -397,6 +418,47 @@ typedef enum  _my_lmon_kind_e {
     lmon_payload_length.
 */
 
+//! Note: the compact RPDTAB format
+/*!
+    A proctable payload may instead start with an lmonp_rpdtab_cmpt_t
+    whose magic can never be a legacy string table index. It is
+    followed by wire_length bytes that, inflated with LZ4 if
+    LMON_RPDTAB_LZ4 is set, hold body_length bytes of
+
+    1. varint # of executables, varint # of hostnames
+    2. the executable names, NULL-terminated
+    3. the hostnames in sorted order, each front-coded as a varint
+       length of the prefix shared with the previous hostname
+       followed by the NULL-terminated rest
+    4. the executable index column as varint (index, run length)
+       pairs preceded by the # of runs; absent with
+       LMON_RPDTAB_SINGLE_EXEC
+    5. the hostname index column, run-length coded as in 4
+    6. the pid, rank and cnodeid columns, each as zigzag varints of
+       the difference from the previous task's value (from the
+       previous rank + 1 for the rank column)
+
+    The header fields of the lmonp_t message keep their meanings.
+    The engine uses this format only when the FE API asks for it
+    with the --rpdtabenc option.
+*/
+#define LMON_RPDTAB_CMPT_MAGIC   0xffffffffU
+#define LMON_RPDTAB_SINGLE_EXEC  0x1
+#define LMON_RPDTAB_LZ4          0x2
+
+typedef struct _lmonp_rpdtab_cmpt_t {
+  unsigned int magic                    : 32;
+  unsigned int flags                    : 32;
+  unsigned int body_length              : 32;
+  unsigned int wire_length              : 32;
+} lmonp_rpdtab_cmpt_t;
+
+typedef enum _lmon_rpdtab_enc_e {
+  lmon_rpdtab_legacy                   = 0,
+  lmon_rpdtab_compact,
+  lmon_rpdtab_compact_lz4
+} lmon_rpdtab_enc_e;
+
 typedef struct _lmonp_t {
   lmonp_msg_class_e msgclass            : 3;
 
@@ -520,6 +582,39 @@ char * get_usrpayload_begin ( lmonp_t *msg );
 char * get_strtab_begin ( lmonp_t *msg );
 int parse_raw_RPDTAB_msg (lmonp_t *proctabMsg, void *pMap);
 
+
+//! RPDTAB encodings
+/*!
+  str_to_rpdtab_enc maps "legacy", "compact" or "lz4" to an encoding.
+  compact_RPDTAB_msg returns a newly allocated copy of a legacy
+  proctable message in the given compact encoding and its length in
+  *msglen, or NULL if it cannot.
+  get_RPDTAB_entries returns the per-task entries of a proctable
+  message in the legacy layout and their string table in *strtab;
+  for a compact message they are decoded into *tofree which the
+  caller must free.
+  RPDTAB_msg_ntasks returns the number of tasks a proctable message
+  carries, whichever header field holds it.
+*/
+lmon_rpdtab_enc_e str_to_rpdtab_enc ( const char *enc );
+unsigned int RPDTAB_msg_ntasks ( lmonp_t *msg );
+int is_compact_RPDTAB_msg ( lmonp_t *msg );
+lmonp_t * compact_RPDTAB_msg ( lmonp_t *msg, lmon_rpdtab_enc_e enc,
+                               int *msglen );
+char * get_RPDTAB_entries ( lmonp_t *msg, char **strtab, char **tofree );
+
+//! index_RPDTAB_entries
+/*!
+  groups ntasks entries returned by get_RPDTAB_entries by host, in
+  the order hosts are first seen, with a stable counting sort: order
+  receives ntasks task indices in which each host's tasks are
+  contiguous and hosts, a std::vector<lmon_proctab_host_t>, receives
+  one [begin, end) range into order per host.
+*/
+int index_RPDTAB_entries ( const char *entries, const char *strtab,
+                           unsigned int ntasks, unsigned int *order,
+                           void *hosts );
+
 ssize_t lmon_write_raw ( int fd, void *buf, size_t count );
 ssize_t lmon_read_raw ( int fd, void *buf, size_t count );
 
@@ -63,6 +63,37 @@ lmon_rc_e LMON_mw_scatter(
                 int numbyte_per_element,
                 void *recvbuf);
 
+lmon_rc_e LMON_mw_gatherv(
+                void *sendbuf,
+                int numbyte,
+                void **recvbuf,
+                int *recvcounts);
+
+lmon_rc_e LMON_mw_scatterv(
+                void *sendbuf,
+                int *sendcounts,
+                int *displs,
+                void *recvbuf,
+                int recvcount);
+
+lmon_rc_e LMON_mw_regReduceOp(
+                lmon_reduce_fn_t fn,
+                int *op);
+
+lmon_rc_e LMON_mw_reduce(
+                void *sendbuf,
+                void *recvbuf,
+                int count,
+                lmon_datatype_e type,
+                int op);
+
+lmon_rc_e LMON_mw_allreduce(
+                void *sendbuf,
+                void *recvbuf,
+                int count,
+                lmon_datatype_e type,
+                int op);
+
 lmon_rc_e LMON_mw_broadcast(
                 void *buf,
                 int numbyte);
@@ -78,6 +78,48 @@ typedef struct {
 */
 #define N_Fields_MPIR_PROCDESC_EXT 5
 
+
+//! lmon_proctab_host_t
+/*!
+    the tasks of a host occupy positions [begin, end) of a
+    process table view
+*/
+typedef struct _lmon_proctab_host_t {
+  const char *host_name;
+  int begin;
+  int end;
+} lmon_proctab_host_t;
+
+
+//! lmon_proctab_view_t
+/*!
+    a read-only view of a process table that points into the
+    table as it was received: no per-entry memory is allocated
+    and nothing has to be freed by the caller. Entries are
+    N_Fields_MPIR_PROCDESC_EXT unsigned ints {hostname index,
+    executable index, pid, rank, cnodeid} where the indices are
+    offsets into strtab. Position i of the view, grouped by host,
+    is entry order[i]. Use the LMON_view_* accessors below.
+*/
+typedef struct _lmon_proctab_view_t {
+  int num_tasks;
+  int num_hosts;
+  int my_host;  /* index into hosts of the selected host, -1 if none */
+  const lmon_proctab_host_t *hosts;
+  const unsigned int *order;
+  const unsigned int *entries;
+  const char *strtab;
+} lmon_proctab_view_t;
+
+#define LMON_view_entry(v, i) \
+  ((v)->entries + (v)->order[(i)] * N_Fields_MPIR_PROCDESC_EXT)
+#define LMON_view_host_name(v, i) ((v)->strtab + LMON_view_entry(v, i)[0])
+#define LMON_view_executable_name(v, i) \
+  ((v)->strtab + LMON_view_entry(v, i)[1])
+#define LMON_view_pid(v, i) ((int)LMON_view_entry(v, i)[2])
+#define LMON_view_mpirank(v, i) ((int)LMON_view_entry(v, i)[3])
+#define LMON_view_cnodeid(v, i) ((int)LMON_view_entry(v, i)[4])
+
 END_C_DECLS 
 
 #endif /* LMON_API_LMON_PROC_TAB_H */
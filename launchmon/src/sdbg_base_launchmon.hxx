@@ -66,6 +66,7 @@ extern "C" {
 #include "sdbg_base_mach.hxx"
 #include "sdbg_base_tracer.hxx"
 #include "sdbg_opt.hxx"
+#include "sdbg_proctab.hxx"
 #include "sdbg_self_trace.hxx"
 
 #include <lmon_api/lmon_lmonp_msg.h>
@@ -155,12 +156,9 @@ class launchmon_base_t {
   define_gset(int, toollauncherpid)
   define_gset(int, FE_sockfd)
   define_gset(bool, API_mode)
-  define_gset(double, last_seen)
-  define_gset(double, warm_period)
-  std::map<std::string, std::vector<MPIR_PROCDESC_EXT *> >
-      &get_proctable_copy() {
-    return proctable_copy;
-  }
+  define_gset(lmon_rpdtab_enc_e, rpdtab_enc)
+  define_gset(unsigned int, rpdtab_chunk)
+  proctab_t &get_proctable_copy() { return proctable_copy; }
 
   //
   // Method that invokes a corresponding handler based on e
@@ -278,6 +276,11 @@ class launchmon_base_t {
   //
   launchmon_rc_e ship_proctab_msg(lmonp_fe_to_fe_msg_e);
 
+  //
+  // ships the RPDTAB to the FE API client in chunks
+  //
+  launchmon_rc_e ship_proctab_stream();
+
   //
   // ships the resource handle to the FE API client
   //
@@ -288,6 +291,11 @@ class launchmon_base_t {
   //
   launchmon_rc_e ship_rminfo_msg(lmonp_fe_to_fe_msg_e, int, rm_catalogue_e);
 
+  //
+  // ships an engine statistics snapshot to the FE API client
+  //
+  launchmon_rc_e ship_stats_msg(lmonp_fe_to_fe_msg_e);
+
   //
   // handle a message received from the FE API client
   //
@@ -340,12 +348,11 @@ class launchmon_base_t {
   int toollauncherpid;
 
   //
-  // The member containing all proctable entries
-  // std::vector<MPIR_PROCDESC_EXT *> proctable_copy;
+  // The member containing all proctable entries grouped by host
   //
   // This table is filled by the platform dependent layer
   //
-  std::map<std::string, std::vector<MPIR_PROCDESC_EXT *> > proctable_copy;
+  proctab_t proctable_copy;
 
   //
   // Unix PIPE with LAUNCHMON FE API STUB
@@ -356,10 +363,15 @@ class launchmon_base_t {
   bool API_mode;
 
   //
-  // To support two-phase polling scheme
+  // The RPDTAB encoding the FE API negotiated via --rpdtabenc
+  //
+  lmon_rpdtab_enc_e rpdtab_enc;
+
+  //
+  // Tasks per lmonp_proctable_chunk the FE API negotiated via
+  // --rpdtabchunk; 0 ships the RPDTAB in a single message
   //
-  double last_seen;
-  double warm_period;
+  unsigned int rpdtab_chunk;
 
   //
   // To support self tracing
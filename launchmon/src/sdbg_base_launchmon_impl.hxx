@@ -61,6 +61,7 @@
 #include <signal.h>
 
 #include "sdbg_base_launchmon.hxx"
+#include "sdbg_engine_stats.hxx"
 
 ////////////////////////////////////////////////////////////////////
 //
@@ -81,8 +82,6 @@ launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::launchmon_base_t(
   toollauncherpid = l.toollauncherpid;
   FE_sockfd = l.FE_sockfd;
   API_mode = l.API_mode;
-  last_seen = l.last_seen;
-  warm_period = l.warm_period;
   //
   // This should never be called
   //
@@ -103,8 +102,6 @@ launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>
   toollauncherpid = rhs.toollauncherpid;
   FE_sockfd = rhs.FE_sockfd;
   API_mode = rhs.API_mode;
-  last_seen = rhs.last_seen;
-  warm_period = rhs.iwarm_period;
   //
   // This should actually never be called
   //
@@ -130,14 +127,10 @@ launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::launchmon_base_t()
       toollauncherpid(-1),
       FE_sockfd(-1),
       API_mode(false),
+      rpdtab_enc(lmon_rpdtab_legacy),
+      rpdtab_chunk(0),
       MODULENAME(
-          self_trace_t::self_trace().launchmon_module_trace.module_name) {
-  char *warm_interval;
-  last_seen = gettimeofdayD();
-  warm_period = DefaultWarmPeriods;
-  warm_interval = getenv("LMON_ENGINE_WARM_INTERVAL");
-  if (warm_interval) warm_period = (double)atoi(warm_interval);
-}
+          self_trace_t::self_trace().launchmon_module_trace.module_name) {}
 
 //!
 /*!  launchmon_base_t<> destructor
@@ -148,26 +141,7 @@ template <SDBG_DEFAULT_TEMPLATE_WIDTH>
 launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::~launchmon_base_t() {
   if (tracer) delete tracer;
 
-  if (!proctable_copy.empty()) {
-    std::map<std::string, std::vector<MPIR_PROCDESC_EXT *> >::iterator iter;
-    for (iter = proctable_copy.begin(); iter != proctable_copy.end(); ++iter) {
-      if (!(iter->second.empty())) {
-        std::vector<MPIR_PROCDESC_EXT *>::iterator viter;
-        for (viter = iter->second.begin(); viter != iter->second.end();
-             ++viter) {
-          if ((*viter)->pd.host_name) {
-            free((*viter)->pd.host_name);
-          }
-
-          if ((*viter)->pd.executable_name) {
-            free((*viter)->pd.executable_name);
-          }
-          free(*viter);
-        }
-      }
-    }
-    proctable_copy.clear();
-  }
+  proctable_copy.clear();
 }
 
 //!
@@ -303,6 +277,7 @@ launchmon_rc_e launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::invoke_handler(
     process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p, const launchmon_event_e ev,
     const int data) {
   launchmon_rc_e rc = LAUNCHMON_FAILED;
+  uint64_t begin = engine_stats_t::stats().take_event_begin();
 
   switch (ev) {
     //
@@ -412,6 +387,8 @@ launchmon_rc_e launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::invoke_handler(
       break;
   }
 
+  engine_stats_t::stats().record_event((int)ev, begin);
+
   return rc;
 }
 
@@ -460,107 +437,186 @@ launchmon_rc_e launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::ship_proctab_msg(
     return LAUNCHMON_FAILED;
   }
 
-  map<string, unsigned int> execHostName;
-  vector<char *> orderedEHName;
-  map<string, vector<MPIR_PROCDESC_EXT *> >::const_iterator pos;
-  vector<MPIR_PROCDESC_EXT *>::const_iterator vpos;
-  vector<char *>::const_iterator EHpos;
-  unsigned int offset = 0;
+  if (get_rpdtab_chunk() > 0 && proctable_copy.size() > get_rpdtab_chunk()) {
+    return ship_proctab_stream();
+  }
+
   unsigned int num_unique_exec = 0;
   unsigned int num_unique_hn = 0;
+  size_t payloadsize;
   int msgsize;
 
-  //
-  // Establishing a map and an ordered vector to pack a string table
-  //
-  for (pos = proctable_copy.begin(); pos != proctable_copy.end(); ++pos) {
-    for (vpos = pos->second.begin(); vpos != pos->second.end(); ++vpos) {
-      map<string, unsigned int>::const_iterator finditer;
-      finditer = execHostName.find(string((*vpos)->pd.executable_name));
-      if (finditer == execHostName.end()) {
-        execHostName[string((*vpos)->pd.executable_name)] = offset;
-        orderedEHName.push_back((*vpos)->pd.executable_name);
-        num_unique_exec++;
-        offset += (strlen((*vpos)->pd.executable_name) + 1);
-      }
-
-      finditer = execHostName.find(string((*vpos)->pd.host_name));
-      if (finditer == execHostName.end()) {
-        execHostName[string((*vpos)->pd.host_name)] = offset;
-        orderedEHName.push_back((*vpos)->pd.host_name);
-        num_unique_hn++;
-        offset += (strlen((*vpos)->pd.host_name) + 1);
-      }
-    }
-  }
-
   //
   // This message can be rather long as the size is
   // an lmonp header size + (N_Fields_MPIR_PROCDESC_EXT x sizeof(int)
   // per-task entry for each task + the string table size.
   // The fixed per-task entry consists of exec index,
   // hostname index, pid, and rank, and cnodeid, each of which
-  // is sizeof(int).
+  // is sizeof(int). The buffer is sized for the worst case
+  // and the table is serialized into it in a single pass.
   //
-  msgsize = sizeof(lmonp_t) +
-            N_Fields_MPIR_PROCDESC_EXT * sizeof(int) * pcount + offset;
-  lmonp_t *sendbuf = (lmonp_t *)malloc(msgsize);
-  memset(sendbuf, 0, msgsize);
+  size_t bufsize = sizeof(lmonp_t) + proctable_copy.rpdtab_size_bound();
+  lmonp_t *sendbuf = (lmonp_t *)malloc(bufsize);
+  if (!sendbuf) {
+    self_trace_t::trace(true, MODULENAME, 1, "Out of memory!");
+    return LAUNCHMON_FAILED;
+  }
+  memset(sendbuf, 0, bufsize);
+
+  //
+  // The header isn't set yet, so get_lmonpayload_begin can't be used
+  //
+  payloadsize = proctable_copy.serialize_rpdtab(
+      (char *)sendbuf + sizeof(lmonp_t), &num_unique_exec, &num_unique_hn);
+  msgsize = sizeof(lmonp_t) + payloadsize;
+
   if (pcount < LMON_NTASKS_THRE) {
     set_msg_header((lmonp_t *)sendbuf, lmonp_fetofe, (int)t, pcount, 0,
-                   num_unique_exec, num_unique_hn, 0,
-                   (N_Fields_MPIR_PROCDESC_EXT * sizeof(int) * pcount) + offset,
-                   0);
+                   num_unique_exec, num_unique_hn, 0, payloadsize, 0);
   } else {
     set_msg_header((lmonp_t *)sendbuf, lmonp_fetofe, (int)t, LMON_NTASKS_THRE,
-                   0, num_unique_exec, num_unique_hn, pcount,
-                   (N_Fields_MPIR_PROCDESC_EXT * sizeof(int) * pcount) + offset,
-                   0);
+                   0, num_unique_exec, num_unique_hn, pcount, payloadsize, 0);
+  }
+
+  //
+  // Re-encoding it if the FE API asked for a compact RPDTAB
+  //
+  lmonp_t *cmptbuf = NULL;
+  int cmptsize = 0;
+  if (get_rpdtab_enc() != lmon_rpdtab_legacy) {
+    cmptbuf = compact_RPDTAB_msg(sendbuf, get_rpdtab_enc(), &cmptsize);
+  }
+
+  if (cmptbuf) {
+    write_lmonp_long_msg(get_FE_sockfd(), cmptbuf, cmptsize);
+  } else {
+    write_lmonp_long_msg(get_FE_sockfd(), (lmonp_t *)sendbuf, msgsize);
+  }
+
+  {
+    self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                        "a proctable message shipped out (%d bytes, %s)",
+                        cmptbuf ? cmptsize : msgsize,
+                        cmptbuf ? "compact" : "legacy");
+  }
+
+  if (cmptbuf) free(cmptbuf);
+  free(sendbuf);
+
+  return LAUNCHMON_OK;
+}
+
+//! launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::ship_proctab_stream
+/*!
+    streams the proctable to the FE API stub in place of a single
+    lmonp_proctable_avail message:
+
+    lmonp_proctable_begin carries the job size in its header and the
+    host names, NULL-terminated and in host order, as its payload so
+    that the FE can get daemon launching under way.
+
+    Each lmonp_proctable_chunk carries {first task, task count} as two
+    uint32_t followed by the legacy RPDTAB entries of those tasks and
+    the part of the string table they reference first. Entries index
+    into the whole string table.
+
+    lmonp_proctable_end carries the header the whole legacy message
+    would have had, but no payload.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+launchmon_rc_e
+launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::ship_proctab_stream() {
+  const size_t entry_size = N_Fields_MPIR_PROCDESC_EXT * sizeof(unsigned int);
+  size_t chunk = get_rpdtab_chunk();
+  size_t hostlen = 0;
+  size_t bufsize;
+  size_t h;
+  unsigned int nchunks = 0;
+  unsigned short ntasks_short;
+  unsigned int ntasks_long;
+  proctab_t::rpdtab_cursor_t cursor;
+  lmonp_t *sendbuf;
+  char *payload;
+
+  for (h = 0; h < proctable_copy.num_hosts(); ++h) {
+    hostlen += strlen(proctable_copy.host_name(h)) + 1;
   }
 
-  char *payload_cp_ptr = get_lmonpayload_begin(sendbuf);
+  bufsize = 2 * sizeof(uint32_t) + chunk * entry_size +
+            proctable_copy.arena_size();
+  if (bufsize < hostlen) bufsize = hostlen;
+
+  sendbuf = (lmonp_t *)malloc(sizeof(lmonp_t) + bufsize);
+  if (!sendbuf) {
+    self_trace_t::trace(true, MODULENAME, 1, "Out of memory!");
+    return LAUNCHMON_FAILED;
+  }
+  payload = (char *)sendbuf + sizeof(lmonp_t);
+
+  if (pcount < LMON_NTASKS_THRE) {
+    ntasks_short = pcount;
+    ntasks_long = 0;
+  } else {
+    ntasks_short = LMON_NTASKS_THRE;
+    ntasks_long = pcount;
+  }
 
   //
-  // Serializing the process table into a send buffer.
-  // Number of memcpy must be equal to N_Fields_MPIR_PROCDESC_EXT
+  // BEGIN: the host list
   //
-  for (pos = proctable_copy.begin(); pos != proctable_copy.end(); ++pos) {
-    for (vpos = pos->second.begin(); vpos != pos->second.end(); ++vpos) {
-      memcpy((void *)payload_cp_ptr,
-             (void *)&(execHostName[string((*vpos)->pd.host_name)]),
-             sizeof(unsigned int));
-      payload_cp_ptr += sizeof(unsigned int);
-
-      memcpy((void *)payload_cp_ptr,
-             (void *)&(execHostName[string((*vpos)->pd.executable_name)]),
-             sizeof(unsigned int));
-      payload_cp_ptr += sizeof(unsigned int);
-
-      memcpy((void *)payload_cp_ptr, (void *)&((*vpos)->pd.pid), sizeof(int));
-      payload_cp_ptr += sizeof(int);
-
-      memcpy((void *)payload_cp_ptr, (void *)&((*vpos)->mpirank), sizeof(int));
-      payload_cp_ptr += sizeof(int);
-
-      memcpy((void *)payload_cp_ptr, (void *)&((*vpos)->cnodeid), sizeof(int));
-      payload_cp_ptr += sizeof(int);
-    }
+  char *hp = payload;
+  for (h = 0; h < proctable_copy.num_hosts(); ++h) {
+    size_t leng = strlen(proctable_copy.host_name(h)) + 1;
+    memcpy(hp, proctable_copy.host_name(h), leng);
+    hp += leng;
   }
 
+  set_msg_header(sendbuf, lmonp_fetofe, (int)lmonp_proctable_begin,
+                 ntasks_short, 0, 0, proctable_copy.num_hosts(), ntasks_long,
+                 hostlen, 0);
+  write_lmonp_long_msg(get_FE_sockfd(), sendbuf, sizeof(lmonp_t) + hostlen);
+
   //
-  // serializing the string table into the send buffer.
+  // CHUNKs: the entries and the new strings of the next chunk tasks
   //
-  for (EHpos = orderedEHName.begin(); EHpos != orderedEHName.end(); ++EHpos) {
-    int leng = strlen((*EHpos)) + 1;
-    memcpy((void *)payload_cp_ptr, (void *)(*EHpos), leng);
-    payload_cp_ptr += leng;
+  proctable_copy.begin_rpdtab(cursor);
+  while (cursor.next_task < proctable_copy.size()) {
+    uint32_t first = (uint32_t)cursor.next_task;
+    uint32_t count = (uint32_t)chunk;
+    char *entries = payload + 2 * sizeof(uint32_t);
+    size_t strlen_chunk;
+    size_t payloadsize;
+
+    if (first + count > proctable_copy.size()) {
+      count = (uint32_t)(proctable_copy.size() - first);
+    }
+
+    memcpy(payload, &first, sizeof(first));
+    memcpy(payload + sizeof(first), &count, sizeof(count));
+    strlen_chunk = proctable_copy.serialize_rpdtab_chunk(
+        cursor, count, entries, entries + count * entry_size);
+    payloadsize = 2 * sizeof(uint32_t) + count * entry_size + strlen_chunk;
+
+    set_msg_header(sendbuf, lmonp_fetofe, (int)lmonp_proctable_chunk, 0, 0, 0,
+                   0, 0, payloadsize, 0);
+    write_lmonp_long_msg(get_FE_sockfd(), sendbuf,
+                         sizeof(lmonp_t) + payloadsize);
+    nchunks++;
   }
 
-  write_lmonp_long_msg(get_FE_sockfd(), (lmonp_t *)sendbuf, msgsize);
+  //
+  // END: the header of the whole proctable
+  //
+  set_msg_header(sendbuf, lmonp_fetofe, (int)lmonp_proctable_end, ntasks_short,
+                 0, cursor.num_unique_exec, cursor.num_unique_hn, ntasks_long,
+                 0, 0);
+  write_lmonp_long_msg(get_FE_sockfd(), sendbuf, sizeof(lmonp_t));
 
   {
     self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
-                        "a proctable message shipped out");
+                        "a proctable stream shipped out (%u chunks, %u "
+                        "string table bytes)",
+                        nchunks, cursor.strtab_len);
   }
 
   free(sendbuf);
@@ -675,6 +731,50 @@ launchmon_rc_e launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::ship_rminfo_msg(
   return LAUNCHMON_OK;
 }
 
+//! launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::ship_stats_msg
+/*!
+    sends an lmonp_t packet with {msgclass=lmonp_fetofe:
+    type.fetofe_type=lmonp_stats:
+    lmon_payload_length=sizeof(lmon_engine_stats_t)}
+    carrying a snapshot of engine_stats_t to the FE API stub.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+launchmon_rc_e launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::ship_stats_msg(
+    lmonp_fe_to_fe_msg_e t) {
+  lmonp_t msg;
+  int msgsize;
+  char *sendbuf;
+
+  if (!get_API_mode()) {
+    self_trace_t::trace(LEVELCHK(level3), MODULENAME, 0,
+                        "standalone mode does not ship statistics via LMONP");
+    return LAUNCHMON_FAILED;
+  }
+
+  init_msg_header(&msg);
+  msg.msgclass = lmonp_fetofe;
+  msg.type.fetofe_type = t;
+  msg.lmon_payload_length = sizeof(lmon_engine_stats_t);
+  msgsize = sizeof(msg) + msg.lmon_payload_length + msg.usr_payload_length;
+  sendbuf = (char *)malloc(msgsize);
+  if (sendbuf == NULL) return LAUNCHMON_FAILED;
+
+  memcpy(sendbuf, &msg, sizeof(msg));
+  memcpy(sendbuf + sizeof(msg), &(engine_stats_t::stats().snapshot()),
+         sizeof(lmon_engine_stats_t));
+
+  write_lmonp_long_msg(get_FE_sockfd(), (lmonp_t *)sendbuf, msgsize);
+
+  {
+    self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                        "a stats message shipped out");
+  }
+
+  free(sendbuf);
+
+  return LAUNCHMON_OK;
+}
+
 //! handle_incoming_socket_event
 /*!
   handles an lmonp_t packet received from the FE API stub.
@@ -686,8 +786,6 @@ launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::handle_incoming_socket_event(
   try {
     struct pollfd fds[1];
     int pollret;
-    int timeout = 0;
-    double timestamp;
 
     if (!get_API_mode()) {
       self_trace_t::trace(
@@ -699,18 +797,14 @@ launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::handle_incoming_socket_event(
 
     //
     // poll should return positive ret code only when one or more messages
-    // reported onto this file descriptor.
+    // reported onto this file descriptor. The event manager has already
+    // waited for the socket, so this never blocks.
     //
     fds[0].fd = get_FE_sockfd();
     fds[0].events = POLLIN;
-    // fds[0].events = POLLRDBAND;
-
-    timestamp = gettimeofdayD();
-    if (timestamp > (last_seen + warm_period))
-      timeout = 10; /* 10 milisecond blocking if no event */
 
     do {
-      pollret = poll(fds, 1, timeout);
+      pollret = poll(fds, 1, 0);
     } while ((pollret < 0) && (errno == EINTR));
 
     if (pollret > 0) {
@@ -802,6 +896,12 @@ launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::handle_incoming_socket_event(
             request_cont_launch_bp(p);
             break;
           }
+          case lmonp_stats_req: {
+            self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                                "front-end requested statistics...");
+            ship_stats_msg(lmonp_stats);
+            break;
+          }
           default: {
             self_trace_t::trace(LEVELCHK(level1), MODULENAME, 1,
                                 "ill-formed msg");
@@ -871,7 +971,6 @@ launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>::handle_daemon_exit_event(
       request_detach(p, RM_BE_daemon_exited);
     }
 
-    set_last_seen(gettimeofdayD());
     return LAUNCHMON_OK;
   } catch (symtab_exception_t e) {
     e.report();
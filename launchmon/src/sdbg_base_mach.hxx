@@ -122,6 +122,21 @@ class register_set_base_t {
   void set_writable_mask(unsigned int m) { writable_mask = m; }
   virtual void set_pc(VA p) {}
 
+  //
+  // emulates the len-byte-long instruction insn at address at
+  // on this register set instead of single-stepping it;
+  // ret_addr is the return address get_ret_addr or
+  // get_memloc_for_ret_addr leads to. If the instruction
+  // stores to memory, the nstore (at most two) words in
+  // store go to store_addr. Returns false if the instruction isn't one
+  // that can be emulated, leaving the register set intact.
+  //
+  virtual bool emulate_bp_insn(VA at, const unsigned char *insn, size_t len,
+                               VA ret_addr, VA &store_addr, WT *store,
+                               int &nstore) {
+    return false;
+  }
+
   void inc_ptr_by_word() { rs_ptr++; }
   void write_word_to_ptr(WT w) { (*rs_ptr) = w; }
   unsigned int size_in_word();
@@ -369,6 +384,9 @@ class process_base_t {
   // define_gset(int,key_to_thread_context)
   define_gset(int64_t, rid)
   define_gset(int, new_child_pid)
+  define_gset(VA, link_map_tail)
+  define_gset(VA, link_map_tail_name)
+  define_gset(bool, loader_bp_retired)
   int get_cur_thread_ctx();
 
  protected:
@@ -410,6 +428,16 @@ class process_base_t {
 
   symbol_base_t<VA> *sym_attach_fifo;
 
+  //
+  // the last link_map node the loader event handler visited and
+  // its l_name, so that the next loader event only scans the
+  // objects appended since. Once every dependent SO is found,
+  // the loader breakpoint is retired for good.
+  //
+  VA link_map_tail;
+  VA link_map_tail_name;
+  bool loader_bp_retired;
+
   //
   // launcher/debugger ABI symbols
   //
@@ -316,6 +316,9 @@ process_base_t<SDBG_DEFAULT_TEMPLPARAM>::process_base_t()
       launch_hidden_bp(NULL),
       loader_hidden_bp(NULL),
       sym_attach_fifo(NULL),
+      link_map_tail(0),
+      link_map_tail_name(0),
+      loader_bp_retired(false),
       new_child_pid(0) {
   /* more init ? */
 }
@@ -203,6 +203,10 @@ class image_base_t {
   symtab_error_e init(const std::string &lib) throw(symtab_exception_t);
   virtual symtab_error_e init() throw(symtab_exception_t) = 0;
   virtual symtab_error_e read_linkage_symbols() throw(symtab_exception_t) = 0;
+  virtual symbol_base_t<VA> *lookup_linkage_symbol(
+      const std::string &key) const {
+    return NULL;
+  }
   virtual symtab_error_e fetch_DSO_info(std::string &,
                                         bool &) throw(symtab_exception_t) = 0;
   // virtual symtab_error_e read_debug_symbols()
@@ -222,7 +226,11 @@ class image_base_t {
   }
 
  protected:
-  std::map<std::string, symbol_base_t<VA> *, ltstr> linkage_symtab;
+  //
+  // linkage symbols are resolved on demand through
+  // lookup_linkage_symbol and memoized here
+  //
+  mutable std::map<std::string, symbol_base_t<VA> *, ltstr> linkage_symtab;
   std::map<std::string, symbol_base_t<VA> *, ltstr> debug_symtab;
   std::map<std::string, std::string, ltstr> dso_list;
 
@@ -239,6 +247,7 @@ class image_base_t {
   std::string path;
   VA image_base_address;
   EXECHANDLER *native_exec_handler;
+  symbol_base_t<VA> undefined_symbol;
 };
 
 #endif  // SDBG_BASE_SYMTAB_HXX
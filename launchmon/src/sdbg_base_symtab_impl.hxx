@@ -269,19 +269,32 @@ EXECHANDLER *image_base_t<BASE_IMAGE_TEMPLPARAM>::get_native_exec_handler() {
 
 //! PUBLIC: image_base_t<VA>::get_a_symbol
 /*!
-    returns the matching linkage symbol object
+    returns the matching linkage symbol object. A symbol not
+    seen before is resolved through lookup_linkage_symbol and
+    memoized, relocated if the image base is already known.
+    Unknown symbols yield an uninitialized symbol.
  */
 template <BASE_IMAGE_TEMPLATELIST>
 const symbol_base_t<BASE_SYMTAB_TEMPLPARAM>
     &image_base_t<BASE_IMAGE_TEMPLPARAM>::get_a_symbol(
         const std::string &key) const {
+  typename std::map<std::string, symbol_base_t<VA> *, ltstr>::const_iterator
+      pos = linkage_symtab.find(key);
   symbol_base_t<BASE_SYMTAB_TEMPLPARAM> *rsym = NULL;
 
-  if (linkage_symtab.find(key.c_str()) != linkage_symtab.end()) {
-    rsym = linkage_symtab.find(key.c_str())->second;
-  } else {
-    rsym = new symbol_base_t<BASE_SYMTAB_TEMPLPARAM>();
+  if (pos != linkage_symtab.end()) {
+    return *(pos->second);
   }
+
+  if (!(rsym = lookup_linkage_symbol(key))) {
+    return undefined_symbol;
+  }
+
+  if (image_base_address != SYMTAB_INIT_IMAGE_BASE) {
+    rsym->set_relocated_address(rsym->get_raw_address() + image_base_address);
+  }
+  linkage_symtab.insert(std::make_pair(key, rsym));
+
   return (*rsym);
 }
 
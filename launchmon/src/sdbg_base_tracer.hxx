@@ -44,6 +44,7 @@
 #define SDBG_BASE_TRACER_HXX
 
 #include <iostream>
+#include <vector>
 #include "sdbg_base_bp.hxx"
 #include "sdbg_base_exception.hxx"
 #include "sdbg_base_mach.hxx"
@@ -82,6 +83,18 @@ enum tracer_error_e {
   SDBG_TRACE_FAILED
 };
 
+//! struct tracer_patch_t
+/*!
+    one element of a batched write: size bytes at buf are written to
+    addr of the target process.
+*/
+template <typename VA>
+struct tracer_patch_t {
+  VA addr;
+  const void *buf;
+  size_t size;
+};
+
 ////////////////////////////////////////////////////////////////////////////
 //
 //
@@ -186,6 +199,11 @@ class tracer_base_t {
       process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p, VA addr, const void *buf,
       int size, bool use_cxt) throw(tracer_exception_t) = 0;
 
+  virtual tracer_error_e tracer_write_batch(
+      process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p,
+      const std::vector<tracer_patch_t<VA> > &patches,
+      bool use_cxt) throw(tracer_exception_t) = 0;
+
   virtual tracer_error_e tracer_continue(
       process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p,
       bool use_cxt) throw(tracer_exception_t) = 0;
@@ -237,6 +255,16 @@ class tracer_base_t {
       process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p, breakpoint_base_t<VA, IT> &bp,
       bool use_cxt, bool change_state = true) throw(tracer_exception_t) = 0;
 
+  virtual tracer_error_e enable_breakpoints(
+      process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p,
+      std::vector<breakpoint_base_t<VA, IT> *> &bps, bool use_cxt,
+      bool change_state = true) throw(tracer_exception_t) = 0;
+
+  virtual tracer_error_e disable_breakpoints(
+      process_base_t<SDBG_DEFAULT_TEMPLPARAM> &p,
+      std::vector<breakpoint_base_t<VA, IT> *> &bps, bool use_cxt,
+      bool change_state = true) throw(tracer_exception_t) = 0;
+
   virtual tracer_error_e convert_error_code(int err) throw(
       tracer_exception_t) = 0;
 };
@@ -0,0 +1,146 @@
+/*
+ *--------------------------------------------------------------------------------
+ * Copyright (c) 2008, Lawrence Livermore National Security, LLC. Produced at
+ * the Lawrence Livermore National Laboratory. Written by Dong H. Ahn
+ * <ahn1@llnl.gov>. LLNL-CODE-409469. All rights reserved.
+ *
+ * This file is part of LaunchMON. For details, see
+ * https://computing.llnl.gov/?set=resources&page=os_projects
+ *
+ * Please also read LICENSE.txt -- Our Notice and GNU Lesser General Public
+ * License.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the terms and conditions of the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple
+ * Place, Suite 330, Boston, MA 02111-1307 USA
+ *--------------------------------------------------------------------------------
+ */
+
+#ifndef HAVE_LAUNCHMON_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <time.h>
+
+#include "sdbg_engine_stats.hxx"
+
+//
+// in the order of launchmon_event_e in sdbg_base_launchmon.hxx
+//
+static const char *launchmon_event_str[] = {
+    "LM_HIT_A_BP",
+    "LM_STOP_AT_LAUNCH_BP",
+    "LM_STOP_AT_FIRST_EXEC",
+    "LM_STOP_AT_FIRST_ATTACH",
+    "LM_STOP_AT_LOADER_BP",
+    "LM_STOP_AT_THREAD_CREATION",
+    "LM_STOP_NEW_THREAD_TRACE",
+    "LM_STOP_NEW_FORKED_PROCESS",
+    "LM_STOP_NOT_INTERESTED",
+    "LM_STOP_FOR_DETACH",
+    "LM_STOP_FOR_KILL",
+    "LM_REQUEST_NEW_THREAD",
+    "LM_RELAY_SIGNAL",
+    "LM_TERMINATED",
+    "LM_EXITED"};
+
+//! PRIVATE: engine_stats_t
+/*!
+    default constructor
+*/
+engine_stats_t::engine_stats_t() : ev_begin(0) {
+  unsigned int i;
+
+  memset(&data, 0, sizeof(data));
+  data.num_events = sizeof(launchmon_event_str) / sizeof(launchmon_event_str[0]);
+  for (i = 0; i < data.num_events; ++i) {
+    strncpy(data.events[i].name, launchmon_event_str[i],
+            LMON_STATS_EVENT_NAME_LEN - 1);
+  }
+}
+
+//! PUBLIC: stats
+/*!
+    returns the engine-wide instance
+*/
+engine_stats_t &engine_stats_t::stats() {
+  static engine_stats_t s;
+  return s;
+}
+
+//! PUBLIC: now_usec
+/*!
+    monotonic clock in microseconds
+*/
+uint64_t engine_stats_t::now_usec() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+//! PUBLIC: take_event_begin
+/*!
+    returns the time begin_event marked and clears it, or the
+    current time if no event is pending. A handler invoked without
+    a fresh waitpid event is thus timed from its own start.
+*/
+uint64_t engine_stats_t::take_event_begin() {
+  uint64_t b = ev_begin;
+
+  ev_begin = 0;
+  return b ? b : now_usec();
+}
+
+//! PUBLIC: bucket_of
+/*!
+    maps a latency to its histogram bucket: the inverse of
+    LMON_stats_bucket_floor
+*/
+int engine_stats_t::bucket_of(uint64_t usec) {
+  const int sub = 1 << LMON_STATS_SUB_BITS;
+  int mag = 0;
+  int b;
+
+  if (usec < (uint64_t)sub) return (int)usec;
+
+  while ((usec >> mag) > 1) mag++;
+  b = (mag - LMON_STATS_SUB_BITS + 1) * sub +
+      (int)((usec >> (mag - LMON_STATS_SUB_BITS)) & (sub - 1));
+
+  return (b < LMON_STATS_NUM_BUCKETS) ? b : LMON_STATS_NUM_BUCKETS - 1;
+}
+
+//! PUBLIC: record_event
+/*!
+    charges the time since begin to event type ev
+*/
+void engine_stats_t::record_event(int ev, uint64_t begin) {
+  if (ev < 0 || ev >= (int)data.num_events) return;
+
+  uint64_t now = now_usec();
+  uint64_t lat = (now > begin) ? now - begin : 0;
+  lmon_event_stats_t &e = data.events[ev];
+
+  if (e.count == 0 || lat < e.min_usec) e.min_usec = lat;
+  if (lat > e.max_usec) e.max_usec = lat;
+  e.count++;
+  e.sum_usec += lat;
+  e.buckets[bucket_of(lat)]++;
+}
+
+/*
+ * ts=2 sw=2 expandtab
+ */
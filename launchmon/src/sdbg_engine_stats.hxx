@@ -0,0 +1,112 @@
+/*
+ *--------------------------------------------------------------------------------
+ * Copyright (c) 2008, Lawrence Livermore National Security, LLC. Produced at
+ * the Lawrence Livermore National Laboratory. Written by Dong H. Ahn
+ * <ahn1@llnl.gov>. LLNL-CODE-409469. All rights reserved.
+ *
+ * This file is part of LaunchMON. For details, see
+ * https://computing.llnl.gov/?set=resources&page=os_projects
+ *
+ * Please also read LICENSE.txt -- Our Notice and GNU Lesser General Public
+ * License.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the terms and conditions of the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple
+ * Place, Suite 330, Boston, MA 02111-1307 USA
+ *--------------------------------------------------------------------------------
+ */
+
+#ifndef SDBG_ENGINE_STATS_HXX
+#define SDBG_ENGINE_STATS_HXX 1
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lmon_api/lmon_api_std.h>
+
+//! class engine_stats_t
+/*!
+    always-on instrumentation of the engine: per launchmon_event_e
+    handler latency histograms and counters of the ptrace calls and
+    memory reads issued against traced processes. A single instance,
+    reached through stats(), is shipped to the FE as an
+    lmon_engine_stats_t.
+
+    The event manager calls begin_event when waitpid reports an
+    event; invoke_handler then charges the time until its handler
+    returns to that event type.
+*/
+class engine_stats_t {
+ public:
+  static engine_stats_t &stats();
+  static uint64_t now_usec();
+
+  void begin_event() { ev_begin = now_usec(); }
+  uint64_t take_event_begin();
+  void record_event(int ev, uint64_t begin);
+
+  void count_ptrace() { data.ptrace_calls++; }
+  void count_peek(size_t bytes) { data.bytes_read += bytes; }
+  void count_mem_read(size_t bytes) {
+    data.mem_read_calls++;
+    data.bytes_read += bytes;
+  }
+  void count_mem_reads(size_t calls, size_t bytes) {
+    data.mem_read_calls += calls;
+    data.bytes_read += bytes;
+  }
+  void count_poke(size_t bytes) { data.bytes_written += bytes; }
+  void count_mem_write(size_t bytes) {
+    data.mem_write_calls++;
+    data.bytes_written += bytes;
+  }
+  void count_regs_cache(bool hit) {
+    if (hit) {
+      data.regs_cache_hits++;
+    } else {
+      data.regs_cache_misses++;
+    }
+  }
+  void count_mem_cache(bool hit) {
+    if (hit) {
+      data.mem_cache_hits++;
+    } else {
+      data.mem_cache_misses++;
+    }
+  }
+  void count_cache_incoherent() { data.cache_incoherent++; }
+  void count_thread_detached() { data.threads_detached++; }
+  void count_bp_stepover(bool emulated) {
+    if (emulated) {
+      data.bp_emulated++;
+    } else {
+      data.bp_singlestepped++;
+    }
+  }
+
+  static int bucket_of(uint64_t usec);
+  const lmon_engine_stats_t &snapshot() const { return data; }
+
+ private:
+  engine_stats_t();
+
+  lmon_engine_stats_t data;
+  uint64_t ev_begin;
+};
+
+#endif  // SDBG_ENGINE_STATS_HXX
+
+/*
+ * ts=2 sw=2 expandtab
+ */
@@ -70,6 +70,11 @@ class event_manager_t {
                       launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM> &lm);
 
  private:
+  bool init_reactor(launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM> &lm);
+  void wait_for_events(launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM> &lm);
+  bool is_launcher_thread(process_base_t<SDBG_DEFAULT_TEMPLPARAM> &proc,
+                          pid_t tid);
+
   bool LEVELCHK(self_trace_verbosity level) {
     return (self_trace_t::self_trace().event_module_trace.verbosity_level >=
             level);
@@ -84,6 +89,17 @@ class event_manager_t {
   // std::list <process_base_t<SDBG_DEFAULT_TEMPLPARAM>* > proclist;
   monitor_proc_thread_t<SDBG_DEFAULT_TEMPLPARAM> *ev_monitor;
 
+  //
+  // The reactor: an epoll set over the FE socket and a signalfd
+  // for SIGCHLD, which covers every traced task and the tool
+  // launcher. proc_pending is true while the last waitpid round
+  // may have left process events behind.
+  //
+  bool reactor_ready;
+  int reactor_fd;
+  int sigchld_fd;
+  bool proc_pending;
+
   //
   // For self tracing
   //
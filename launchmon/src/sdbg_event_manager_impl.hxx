@@ -61,6 +61,19 @@ extern "C" {
 #else
 #error sys/wait.h is required
 #endif
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#if HAVE_SYS_EPOLL_H && HAVE_SYS_SIGNALFD_H
+#define SDBG_EVENT_REACTOR 1
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#endif
 }
 
 #if HAVE_MAP
@@ -77,6 +90,7 @@ extern "C" {
 
 #include "sdbg_base_mach.hxx"
 #include "sdbg_base_mach_impl.hxx"
+#include "sdbg_engine_stats.hxx"
 #include "sdbg_event_manager.hxx"
 
 ////////////////////////////////////////////////////////////////////
@@ -128,6 +142,7 @@ bool monitor_proc_thread_t<SDBG_DEFAULT_TEMPLPARAM>::wait_for_all(
     return rs;
   }
 
+  engine_stats_t::stats().begin_event();
   rc.set_en(entity);
   rc.set_id(rpid);
 
@@ -171,8 +186,13 @@ bool monitor_proc_thread_t<SDBG_DEFAULT_TEMPLPARAM>::wait_for_all(
 
 */
 template <SDBG_DEFAULT_TEMPLATE_WIDTH>
-event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::event_manager_t() {
+event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::event_manager_t()
+    : reactor_ready(false),
+      reactor_fd(-1),
+      sigchld_fd(-1),
+      proc_pending(true) {
   ev_monitor = new monitor_proc_thread_t<SDBG_DEFAULT_TEMPLPARAM>();
+  MODULENAME = self_trace_t::self_trace().event_module_trace.module_name;
 }
 
 template <SDBG_DEFAULT_TEMPLATE_WIDTH>
@@ -180,11 +200,26 @@ event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::event_manager_t(
     const event_manager_t& e) {
   ev_monitor = e.ev_monitor;
   MODULENAME = e.MODULENAME;
+  reactor_ready = false;
+  reactor_fd = -1;
+  sigchld_fd = -1;
+  proc_pending = true;
 }
 
 template <SDBG_DEFAULT_TEMPLATE_WIDTH>
 event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::~event_manager_t() {
   if (ev_monitor) delete ev_monitor;
+
+#if SDBG_EVENT_REACTOR
+  if (reactor_fd >= 0) close(reactor_fd);
+  if (sigchld_fd >= 0) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    close(sigchld_fd);
+    sigprocmask(SIG_UNBLOCK, &mask, NULL);
+  }
+#endif
 }
 
 //! PUBLIC: poll_processes
@@ -202,7 +237,28 @@ bool event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::poll_processes(
   launchmon_rc_e rc = LAUNCHMON_OK;
   launchmon_event_e ev;
 
-  if (ev_monitor->wait_for_all(event)) {
+  bool got_event = ev_monitor->wait_for_all(event);
+
+  //
+  // a reaped child of any kind means more may be queued
+  //
+  proc_pending = (event.get_id() > 0);
+
+  if (got_event) {
+    //
+    // Since Linux 4.7, waitpid reports traced clone children
+    // without __WCLONE, so a launcher thread can come back as a
+    // process. Left that way, it would be taken for a forked
+    // child and have the breakpoints it shares with the launcher
+    // pulled out.
+    //
+    if ((event.get_en() == EV_ENTITY_PROCESS) &&
+        (event.get_id() != p.get_pid(false)) &&
+        (event.get_id() != lm.get_toollauncherpid()) &&
+        is_launcher_thread(p, event.get_id())) {
+      event.set_en(EV_ENTITY_THREAD);
+    }
+
     if (event.get_en() == EV_ENTITY_PROCESS) {
       //
       // A process event is reported
@@ -287,7 +343,10 @@ bool event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::poll_FE_socket(
 
 //! PUBLIC: multiplex_events
 /*!
-
+    waits until the FE socket or a traced task has something to
+    report, then dispatches it. The wait is skipped while the last
+    round reaped a process event, since a single SIGCHLD can stand
+    for several stopped tasks and each round consumes only one.
 */
 template <SDBG_DEFAULT_TEMPLATE_WIDTH>
 bool event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::multiplex_events(
@@ -295,6 +354,17 @@ bool event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::multiplex_events(
     launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>& lm) {
   bool rc = true;
 
+  if (!reactor_ready) {
+    //
+    // Children may have changed state before SIGCHLD got routed
+    // to the signalfd; make the first round look for them.
+    //
+    init_reactor(lm);
+    proc_pending = true;
+  }
+
+  if (!proc_pending) wait_for_events(lm);
+
   rc = poll_FE_socket(proc, lm);
   if (rc) {
     //
@@ -306,6 +376,154 @@ bool event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::multiplex_events(
 
   return (rc);
 }
+////////////////////////////////////////////////////////////////////
+//
+// PRIVATE INTERFACES: event_manager_t
+//
+///////////////////////////////////////////////////////////////////
+
+//! PRIVATE: is_launcher_thread
+/*!
+    returns true if tid is a thread of the launcher: one already on
+    its thread list, or a new one whose thread group, as listed in
+    /proc/<tid>/status, is the launcher's.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+bool event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::is_launcher_thread(
+    process_base_t<SDBG_DEFAULT_TEMPLPARAM>& proc, pid_t tid) {
+  char path[64];
+  char line[128];
+  FILE* fp;
+  int tgid = -1;
+
+  if (proc.get_thrlist().find(tid) != proc.get_thrlist().end()) return true;
+
+  snprintf(path, sizeof(path), "/proc/%d/status", (int)tid);
+  if ((fp = fopen(path, "r")) == NULL) return false;
+
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    if (sscanf(line, "Tgid: %d", &tgid) == 1) break;
+  }
+  fclose(fp);
+
+  return (tgid == (int)proc.get_pid(false));
+}
+
+//! PRIVATE: init_reactor
+/*!
+    blocks SIGCHLD and routes it to a signalfd, then puts the
+    signalfd and, in API mode, the FE socket into an epoll set.
+    Returns false if the reactor is unavailable, in which case
+    wait_for_events falls back to a timed poll of the FE socket.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+bool event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::init_reactor(
+    launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>& lm) {
+  reactor_ready = true;
+
+#if SDBG_EVENT_REACTOR
+  sigset_t mask;
+  struct epoll_event ev;
+
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGCHLD);
+  if (sigprocmask(SIG_BLOCK, &mask, NULL) < 0) goto no_reactor;
+
+  if ((sigchld_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC)) < 0) {
+    sigprocmask(SIG_UNBLOCK, &mask, NULL);
+    goto no_reactor;
+  }
+
+  if ((reactor_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) goto no_reactor;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = sigchld_fd;
+  if (epoll_ctl(reactor_fd, EPOLL_CTL_ADD, sigchld_fd, &ev) < 0)
+    goto no_reactor;
+
+  if (lm.get_API_mode() && lm.get_FE_sockfd() >= 0) {
+    ev.events = EPOLLIN;
+    ev.data.fd = lm.get_FE_sockfd();
+    if (epoll_ctl(reactor_fd, EPOLL_CTL_ADD, lm.get_FE_sockfd(), &ev) < 0)
+      goto no_reactor;
+  }
+
+  self_trace_t::trace(LEVELCHK(level2), MODULENAME, 0,
+                      "event reactor is up: epoll fd %d, signalfd %d",
+                      reactor_fd, sigchld_fd);
+
+  return true;
+
+no_reactor:
+  self_trace_t::trace(LEVELCHK(level1), MODULENAME, 0,
+                      "event reactor is unavailable (%s); falling back to "
+                      "timed polling",
+                      strerror(errno));
+
+  if (reactor_fd >= 0) close(reactor_fd);
+  reactor_fd = -1;
+  if (sigchld_fd >= 0) {
+    close(sigchld_fd);
+    sigprocmask(SIG_UNBLOCK, &mask, NULL);
+  }
+  sigchld_fd = -1;
+#endif
+
+  return false;
+}
+
+//! PRIVATE: wait_for_events
+/*!
+    blocks until the FE socket becomes readable or SIGCHLD is
+    pending, and drains the signalfd so that the next wait blocks
+    again. Without the reactor, it polls the FE socket for up to
+    10 milliseconds.
+*/
+template <SDBG_DEFAULT_TEMPLATE_WIDTH>
+void event_manager_t<SDBG_DEFAULT_TEMPLPARAM>::wait_for_events(
+    launchmon_base_t<SDBG_DEFAULT_TEMPLPARAM>& lm) {
+#if SDBG_EVENT_REACTOR
+  if (reactor_fd >= 0) {
+    struct epoll_event evs[2];
+    struct signalfd_siginfo si;
+    int nev, i;
+
+    //
+    // EINTR is left to the caller: a signal that interrupts
+    // us is either handled already or must be seen right away
+    //
+    nev = epoll_wait(reactor_fd, evs, 2, -1);
+
+    for (i = 0; i < nev; ++i) {
+      if (evs[i].data.fd == sigchld_fd) {
+        while (read(sigchld_fd, &si, sizeof(si)) == sizeof(si)) {
+        }
+      } else if (evs[i].events & (EPOLLHUP | EPOLLERR)) {
+        //
+        // poll_FE_socket will see the disconnection on its own;
+        // stop watching so that a dead socket cannot spin us
+        //
+        epoll_ctl(reactor_fd, EPOLL_CTL_DEL, evs[i].data.fd, NULL);
+      }
+    }
+
+    return;
+  }
+#endif
+
+  struct pollfd fds[1];
+  int nfds = 0;
+
+  if (lm.get_API_mode() && lm.get_FE_sockfd() >= 0) {
+    fds[0].fd = lm.get_FE_sockfd();
+    fds[0].events = POLLIN;
+    nfds = 1;
+  }
+
+  poll(fds, nfds, 10);
+}
+
 #endif  // SDBG_EVENT_MANAGER_IMPL_HXX
 
 /*
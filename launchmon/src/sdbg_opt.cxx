@@ -58,6 +58,8 @@
 #endif
 
 #include <limits.h>
+#include <string.h>
+#include <unistd.h>
 #include <lmon_api/common.h>
 #include "lmon_api/lmon_say_msg.hxx"
 #include "sdbg_opt.hxx"
@@ -96,10 +98,15 @@ opts_args_t::opts_args_t() {
   my_opt->tool_daemon = "";
   my_opt->remote_info = "";
   my_opt->lmon_sec_info = "";
+  my_opt->rpdtab_enc = "legacy";
+  my_opt->rpdtab_chunk = 0;
   my_opt->debugtarget = "";
   my_opt->launchstring = "";
   my_opt->copyright = LAUNCHMON_COPYRIGHT;
   my_opt->launcher_pid = -1;
+  my_opt->fetch_threads = 1;
+  my_opt->tracer_cache = 1;
+  my_opt->selective_threads = false;
 
   my_rmconfig = new rc_rm_t();
   has_parse_error = false;
@@ -172,6 +179,10 @@ bool opts_args_t::process_args(int *argc, char ***argv) {
           c = 'r';
         else if (string(&nargv[i][2]) == string("lmonsec"))
           c = 's';
+        else if (string(&nargv[i][2]) == string("rpdtabenc"))
+          c = 'e';
+        else if (string(&nargv[i][2]) == string("rpdtabchunk"))
+          c = 'k';
       }
 
       switch (c) {
@@ -268,6 +279,24 @@ bool opts_args_t::process_args(int *argc, char ***argv) {
           i++;
           break;
 
+        case 'e':
+          //
+          // this is a hidden option with which the FE API
+          // negotiates the RPDTAB encoding
+          //
+          my_opt->rpdtab_enc = nargv[i + 1];
+          i++;
+          break;
+
+        case 'k':
+          //
+          // this is a hidden option with which the FE API
+          // asks for the RPDTAB stream in chunks of this many tasks
+          //
+          my_opt->rpdtab_chunk = atoi(nargv[i + 1]);
+          i++;
+          break;
+
         case 'x':
           //
           // this is a hidden option for self-tracing
@@ -383,6 +412,46 @@ bool opts_args_t::process_args(int *argc, char ***argv) {
     self_trace_t::self_trace().opt_module_trace.verbosity_level = verbo;
   }
 
+  //
+  // the number of threads fetching the proctable strings: the
+  // number of online CPUs up to MaxStringFetchThreads unless
+  // overridden
+  //
+  char *ft;
+  if ((ft = getenv("LMON_ENGINE_FETCH_THREADS")) != NULL) {
+    my_opt->fetch_threads = atoi(ft);
+  } else {
+    my_opt->fetch_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  if (my_opt->fetch_threads < 1) {
+    my_opt->fetch_threads = 1;
+  } else if (my_opt->fetch_threads > MaxStringFetchThreads) {
+    my_opt->fetch_threads = MaxStringFetchThreads;
+  }
+
+  //
+  // the tracer's per-stop register and memory cache: on unless
+  // turned off, and verified against the traced process on every
+  // hit in the "check" mode
+  //
+  char *tc;
+  if ((tc = getenv("LMON_ENGINE_TRACER_CACHE")) != NULL) {
+    if (strcmp(tc, "check") == 0) {
+      my_opt->tracer_cache = 2;
+    } else {
+      my_opt->tracer_cache = (atoi(tc) != 0) ? 1 : 0;
+    }
+  }
+
+  //
+  // keeping only the launcher threads that the RM config says can
+  // hit MPIR_Breakpoint traced: off unless asked for
+  //
+  char *tt;
+  if ((tt = getenv("LMON_ENGINE_THREAD_TRACE")) != NULL) {
+    my_opt->selective_threads = (strcmp(tt, "selective") == 0);
+  }
+
   if (!has_parse_error && !construct_rm_map()) {
     if (my_opt->remote && (my_opt->verbose == 0))
       has_parse_error = true;
@@ -531,10 +600,15 @@ opts_args_t::opts_args_t(const opts_args_t &o) {
     my_opt->tool_daemon_opts = o.my_opt->tool_daemon_opts;
     my_opt->remote_info = o.my_opt->remote_info;
     my_opt->lmon_sec_info = o.my_opt->lmon_sec_info;
+    my_opt->rpdtab_enc = o.my_opt->rpdtab_enc;
+    my_opt->rpdtab_chunk = o.my_opt->rpdtab_chunk;
     my_opt->debugtarget = o.my_opt->debugtarget;
     my_opt->launchstring = o.my_opt->launchstring;
     my_opt->copyright = o.my_opt->copyright;
     my_opt->launcher_pid = o.my_opt->launcher_pid;
+    my_opt->fetch_threads = o.my_opt->fetch_threads;
+    my_opt->tracer_cache = o.my_opt->tracer_cache;
+    my_opt->selective_threads = o.my_opt->selective_threads;
 
     MODULENAME = o.MODULENAME;
   }
@@ -81,7 +81,12 @@ struct opt_struct_t {
       tool_daemon_opts;      // options to the lightweight debug engine
   std::string remote_info;   // ip:port
   std::string lmon_sec_info; // shared secret:randomID
+  std::string rpdtab_enc;    // RPDTAB encoding the FE API accepts
+  int rpdtab_chunk;          // tasks per RPDTAB stream chunk, 0 for none
   pid_t launcher_pid;        // the pid of a running parallel launcher process
+  int fetch_threads;         // threads fetching the proctable strings
+  int tracer_cache;          // per-stop tracer cache: 0 off, 1 on, 2 checked
+  bool selective_threads;    // trace only the RM config's launcher threads
   char **remaining;          // options and arguments to be passed
   std::map<std::string, std::string> envMap;
 };
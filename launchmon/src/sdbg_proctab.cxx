@@ -0,0 +1,329 @@
+/*
+ *--------------------------------------------------------------------------------
+ * Copyright (c) 2008, Lawrence Livermore National Security, LLC. Produced at
+ * the Lawrence Livermore National Laboratory. Written by Dong H. Ahn
+ * <ahn1@llnl.gov>. LLNL-CODE-409469. All rights reserved.
+ *
+ * This file is part of LaunchMON. For details, see
+ * https://computing.llnl.gov/?set=resources&page=os_projects
+ *
+ * Please also read LICENSE.txt -- Our Notice and GNU Lesser General Public
+ * License.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the terms and conditions of the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple
+ * Place, Suite 330, Boston, MA 02111-1307 USA
+ *--------------------------------------------------------------------------------
+ */
+
+#ifndef HAVE_LAUNCHMON_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <algorithm>
+
+#include "lmon_api/lmon_proctab.h"
+#include "sdbg_proctab.hxx"
+
+static const proctab_t::str_id_t index_empty = (proctab_t::str_id_t)-1;
+
+//! File scope hash_str
+/*!
+    FNV-1a hash of a NULL-terminated string
+*/
+static size_t hash_str(const char *s) {
+  size_t h = 2166136261U;
+  for (; *s; ++s) {
+    h ^= (unsigned char)*s;
+    h *= 16777619U;
+  }
+  return h;
+}
+
+//! File scope host_name_less
+/*!
+    orders interned host names by their string values
+*/
+struct host_name_less {
+  const char *arena;
+  host_name_less(const char *a) : arena(a) {}
+  bool operator()(proctab_t::str_id_t a, proctab_t::str_id_t b) const {
+    return strcmp(arena + a, arena + b) < 0;
+  }
+};
+
+//! PUBLIC: proctab_t
+/*!
+    default constructor
+*/
+proctab_t::proctab_t() : nstrings(0) {}
+
+//! PUBLIC: ~proctab_t
+/*!
+    destructor
+*/
+proctab_t::~proctab_t() {}
+
+//! PUBLIC: clear
+/*!
+    drops all tasks and interned strings
+*/
+void proctab_t::clear() {
+  arena.clear();
+  index.clear();
+  nstrings = 0;
+  host_ids.clear();
+  exec_ids.clear();
+  pids.clear();
+  ranks.clear();
+  cnodeids.clear();
+  hosts.clear();
+}
+
+//! PUBLIC: reserve
+/*!
+    reserves the per-task columns for ntasks tasks
+*/
+void proctab_t::reserve(size_t ntasks) {
+  host_ids.reserve(ntasks);
+  exec_ids.reserve(ntasks);
+  pids.reserve(ntasks);
+  ranks.reserve(ntasks);
+  cnodeids.reserve(ntasks);
+}
+
+//! PRIVATE: grow_index
+/*!
+    doubles the hash index and rehashes the interned strings
+*/
+void proctab_t::grow_index() {
+  size_t nslots = index.empty() ? 64 : index.size() * 2;
+  std::vector<str_id_t> newindex(nslots, index_empty);
+  std::vector<str_id_t>::const_iterator iter;
+
+  for (iter = index.begin(); iter != index.end(); ++iter) {
+    if (*iter == index_empty) continue;
+    size_t slot = hash_str(&arena[*iter]) & (nslots - 1);
+    while (newindex[slot] != index_empty) slot = (slot + 1) & (nslots - 1);
+    newindex[slot] = *iter;
+  }
+  index.swap(newindex);
+}
+
+//! PUBLIC: intern
+/*!
+    returns the id of string s, copying it into the arena if it
+    has not been seen before.
+*/
+proctab_t::str_id_t proctab_t::intern(const char *s) {
+  if (2 * (nstrings + 1) > index.size()) grow_index();
+
+  size_t mask = index.size() - 1;
+  size_t slot = hash_str(s) & mask;
+
+  while (index[slot] != index_empty) {
+    if (strcmp(&arena[index[slot]], s) == 0) return index[slot];
+    slot = (slot + 1) & mask;
+  }
+
+  str_id_t id = (str_id_t)arena.size();
+  arena.insert(arena.end(), s, s + strlen(s) + 1);
+  index[slot] = id;
+  nstrings++;
+
+  return id;
+}
+
+//! PUBLIC: append
+/*!
+    appends a task. Host ranges are stale until finalize is called.
+*/
+void proctab_t::append(str_id_t host, str_id_t exec, int pid, int rank,
+                       int cnodeid) {
+  host_ids.push_back(host);
+  exec_ids.push_back(exec);
+  pids.push_back(pid);
+  ranks.push_back(rank);
+  cnodeids.push_back(cnodeid);
+}
+
+//! PUBLIC: finalize
+/*!
+    groups tasks by host with a stable counting sort and builds the
+    host range table.
+*/
+void proctab_t::finalize() {
+  size_t ntasks = pids.size();
+  size_t i, k;
+  std::vector<int> slot(arena.size(), -1);
+  std::vector<str_id_t> hnames;
+
+  hosts.clear();
+  if (ntasks == 0) return;
+
+  for (i = 0; i < ntasks; ++i) {
+    if (slot[host_ids[i]] < 0) {
+      slot[host_ids[i]] = (int)hnames.size();
+      hnames.push_back(host_ids[i]);
+    }
+  }
+
+  std::sort(hnames.begin(), hnames.end(), host_name_less(&arena[0]));
+
+  std::vector<size_t> next(hnames.size(), 0);
+  for (k = 0; k < hnames.size(); ++k) slot[hnames[k]] = (int)k;
+  for (i = 0; i < ntasks; ++i) next[slot[host_ids[i]]]++;
+
+  hosts.resize(hnames.size());
+  size_t begin = 0;
+  for (k = 0; k < hnames.size(); ++k) {
+    hosts[k].name = hnames[k];
+    hosts[k].begin = begin;
+    hosts[k].end = begin + next[k];
+    next[k] = begin;
+    begin = hosts[k].end;
+  }
+
+  std::vector<str_id_t> nhost_ids(ntasks);
+  std::vector<str_id_t> nexec_ids(ntasks);
+  std::vector<int> npids(ntasks);
+  std::vector<int> nranks(ntasks);
+  std::vector<int> ncnodeids(ntasks);
+
+  for (i = 0; i < ntasks; ++i) {
+    size_t to = next[slot[host_ids[i]]]++;
+    nhost_ids[to] = host_ids[i];
+    nexec_ids[to] = exec_ids[i];
+    npids[to] = pids[i];
+    nranks[to] = ranks[i];
+    ncnodeids[to] = cnodeids[i];
+  }
+
+  host_ids.swap(nhost_ids);
+  exec_ids.swap(nexec_ids);
+  pids.swap(npids);
+  ranks.swap(nranks);
+  cnodeids.swap(ncnodeids);
+}
+
+//! PUBLIC: rpdtab_size_bound
+/*!
+    returns an upper bound of the RPDTAB payload size that
+    serialize_rpdtab produces: the per-task entries plus every
+    interned string.
+*/
+size_t proctab_t::rpdtab_size_bound() const {
+  return N_Fields_MPIR_PROCDESC_EXT * sizeof(unsigned int) * size() +
+         arena.size();
+}
+
+//! PUBLIC: serialize_rpdtab
+/*!
+    writes the RPDTAB payload of an lmonp proctable message into
+    payload, which must hold at least rpdtab_size_bound() bytes:
+    N_Fields_MPIR_PROCDESC_EXT unsigned ints per task {hostname
+    index, executable index, pid, rank, cnodeid}, followed by the
+    string table. Indices are offsets into the string table, which
+    holds each string once in the order it is first referenced.
+
+    Tasks are interned already, so a single pass that maps each
+    string id to its string table offset suffices. Returns the number
+    of payload bytes written.
+*/
+size_t proctab_t::serialize_rpdtab(char *payload,
+                                   unsigned int *num_unique_exec,
+                                   unsigned int *num_unique_hn) const {
+  rpdtab_cursor_t c;
+  char *strtab = payload + N_Fields_MPIR_PROCDESC_EXT * sizeof(unsigned int) *
+                               size();
+  size_t len;
+
+  begin_rpdtab(c);
+  len = serialize_rpdtab_chunk(c, size(), payload, strtab);
+
+  *num_unique_exec = c.num_unique_exec;
+  *num_unique_hn = c.num_unique_hn;
+
+  return (size_t)(strtab - payload) + len;
+}
+
+//! PUBLIC: begin_rpdtab
+/*!
+    resets c to the first task with an empty string table
+*/
+void proctab_t::begin_rpdtab(rpdtab_cursor_t &c) const {
+  c.next_task = 0;
+  c.strtab_len = 0;
+  c.num_unique_exec = 0;
+  c.num_unique_hn = 0;
+  c.strtab_offset.assign(arena.size(), (unsigned int)-1);
+}
+
+//! PUBLIC: serialize_rpdtab_chunk
+/*!
+    writes the entries of up to ntasks tasks from c.next_task into
+    entries and the strings they reference first into strtab, then
+    advances c. Entry indices are offsets into the whole string table,
+    of which strtab receives the bytes [c.strtab_len before the call,
+    c.strtab_len after it). entries must hold N_Fields_MPIR_PROCDESC_EXT
+    unsigned ints per task and strtab arena_size() bytes. Returns the
+    number of bytes written to strtab.
+*/
+size_t proctab_t::serialize_rpdtab_chunk(rpdtab_cursor_t &c, size_t ntasks,
+                                         char *entries, char *strtab) const {
+  const unsigned int unset = (unsigned int)-1;
+  unsigned int *entry = (unsigned int *)entries;
+  unsigned int base = c.strtab_len;
+  size_t i, end;
+
+  end = c.next_task + ntasks;
+  if (end > size()) end = size();
+
+  for (i = c.next_task; i < end; ++i) {
+    str_id_t eid = exec_ids[i];
+    str_id_t hid = host_ids[i];
+
+    if (c.strtab_offset[eid] == unset) {
+      size_t leng = strlen(&arena[eid]) + 1;
+      memcpy(strtab + (c.strtab_len - base), &arena[eid], leng);
+      c.strtab_offset[eid] = c.strtab_len;
+      c.strtab_len += leng;
+      c.num_unique_exec++;
+    }
+
+    if (c.strtab_offset[hid] == unset) {
+      size_t leng = strlen(&arena[hid]) + 1;
+      memcpy(strtab + (c.strtab_len - base), &arena[hid], leng);
+      c.strtab_offset[hid] = c.strtab_len;
+      c.strtab_len += leng;
+      c.num_unique_hn++;
+    }
+
+    entry[0] = c.strtab_offset[hid];
+    entry[1] = c.strtab_offset[eid];
+    memcpy(&entry[2], &pids[i], sizeof(int));
+    memcpy(&entry[3], &ranks[i], sizeof(int));
+    memcpy(&entry[4], &cnodeids[i], sizeof(int));
+    entry += N_Fields_MPIR_PROCDESC_EXT;
+  }
+
+  c.next_task = end;
+
+  return (size_t)(c.strtab_len - base);
+}
+
+/*
+ * ts=2 sw=2 expandtab
+ */
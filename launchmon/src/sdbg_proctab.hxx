@@ -0,0 +1,146 @@
+/*
+ *--------------------------------------------------------------------------------
+ * Copyright (c) 2008, Lawrence Livermore National Security, LLC. Produced at
+ * the Lawrence Livermore National Laboratory. Written by Dong H. Ahn
+ * <ahn1@llnl.gov>. LLNL-CODE-409469. All rights reserved.
+ *
+ * This file is part of LaunchMON. For details, see
+ * https://computing.llnl.gov/?set=resources&page=os_projects
+ *
+ * Please also read LICENSE.txt -- Our Notice and GNU Lesser General Public
+ * License.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the terms and conditions of the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple
+ * Place, Suite 330, Boston, MA 02111-1307 USA
+ *--------------------------------------------------------------------------------
+ */
+
+#ifndef SDBG_PROCTAB_HXX
+#define SDBG_PROCTAB_HXX 1
+
+#include <stddef.h>
+#include <vector>
+
+//! class proctab_t
+/*!
+    the engine's in-memory copy of the RPDTAB. Host and executable
+    names are interned into a single string arena and referred to by
+    their arena offsets; per-task fields are kept as columns.
+
+    Tasks are appended in rank order with append and then grouped
+    by host with finalize, after which tasks [host_begin(h),
+    host_end(h)) run on host h. Hosts are ordered by name and the
+    tasks of a host keep their rank order.
+*/
+class proctab_t {
+ public:
+  typedef unsigned int str_id_t;
+
+  proctab_t();
+  ~proctab_t();
+
+  void clear();
+  void reserve(size_t ntasks);
+  str_id_t intern(const char *s);
+  void append(str_id_t host, str_id_t exec, int pid, int rank, int cnodeid);
+  void finalize();
+
+  size_t rpdtab_size_bound() const;
+  size_t serialize_rpdtab(char *payload, unsigned int *num_unique_exec,
+                          unsigned int *num_unique_hn) const;
+
+  //
+  // serialize_rpdtab in pieces: begin_rpdtab resets a cursor and each
+  // serialize_rpdtab_chunk call serializes the next tasks. Chunks
+  // concatenated in order make up the serialize_rpdtab payload.
+  //
+  struct rpdtab_cursor_t {
+    size_t next_task;
+    unsigned int strtab_len;
+    unsigned int num_unique_exec;
+    unsigned int num_unique_hn;
+    std::vector<unsigned int> strtab_offset;
+  };
+
+  void begin_rpdtab(rpdtab_cursor_t &c) const;
+  size_t serialize_rpdtab_chunk(rpdtab_cursor_t &c, size_t ntasks,
+                                char *entries, char *strtab) const;
+
+  bool empty() const { return pids.empty(); }
+  size_t size() const { return pids.size(); }
+  size_t num_hosts() const { return hosts.size(); }
+
+  //
+  // Pointers returned by str are valid until the next intern
+  //
+  const char *str(str_id_t id) const { return &arena[id]; }
+  size_t arena_size() const { return arena.size(); }
+
+  str_id_t host_id(size_t h) const { return hosts[h].name; }
+  const char *host_name(size_t h) const { return str(hosts[h].name); }
+  size_t host_begin(size_t h) const { return hosts[h].begin; }
+  size_t host_end(size_t h) const { return hosts[h].end; }
+
+  str_id_t task_host_id(size_t i) const { return host_ids[i]; }
+  str_id_t task_exec_id(size_t i) const { return exec_ids[i]; }
+  const char *task_host_name(size_t i) const { return str(host_ids[i]); }
+  const char *task_executable_name(size_t i) const {
+    return str(exec_ids[i]);
+  }
+  int task_pid(size_t i) const { return pids[i]; }
+  int task_rank(size_t i) const { return ranks[i]; }
+  int task_cnodeid(size_t i) const { return cnodeids[i]; }
+
+ private:
+  struct host_range_t {
+    str_id_t name;
+    size_t begin;
+    size_t end;
+  };
+
+  proctab_t(const proctab_t &);
+  proctab_t &operator=(const proctab_t &);
+
+  void grow_index();
+
+  //
+  // interned strings, NULL-terminated and back to back
+  //
+  std::vector<char> arena;
+
+  //
+  // open-addressing hash of arena offsets; empty slots hold
+  // index_empty
+  //
+  std::vector<str_id_t> index;
+  size_t nstrings;
+
+  //
+  // per-task columns
+  //
+  std::vector<str_id_t> host_ids;
+  std::vector<str_id_t> exec_ids;
+  std::vector<int> pids;
+  std::vector<int> ranks;
+  std::vector<int> cnodeids;
+
+  std::vector<host_range_t> hosts;
+};
+
+#endif  // SDBG_PROCTAB_HXX
+
+/*
+ * ts=2 sw=2 expandtab
+ */
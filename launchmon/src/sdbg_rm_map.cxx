@@ -121,7 +121,8 @@ resource_manager_t::resource_manager_t()
       expanded_launch_string(""),
       has_launcher_so(false),
       launcher_so_name(""),
-      attach_fifo_path("") {}
+      attach_fifo_path(""),
+      thread_trace(thr_trace_all) {}
 
 resource_manager_t::resource_manager_t(const resource_manager_t &r) {
   rm = r.rm;
@@ -137,6 +138,8 @@ resource_manager_t::resource_manager_t(const resource_manager_t &r) {
   has_launcher_so = r.has_launcher_so;
   launcher_so_name = r.launcher_so_name;
   attach_fifo_path = r.attach_fifo_path;
+  thread_trace = r.thread_trace;
+  thread_start_funcs = r.thread_start_funcs;
 }
 
 resource_manager_t::~resource_manager_t() {
@@ -163,6 +166,8 @@ resource_manager_t &resource_manager_t::operator=(const resource_manager_t &r) {
   has_launcher_so = r.has_launcher_so;
   launcher_so_name = r.launcher_so_name;
   attach_fifo_path = r.attach_fifo_path;
+  thread_trace = r.thread_trace;
+  thread_start_funcs = r.thread_start_funcs;
   return *this;
 }
 
@@ -297,6 +302,26 @@ void resource_manager_t::fill_launcher_so(const std::string &v) {
   launcher_so_name = v;
 }
 
+void resource_manager_t::fill_thread_trace(const std::string &v) {
+  size_t ix = 0;
+  size_t ix2 = 0;
+
+  thread_trace = thr_trace_all;
+  thread_start_funcs.clear();
+
+  if (v == std::string("main")) {
+    thread_trace = thr_trace_main;
+  } else if (v.compare(0, 6, "start|") == 0) {
+    thread_trace = thr_trace_start;
+    ix = 6;
+    while ((ix2 = v.find_first_of("|", ix)) != std::string::npos) {
+      if (ix2 > ix) thread_start_funcs.push_back(v.substr(ix, ix2 - ix));
+      ix = ix2 + 1;
+    }
+    if (ix < v.size()) thread_start_funcs.push_back(v.substr(ix));
+  }
+}
+
 void resource_manager_t::fill_kill_singals(const std::string &v) {
   int signal_type = 0;
   size_t ix = 0;
@@ -628,6 +653,14 @@ bool rc_rm_t::is_fail_detect_sup() {
   return resource_manager.get_fail_detection_supported();
 }
 
+thread_trace_e rc_rm_t::get_thread_trace() {
+  return resource_manager.get_thread_trace();
+}
+
+const std::vector<std::string> &rc_rm_t::get_thread_start_funcs() {
+  return resource_manager.get_thread_start_funcs();
+}
+
 bool rc_rm_t::is_rid_via_symbol() {
   return (resource_manager.get_job_id().method == symbol);
 }
@@ -814,6 +847,11 @@ bool rc_rm_t::parse_and_fill_rm(const std::string &rm_conf_path,
     a_rm.fill_fail_detection(iter->second[0]);
   }
 
+  iter = key_value_pair.find(std::string("RM_thread_trace"));
+  if (iter != key_value_pair.end()) {
+    a_rm.fill_thread_trace(iter->second[0]);
+  }
+
   iter = key_value_pair.find(std::string("RM_launch_helper"));
   if (iter != key_value_pair.end()) {
     a_rm.fill_launch_helper(iter->second[0]);
@@ -84,6 +84,8 @@ enum launch_method_e {
   launch_method_unknown
 };
 
+enum thread_trace_e { thr_trace_all, thr_trace_main, thr_trace_start };
+
 struct rm_id_t {
   rm_id_t();
 
@@ -193,6 +195,8 @@ class resource_manager_t {
   define_gset(bool, has_launcher_so)
   define_gset(std::string &, launcher_so_name)
   define_gset(std::string &, attach_fifo_path)
+  define_gset(thread_trace_e, thread_trace)
+  define_gset(std::vector<std::string> &, thread_start_funcs)
   const std::vector<rm_id_t> &get_const_launcher_ids() const;
   const std::vector<std::string> &get_const_launchers() const;
 
@@ -209,6 +213,7 @@ class resource_manager_t {
   void fill_launch_string(const std::string &v);
   void fill_expanded_launch_string(const std::string &v);
   void fill_attach_fifo_path(const std::string &v);
+  void fill_thread_trace(const std::string &v);
 
  private:
   int resolve_signal(const std::string &v);
@@ -226,6 +231,8 @@ class resource_manager_t {
   bool has_launcher_so;
   std::string launcher_so_name;
   std::string attach_fifo_path;
+  thread_trace_e thread_trace;
+  std::vector<std::string> thread_start_funcs;
 };
 
 class rc_rm_t {
@@ -266,6 +273,10 @@ class rc_rm_t {
 
   bool is_fail_detect_sup();
 
+  thread_trace_e get_thread_trace();
+
+  const std::vector<std::string> &get_thread_start_funcs();
+
   resource_manager_t &get_resource_manager();
 
   coloc_str_param_t &get_coloc_paramset();
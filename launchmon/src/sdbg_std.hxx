@@ -64,7 +64,7 @@
 const unsigned int GracePeriodForZombieThread = 10000;
 const unsigned int GracePeriodBNSignals = 100000;         // 100 millisecs
 const unsigned int GracePeriodFEDisconnection = 2000000;  // 2 secs
-const double DefaultWarmPeriods = 10.0;
+const int MaxStringFetchThreads = 16;
 
 #endif  // SDBG_STD_HXX
 
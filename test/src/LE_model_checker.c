@@ -85,7 +85,7 @@ END_C_DECLS
 
 enum errormode_e { err0, err1, err2, err3, err4 };
 
-enum whichthread_e { mainthread, slavethread };
+enum whichthread_e { mainthread, slavethread, helperthread };
 
 typedef struct _option_t {
   int pcount;
@@ -209,6 +209,11 @@ void* do_something(void* arg) {
   pthread_exit(NULL);
 }
 
+void* idle_helper(void* arg) {
+  sleep(3);
+  return NULL;
+}
+
 void print_usage() {
   fprintf(stdout, "usage: mpirun-modelchker [OPTIONS]\n");
   fprintf(stdout, "OPTIONS\n");
@@ -216,7 +221,9 @@ void print_usage() {
           "-p<process count>:");
   fprintf(stdout, "%s \n\t\t\terror injection type [0~4]\n",
           "-e<error type>: ");
-  fprintf(stdout, "%s \n\t\t\t0 for main thread, 1 for pthread\n",
+  fprintf(stdout,
+          "%s \n\t\t\t0 for main thread, 1 for pthread, 2 for a dedicated "
+          "pthread among idle helpers\n",
           "-t<which thread to call MPIR_Breakpoint>:");
   fprintf(stdout, "%s \n\t\t\tprint this message\n", "-h:");
 
@@ -292,6 +299,8 @@ int modelchecker_run(int argc, char* argv[]) {
             myopt.thr = mainthread;
           else if (argv[i][2] == '1')
             myopt.thr = slavethread;
+          else if (argv[i][2] == '2')
+            myopt.thr = helperthread;
           else {
             fprintf(stderr,
                     "[LaunchMON MODEL CHECKER]: unknown thread option: %s\n",
@@ -337,6 +346,27 @@ int modelchecker_run(int argc, char* argv[]) {
 
     for (i = 0; i < 256; i++) pthread_join(thr[i], NULL);
 
+    fprintf(stdout, "[LaunchMON MODEL CHECKER]: Finishing up...\n");
+    pthread_create(&thr[0], NULL, abort_debugger, (void*)argv[0]);
+    pthread_join(thr[0], NULL);
+  } else if (myopt.thr == helperthread) {
+    pthread_t thr[257];
+    long i;
+
+    fprintf(stdout,
+            "[LaunchMON MODEL CHECKER]: Starting mpirun model checker...\n");
+    fprintf(stdout, "[LaunchMON MODEL CHECKER]: Process Count: %d\n",
+            myopt.pcount);
+    fprintf(stdout,
+            "[LaunchMON MODEL CHECKER]: A dedicated pthread calling "
+            "MPIR_Breakpoint among 256 idle helpers\n");
+
+    for (i = 0; i < 256; i++)
+      pthread_create(&thr[i], NULL, idle_helper, (void*)i);
+    pthread_create(&thr[256], NULL, setup_debugger, (void*)argv[0]);
+
+    for (i = 0; i < 257; i++) pthread_join(thr[i], NULL);
+
     fprintf(stdout, "[LaunchMON MODEL CHECKER]: Finishing up...\n");
     pthread_create(&thr[0], NULL, abort_debugger, (void*)argv[0]);
     pthread_join(thr[0], NULL);
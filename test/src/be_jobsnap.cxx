@@ -79,6 +79,10 @@ const int JIFFY_CONVERSION = 10000;
 const int LENGTH_REQ_4_HEX = 18;
 const int PAGESIZE = 4096;
 
+// process states counted across all daemons, '?' takes the rest
+const char JOBSNAP_STATES[] = "RSDZTWI?";
+const int JOBSNAP_NUM_STATES = sizeof(JOBSNAP_STATES) - 1;
+
 struct ProcStat {
   int mpiRank;
   int pid;             /* process id; use %d */
@@ -232,14 +236,15 @@ static bool receiveMessage(BG_Debugger_Msg &msg, BG_MsgType_t type,
 int main(int argc, char *argv[]) {
   using namespace std;
 
-  MPIR_PROCDESC_EXT *proctab;
+  lmon_proctab_view_t view;
+  int first = 0;
   ProcStat *tps = NULL;
   MemStat *tms = NULL;
   ProcStat *gatheredTps = NULL;
   MemStat *gatheredTms = NULL;
 
   int i, k, t;
-  int maxSize = 0, *aggrSizes = NULL;
+  int *gatheredSizes = NULL;
   int rank;
   int be_size;
   int proctab_size;
@@ -289,56 +294,30 @@ int main(int argc, char *argv[]) {
   }
 
   //
-  // Testing the size of the local proctab
+  // Fetching the view of the per-node proctable; its entries
+  // point into the received table, so nothing is copied.
   // note that proctab_size could differ across different BEs
   //
-  lrc = LMON_be_getMyProctabSize(&proctab_size);
+  lrc = LMON_be_getMyProctabView(&view);
   if (lrc != LMON_OK) {
-    cerr << "[JOBSNAP BE(" << rank << "): FAILED] LMON_be_getMyProctabSize"
+    cerr << "[JOBSNAP BE(" << rank << "): FAILED] LMON_be_getMyProctabView"
          << endl;
     LMON_be_finalize();
 
     return EXIT_FAILURE;
   }
 
-  //
-  // determine max local size?
-  //
-  aggrSizes = new int[be_size];
-
-  if (LMON_be_gather(&proctab_size, sizeof(int), aggrSizes) < 0) {
-    cerr << "[JOBSNAP BE(" << rank << "): FAILED] LMON_be_gather" << endl;
-
-    LMON_be_finalize();
-
-    return EXIT_FAILURE;
+  proctab_size = 0;
+  if (view.my_host >= 0) {
+    first = view.hosts[view.my_host].begin;
+    proctab_size = view.hosts[view.my_host].end - first;
   }
 
-  if (LMON_be_amIMaster() == LMON_YES) {
-    for (k = 0; k < be_size; ++k) {
-      if (aggrSizes[k] > maxSize) maxSize = aggrSizes[k];
-    }
-  }
-
-  delete aggrSizes;
-
-  if (LMON_be_broadcast(&maxSize, sizeof(int)) < 0) {
-    cerr << "[JOBSNAP BE(" << rank << "): FAILED] LMON_be_broadcast" << endl;
-
-    LMON_be_finalize();
-
-    return EXIT_FAILURE;
-  }
-
-  proctab = (MPIR_PROCDESC_EXT *)malloc(maxSize * sizeof(MPIR_PROCDESC_EXT));
-  if (proctab == NULL) {
-    fprintf(stdout, "[LMON BE(%d)] FAILED: malloc returned null\n", rank);
-    LMON_be_finalize();
-
-    return EXIT_FAILURE;
-  }
-
-  tps = (ProcStat *)malloc(maxSize * sizeof(ProcStat));
+  //
+  // proctab_size could differ across different BEs, each sends
+  // only its own entries with LMON_be_gatherv
+  //
+  tps = (ProcStat *)malloc((proctab_size + 1) * sizeof(ProcStat));
   if (tps == NULL) {
     fprintf(stdout, "[LMON BE(%d)] FAILED: malloc returned null\n", rank);
     LMON_be_finalize();
@@ -346,7 +325,7 @@ int main(int argc, char *argv[]) {
     return EXIT_FAILURE;
   }
 
-  tms = (MemStat *)malloc(maxSize * sizeof(MemStat));
+  tms = (MemStat *)malloc((proctab_size + 1) * sizeof(MemStat));
   if (tms == NULL) {
     fprintf(stdout, "[LMON BE(%d)] FAILED: malloc returned null\n", rank);
     LMON_be_finalize();
@@ -354,17 +333,6 @@ int main(int argc, char *argv[]) {
     return EXIT_FAILURE;
   }
 
-  //
-  // Fetching per-node proctable
-  //
-  lrc = LMON_be_getMyProctab(proctab, &proctab_size, proctab_size);
-  if (lrc != LMON_OK) {
-    cerr << "[JOBSNAP BE(" << rank << "): FAILED] LMON_be_getMyProctab" << endl;
-    LMON_be_finalize();
-
-    return EXIT_FAILURE;
-  }
-
   for (i = 0; i < proctab_size; i++) {
 #if SUB_ARCH_BGL || SUB_ARCH_BGP
     //
@@ -374,14 +342,14 @@ int main(int argc, char *argv[]) {
     BG_Thread_Data_t mainThrData;
     BG_Debugger_Msg response;
 
-    tps[i].mpiRank = proctab[i].mpirank;
-    tps[i].pid = proctab[i].pd.pid;
-    strncpy(tps[i].comm, proctab[i].pd.executable_name, PATH_MAX);
+    tps[i].mpiRank = LMON_view_mpirank(&view, first + i);
+    tps[i].pid = LMON_view_pid(&view, first + i);
+    strncpy(tps[i].comm, LMON_view_executable_name(&view, first + i), PATH_MAX);
 
     //
     // please attach
     //
-    BG_Debugger_Msg attach(ATTACH, proctab[i].pd.pid, 0, 0, 0);
+    BG_Debugger_Msg attach(ATTACH, LMON_view_pid(&view, first + i), 0, 0, 0);
     attach.header.dataLength = sizeof(attach.dataArea.ATTACH);
 
     if (!sendMessage(attach)) {
@@ -400,7 +368,7 @@ int main(int argc, char *argv[]) {
     //
     // please stop
     //
-    BG_Debugger_Msg stop(KILL, proctab[i].pd.pid, 0, 0, 0);
+    BG_Debugger_Msg stop(KILL, LMON_view_pid(&view, first + i), 0, 0, 0);
     stop.dataArea.KILL.signal = SIGSTOP;
     stop.header.dataLength = sizeof(stop.dataArea.KILL);
 
@@ -430,7 +398,7 @@ int main(int argc, char *argv[]) {
     //
     // please GET_THREAD_INFO
     //
-    BG_Debugger_Msg threadInfo(GET_THREAD_INFO, proctab[i].pd.pid, 0, 0, 0);
+    BG_Debugger_Msg threadInfo(GET_THREAD_INFO, LMON_view_pid(&view, first + i), 0, 0, 0);
     if (!sendMessage(threadInfo)) {
       LMON_be_finalize();
 
@@ -466,7 +434,7 @@ int main(int argc, char *argv[]) {
     //
     // please GET_PROCESS_DATA
     //
-    BG_Debugger_Msg processData(GET_PROCESS_DATA, proctab[i].pd.pid, mainTid, 0,
+    BG_Debugger_Msg processData(GET_PROCESS_DATA, LMON_view_pid(&view, first + i), mainTid, 0,
                                 0);
     processData.header.dataLength =
         sizeof(processData.dataArea.GET_PROCESS_DATA);
@@ -501,7 +469,7 @@ int main(int argc, char *argv[]) {
     //
     // please GET_THREAD_DATA for the main thread
     //
-    BG_Debugger_Msg threadData(GET_THREAD_DATA, proctab[i].pd.pid, mainTid, 0,
+    BG_Debugger_Msg threadData(GET_THREAD_DATA, LMON_view_pid(&view, first + i), mainTid, 0,
                                0);
     threadData.header.dataLength = sizeof(processData.dataArea.GET_THREAD_DATA);
 
@@ -556,7 +524,7 @@ int main(int argc, char *argv[]) {
     //
     // please continue
     //
-    BG_Debugger_Msg conti(CONTINUE, proctab[i].pd.pid, 0, 0, 0);
+    BG_Debugger_Msg conti(CONTINUE, LMON_view_pid(&view, first + i), 0, 0, 0);
     conti.header.dataLength = sizeof(processData.dataArea.CONTINUE);
 
     if (!sendMessage(conti)) {
@@ -581,12 +549,12 @@ int main(int argc, char *argv[]) {
     char line[4096];
     size_t len;
 
-    ost1 << "/proc/" << proctab[i].pd.pid << "/stat";
+    ost1 << "/proc/" << LMON_view_pid(&view, first + i) << "/stat";
 
     // how do you want to check exceptions?
     ifst.open(ost1.str().c_str(), ios::in);
 
-    tps[i].mpiRank = proctab[i].mpirank;
+    tps[i].mpiRank = LMON_view_mpirank(&view, first + i);
 
     ifst >> tps[i].pid >> tps[i].comm >> tps[i].state >>
         tps[i].xStat.LinuxStat.ppid  // ppid
@@ -612,7 +580,7 @@ int main(int argc, char *argv[]) {
 
     ifst.close();
 
-    ost2 << "/proc/" << proctab[i].pd.pid << "/status";
+    ost2 << "/proc/" << LMON_view_pid(&view, first + i) << "/status";
 
     // how do you want to check exceptions?
     ifst.open(ost2.str().c_str(), ios::in);
@@ -662,32 +630,53 @@ int main(int argc, char *argv[]) {
 #endif  // SUB_ARCH_BGP vs LINUX with /proc
   }     // local proctab loop
 
-  //
-  // fill the potentially remaining elements with the dummy rank
-  //
-  while (i < maxSize) tps[i++].mpiRank = -1;
-
   if (LMON_be_amIMaster() == LMON_YES) {
-    gatheredTps = (ProcStat *)malloc(be_size * maxSize * sizeof(ProcStat));
-    gatheredTms = (MemStat *)malloc(be_size * maxSize * sizeof(MemStat));
+    gatheredSizes = new int[be_size];
   }
 
-  lrc = LMON_be_gather((void *)tps, sizeof(ProcStat) * maxSize,
-                       (void *)gatheredTps);
+  lrc = LMON_be_gatherv((void *)tps, sizeof(ProcStat) * proctab_size,
+                        (void **)&gatheredTps, gatheredSizes);
 
   if (lrc != LMON_OK) {
-    cerr << "[JOBSNAP BE(" << rank << "): FAILED] LMON_be_gather" << endl;
+    cerr << "[JOBSNAP BE(" << rank << "): FAILED] LMON_be_gatherv" << endl;
 
     LMON_be_finalize();
 
     return EXIT_FAILURE;
   }
 
-  lrc = LMON_be_gather((void *)tms, sizeof(MemStat) * maxSize,
-                       (void *)gatheredTms);
+  lrc = LMON_be_gatherv((void *)tms, sizeof(MemStat) * proctab_size,
+                        (void **)&gatheredTms, gatheredSizes);
 
   if (lrc != LMON_OK) {
-    cerr << "[JOBSNAP BE(" << rank << "): FAILED] LMON_be_gather" << endl;
+    cerr << "[JOBSNAP BE(" << rank << "): FAILED] LMON_be_gatherv" << endl;
+
+    LMON_be_finalize();
+
+    return EXIT_FAILURE;
+  }
+
+  //
+  // count tasks per state; the daemons add up their counts on the way
+  // to the master, which only receives one array from each child
+  //
+  int localStates[JOBSNAP_NUM_STATES];
+  int jobStates[JOBSNAP_NUM_STATES];
+
+  for (t = 0; t < JOBSNAP_NUM_STATES; ++t) localStates[t] = 0;
+  for (i = 0; i < proctab_size; ++i) {
+    const char *st = strchr(JOBSNAP_STATES, tps[i].state);
+    if (st == NULL || tps[i].state == '\0') {
+      st = JOBSNAP_STATES + JOBSNAP_NUM_STATES - 1;
+    }
+    localStates[st - JOBSNAP_STATES]++;
+  }
+
+  lrc = LMON_be_reduce(localStates, jobStates, JOBSNAP_NUM_STATES,
+                       LMON_TYPE_INT, LMON_OP_SUM);
+
+  if (lrc != LMON_OK) {
+    cerr << "[JOBSNAP BE(" << rank << "): FAILED] LMON_be_reduce" << endl;
 
     LMON_be_finalize();
 
@@ -715,7 +704,12 @@ int main(int argc, char *argv[]) {
         << "StartStk" << setw(20) << "StackPtr" << setw(15) << "Brk Size(Byte)"
         << setw(15) << "Utime (secs)" << setw(15) << "Stime (secs)" << endl;
 
-    for (i = 0; i < be_size * maxSize; ++i) {
+    int ngathered = 0;
+    for (k = 0; k < be_size; ++k) {
+      ngathered += gatheredSizes[k] / sizeof(MemStat);
+    }
+
+    for (i = 0; i < ngathered; ++i) {
       if (gatheredTps[i].mpiRank != -1) {
         char bname[24];
         char *execname = strdup(gatheredTps[i].comm);
@@ -745,6 +739,12 @@ int main(int argc, char *argv[]) {
       }
     }
 
+    ofs << dec << "Tasks per state:";
+    for (t = 0; t < JOBSNAP_NUM_STATES; ++t) {
+      ofs << " " << JOBSNAP_STATES[t] << "=" << jobStates[t];
+    }
+    ofs << endl;
+
     ofs.close();
 
 #if MEASURE_TRACING_COST
@@ -769,7 +769,7 @@ int main(int argc, char *argv[]) {
       //
       // please stop so that I can continue with a signal
       //
-      BG_Debugger_Msg dbgmsg(KILL, proctab[i].pd.pid, 0, 0, 0);
+      BG_Debugger_Msg dbgmsg(KILL, LMON_view_pid(&view, first + i), 0, 0, 0);
       dbgmsg.dataArea.KILL.signal = SIGSTOP;
       dbgmsg.header.dataLength = sizeof(dbgmsg.dataArea.KILL);
       BG_Debugger_Msg ackmsg;
@@ -799,7 +799,7 @@ int main(int argc, char *argv[]) {
       //
       // please continue with a signal
       //
-      BG_Debugger_Msg dbgmsg(CONTINUE, proctab[i].pd.pid, 0, 0, 0);
+      BG_Debugger_Msg dbgmsg(CONTINUE, LMON_view_pid(&view, first + i), 0, 0, 0);
       BG_Debugger_Msg ackmsg;
       dbgmsg.dataArea.CONTINUE.signal = signum;
       dbgmsg.header.dataLength = sizeof(dbgmsg.dataArea.CONTINUE);
@@ -818,13 +818,11 @@ int main(int argc, char *argv[]) {
 #else
 
     for (i = 0; i < proctab_size; i++) {
-      kill(proctab[i].pd.pid, signum);
+      kill(LMON_view_pid(&view, first + i), signum);
     }
 #endif
   }
 
-  if (proctab) free(proctab);
-
   if (tps) free(tps);
 
   if (tms) free(tms);
@@ -832,6 +830,7 @@ int main(int argc, char *argv[]) {
   if (LMON_be_amIMaster() == LMON_YES) {
     if (gatheredTps) free(gatheredTps);
     if (gatheredTms) free(gatheredTms);
+    delete[] gatheredSizes;
   }
 
   LMON_be_finalize();
@@ -74,6 +74,7 @@ const unsigned int fail_mode_test_time = 180;
  */
 
 int main(int argc, char* argv[]) {
+  lmon_proctab_view_t view;
   MPIR_PROCDESC_EXT* proctab;
   int proctab_size;
   int signum;
@@ -127,28 +128,39 @@ int main(int argc, char* argv[]) {
     return EXIT_FAILURE;
   }
 
-  if ((lrc = LMON_be_getMyProctabSize(&proctab_size)) != LMON_OK) {
-    fprintf(stdout, "[LMON BE(%d)] FAILED: LMON_be_getMyProctabSize\n", rank);
+  if ((lrc = LMON_be_getMyProctabView(&view)) != LMON_OK) {
+    fprintf(stdout, "[LMON BE(%d)] FAILED: LMON_be_getMyProctabView\n", rank);
     LMON_be_finalize();
     return EXIT_FAILURE;
   }
 
-  proctab =
-      (MPIR_PROCDESC_EXT*)malloc(proctab_size * sizeof(MPIR_PROCDESC_EXT));
-  if (proctab == NULL) {
-    fprintf(stdout, "[LMON BE(%d)] FAILED: malloc returned null\n", rank);
-    LMON_be_finalize();
-    return EXIT_FAILURE;
+  int first = 0;
+  proctab_size = 0;
+  if (view.my_host >= 0) {
+    first = view.hosts[view.my_host].begin;
+    proctab_size = view.hosts[view.my_host].end - first;
   }
 
-  if ((lrc = LMON_be_getMyProctab(proctab, &proctab_size, proctab_size)) !=
-      LMON_OK) {
-    fprintf(stdout, "[LMON BE(%d)] FAILED: LMON_be_getMyProctab\n", rank);
+  //
+  // procctl takes an MPIR_PROCDESC_EXT array: its strings point
+  // into the view rather than being copied
+  //
+  proctab = (MPIR_PROCDESC_EXT*)malloc(
+      (proctab_size ? proctab_size : 1) * sizeof(MPIR_PROCDESC_EXT));
+  if (proctab == NULL) {
+    fprintf(stdout, "[LMON BE(%d)] FAILED: malloc returned null\n", rank);
     LMON_be_finalize();
     return EXIT_FAILURE;
   }
 
   for (i = 0; i < proctab_size; i++) {
+    proctab[i].pd.host_name = (char*)LMON_view_host_name(&view, first + i);
+    proctab[i].pd.executable_name =
+        (char*)LMON_view_executable_name(&view, first + i);
+    proctab[i].pd.pid = LMON_view_pid(&view, first + i);
+    proctab[i].mpirank = LMON_view_mpirank(&view, first + i);
+    proctab[i].cnodeid = LMON_view_cnodeid(&view, first + i);
+
     fprintf(stdout, "[LMON BE(%d)] Target process: %8d, MPI RANK: %5d\n", rank,
             proctab[i].pd.pid, proctab[i].mpirank);
   }
@@ -210,10 +222,6 @@ int main(int argc, char* argv[]) {
       break;
   }
 
-  for (i = 0; i < proctab_size; i++) {
-    if (proctab[i].pd.executable_name) free(proctab[i].pd.executable_name);
-    if (proctab[i].pd.host_name) free(proctab[i].pd.host_name);
-  }
   free(proctab);
 
   // sending this to mark the end of the BE session
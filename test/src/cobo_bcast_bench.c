@@ -0,0 +1,186 @@
+/*
+ *--------------------------------------------------------------------------------
+ * Copyright (c) 2008, Lawrence Livermore National Security, LLC. Produced at
+ * the Lawrence Livermore National Laboratory. Written by Dong H. Ahn
+ * <ahn1@llnl.gov>. LLNL-CODE-409469. All rights reserved.
+ *
+ * This file is part of LaunchMON. For details, see
+ * https://computing.llnl.gov/?set=resources&page=os_projects
+ *
+ * Please also read LICENSE.txt -- Our Notice and GNU Lesser General Public
+ * License.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the terms and conditions of the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple
+ * Place, Suite 330, Boston, MA 02111-1307 USA
+ *--------------------------------------------------------------------------------
+ */
+
+#ifndef HAVE_LAUNCHMON_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "cobo.h"
+
+/*
+ * Localhost benchmark of the COBO broadcast
+ *
+ * Usage: cobo_bcast_bench [nprocs] [reps]
+ *
+ * Forks nprocs COBO clients on this host, plus the server that wires
+ * them into a tree, once per broadcast segment size (0 forwards whole
+ * messages, as cobo_bcast_tree did before it was segmented). Rank 0
+ * reports the average time of broadcasts from 64KB to 16MB. Each one
+ * starts right after a barrier and ends when the slowest rank holds
+ * all the data. Every rank checks the data it received. COBO_TREE
+ * picks the tree shape.
+ */
+
+#define BENCH_BEGIN_PORT 31000
+
+static const int segments[] = {0, 16 * 1024, 64 * 1024, 256 * 1024};
+static const int sizes[] = {64 * 1024, 1024 * 1024, 4 * 1024 * 1024,
+                            16 * 1024 * 1024};
+
+static double now() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+}
+
+static int client(int *portlist, int nports, unsigned int session, int segment,
+                  int reps) {
+  int rank, nprocs, s, r, i;
+  int bad = 0, anybad = 0;
+
+  if (cobo_open(session, portlist, nports, &rank, &nprocs) != COBO_SUCCESS) {
+    fprintf(stderr, "cobo_open failed\n");
+    return EXIT_FAILURE;
+  }
+
+  char *buf = (char *)malloc(sizes[sizeof(sizes) / sizeof(sizes[0]) - 1]);
+
+  for (s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); ++s) {
+    for (i = 0; i < sizes[s]; ++i) buf[i] = (rank == 0) ? (char)(i * 7) : 0;
+
+    double t = 0.0;
+    for (r = 0; r < reps; ++r) {
+      int usec, maxusec = 0;
+
+      cobo_barrier();
+      double t0 = now();
+      cobo_bcast(buf, sizes[s], 0);
+      usec = (int)((now() - t0) * 1000000.0);
+
+      /* the broadcast is done when the last rank has its data */
+      cobo_allreduce_max_int(&usec, &maxusec);
+      t += (double)maxusec / 1000000.0;
+    }
+    t /= reps;
+
+    for (i = 0; i < sizes[s]; ++i) {
+      if (buf[i] != (char)(i * 7)) {
+        bad = 1;
+        break;
+      }
+    }
+
+    if (rank == 0) {
+      printf("%8d %8d %10d %12.6f %10.1f\n", nprocs, segment, sizes[s], t,
+             (t > 0.0) ? (double)sizes[s] / t / (1024.0 * 1024.0) : 0.0);
+    }
+  }
+
+  cobo_allreduce_max_int(&bad, &anybad);
+  if (rank == 0 && anybad) fprintf(stderr, "broadcast data mismatch\n");
+
+  free(buf);
+  cobo_close();
+
+  return anybad ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+  int nprocs = 16;
+  int reps = 5;
+  int rc = EXIT_SUCCESS;
+  int i, n;
+
+  if (argc > 1) nprocs = atoi(argv[1]);
+  if (argc > 2) reps = atoi(argv[2]);
+  if (nprocs <= 0) nprocs = 16;
+  if (reps <= 0) reps = 5;
+
+  cobo_sec_protocol.mechanism = hs_none;
+
+  int nports = 2 * nprocs;
+  int *portlist = (int *)malloc(nports * sizeof(int));
+  char **hostlist = (char **)malloc(nprocs * sizeof(char *));
+  for (i = 0; i < nprocs; ++i) hostlist[i] = (char *)"localhost";
+
+  printf("%8s %8s %10s %12s %10s\n", "procs", "segment", "bytes", "bcast (s)",
+         "MB/s");
+  fflush(stdout);
+
+  for (n = 0; n < (int)(sizeof(segments) / sizeof(segments[0])); ++n) {
+    unsigned int session = (unsigned int)getpid() * 16 + n;
+    char segstr[32];
+    pid_t *pids = (pid_t *)malloc(nprocs * sizeof(pid_t));
+
+    /* fresh ports for each round, the last ones may linger in TIME_WAIT */
+    for (i = 0; i < nports; ++i) portlist[i] = BENCH_BEGIN_PORT + n * nports + i;
+
+    snprintf(segstr, sizeof(segstr), "%d", segments[n]);
+    setenv("COBO_BCAST_SEGMENT", segstr, 1);
+
+    for (i = 0; i < nprocs; ++i) {
+      if ((pids[i] = fork()) == 0) {
+        exit(client(portlist, nports, session, segments[n], reps));
+      }
+    }
+
+    if (cobo_server_open(session, hostlist, nprocs, portlist, nports) !=
+        COBO_SUCCESS) {
+      fprintf(stderr, "cobo_server_open failed\n");
+      for (i = 0; i < nprocs; ++i) kill(pids[i], SIGTERM);
+      rc = EXIT_FAILURE;
+    }
+
+    for (i = 0; i < nprocs; ++i) {
+      int status;
+      waitpid(pids[i], &status, 0);
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        rc = EXIT_FAILURE;
+      }
+    }
+
+    cobo_server_close();
+    free(pids);
+    fflush(stdout);
+  }
+
+  free(portlist);
+  free(hostlist);
+
+  return rc;
+}
@@ -361,6 +361,35 @@ int main(int argc, char *argv[]) {
     fprintf(stdout, "[LMON FE] \n");
   }
 
+  //
+  // The views must agree with the copied-out table
+  //
+  for (i = 0; i < psize; i++) {
+    lmon_proctab_view_t view;
+    const lmon_proctab_host_t *h;
+    int ix;
+
+    if ((rc = LMON_fe_getProctableByRank(aSession, proctab[i].mpirank, &view,
+                                         &ix)) != LMON_OK ||
+        LMON_view_pid(&view, ix) != proctab[i].pd.pid) {
+      fprintf(stdout, "[LMON FE] FAILED in LMON_fe_getProctableByRank\n");
+      return EXIT_FAILURE;
+    }
+
+    if ((rc = LMON_fe_getProctableByHost(aSession, proctab[i].pd.host_name,
+                                         &view)) != LMON_OK) {
+      fprintf(stdout, "[LMON FE] FAILED in LMON_fe_getProctableByHost\n");
+      return EXIT_FAILURE;
+    }
+
+    h = &view.hosts[view.my_host];
+    if (ix < h->begin || ix >= h->end) {
+      fprintf(stdout, "[LMON FE] FAILED, rank %d is not on host %s\n",
+              proctab[i].mpirank, proctab[i].pd.host_name);
+      return EXIT_FAILURE;
+    }
+  }
+
   rc = LMON_fe_getResourceHandle(aSession, jobid, &jobidsize, PATH_MAX);
   if ((rc != LMON_OK) && (rc != LMON_EDUNAV)) {
     if (rc != LMON_EDUNAV) {
@@ -390,6 +419,50 @@ int main(int argc, char *argv[]) {
             rminfo.rm_launcher_pid);
   }
 
+  lmon_engine_stats_t *estats =
+      (lmon_engine_stats_t *)malloc(sizeof(lmon_engine_stats_t));
+  if ((rc = LMON_fe_getEngineStats(aSession, estats)) != LMON_OK) {
+    fprintf(stdout, "[LMON FE] FAILED in LMON_fe_getEngineStats\n");
+    return EXIT_FAILURE;
+  } else {
+    unsigned int e;
+
+    fprintf(stdout, "\n[LMON FE] engine event latencies (usec)\n");
+    for (e = 0; e < estats->num_events; e++) {
+      if (estats->events[e].count == 0) continue;
+      fprintf(stdout, "[LMON FE] %-28s count %8lu mean %8lu max %8lu\n",
+              estats->events[e].name,
+              (unsigned long)estats->events[e].count,
+              (unsigned long)(estats->events[e].sum_usec /
+                              estats->events[e].count),
+              (unsigned long)estats->events[e].max_usec);
+    }
+    fprintf(stdout,
+            "[LMON FE] ptrace calls %lu, bulk reads %lu, bytes read %lu\n",
+            (unsigned long)estats->ptrace_calls,
+            (unsigned long)estats->mem_read_calls,
+            (unsigned long)estats->bytes_read);
+    fprintf(stdout, "[LMON FE] batched writes %lu, bytes written %lu\n",
+            (unsigned long)estats->mem_write_calls,
+            (unsigned long)estats->bytes_written);
+    fprintf(stdout,
+            "[LMON FE] breakpoint hits emulated %lu (stops saved), "
+            "single-stepped %lu\n",
+            (unsigned long)estats->bp_emulated,
+            (unsigned long)estats->bp_singlestepped);
+    fprintf(stdout,
+            "[LMON FE] register cache hits %lu misses %lu, "
+            "memory cache hits %lu misses %lu, incoherent %lu\n",
+            (unsigned long)estats->regs_cache_hits,
+            (unsigned long)estats->regs_cache_misses,
+            (unsigned long)estats->mem_cache_hits,
+            (unsigned long)estats->mem_cache_misses,
+            (unsigned long)estats->cache_incoherent);
+    fprintf(stdout, "[LMON FE] launcher threads detached %lu\n",
+            (unsigned long)estats->threads_detached);
+  }
+  free(estats);
+
   if ((getenv("LMON_FE_SHUTDOWNBE_TEST")) != NULL) {
     if ((rc = LMON_fe_shutdownDaemons(aSession)) != LMON_OK) {
       fprintf(stdout, "[LMON FE]LMON_fe_shutdownBe FAILED\n");
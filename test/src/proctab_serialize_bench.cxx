@@ -0,0 +1,195 @@
+/*
+ *--------------------------------------------------------------------------------
+ * Copyright (c) 2008, Lawrence Livermore National Security, LLC. Produced at
+ * the Lawrence Livermore National Laboratory. Written by Dong H. Ahn
+ * <ahn1@llnl.gov>. LLNL-CODE-409469. All rights reserved.
+ *
+ * This file is part of LaunchMON. For details, see
+ * https://computing.llnl.gov/?set=resources&page=os_projects
+ *
+ * Please also read LICENSE.txt -- Our Notice and GNU Lesser General Public
+ * License.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the terms and conditions of the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple
+ * Place, Suite 330, Boston, MA 02111-1307 USA
+ *--------------------------------------------------------------------------------
+ */
+
+#ifndef HAVE_LAUNCHMON_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <lmon_api/lmon_proctab.h>
+#include "sdbg_proctab.hxx"
+
+/*
+ * Microbenchmark of the engine's RPDTAB serialization
+ *
+ * Usage: proctab_serialize_bench [tasks-per-node]
+ *
+ * Builds synthetic proctables of 10K, 100K and 1M tasks and times
+ * proctab_t::serialize_rpdtab against the std::map-based string
+ * table packing the engine used before. Both must produce the
+ * same payload, as must the pieces serialize_rpdtab_chunk
+ * produces for the proctable stream once put back together.
+ */
+
+static size_t chunk_serialize(const proctab_t &pt, size_t chunk,
+                              char *payload) {
+  const size_t esize = N_Fields_MPIR_PROCDESC_EXT * sizeof(unsigned int);
+  proctab_t::rpdtab_cursor_t c;
+  std::vector<char> strtab;
+  std::vector<char> piece(pt.arena_size());
+
+  pt.begin_rpdtab(c);
+  while (c.next_task < pt.size()) {
+    size_t first = c.next_task;
+    size_t len = pt.serialize_rpdtab_chunk(c, chunk, payload + first * esize,
+                                           &piece[0]);
+    strtab.insert(strtab.end(), piece.begin(), piece.begin() + len);
+  }
+
+  if (!strtab.empty()) {
+    memcpy(payload + pt.size() * esize, &strtab[0], strtab.size());
+  }
+
+  return pt.size() * esize + strtab.size();
+}
+
+static double now() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+}
+
+static size_t map_serialize(const proctab_t &pt, char *payload) {
+  std::map<std::string, unsigned int> execHostName;
+  std::vector<const char *> orderedEHName;
+  unsigned int offset = 0;
+  size_t i;
+
+  for (i = 0; i < pt.size(); ++i) {
+    const char *en = pt.task_executable_name(i);
+    const char *hn = pt.task_host_name(i);
+
+    if (execHostName.find(std::string(en)) == execHostName.end()) {
+      execHostName[std::string(en)] = offset;
+      orderedEHName.push_back(en);
+      offset += (strlen(en) + 1);
+    }
+    if (execHostName.find(std::string(hn)) == execHostName.end()) {
+      execHostName[std::string(hn)] = offset;
+      orderedEHName.push_back(hn);
+      offset += (strlen(hn) + 1);
+    }
+  }
+
+  char *ptr = payload;
+  for (i = 0; i < pt.size(); ++i) {
+    int pid = pt.task_pid(i);
+    int rank = pt.task_rank(i);
+    int cnodeid = pt.task_cnodeid(i);
+
+    memcpy(ptr, &(execHostName[std::string(pt.task_host_name(i))]),
+           sizeof(unsigned int));
+    ptr += sizeof(unsigned int);
+    memcpy(ptr, &(execHostName[std::string(pt.task_executable_name(i))]),
+           sizeof(unsigned int));
+    ptr += sizeof(unsigned int);
+    memcpy(ptr, &pid, sizeof(int));
+    ptr += sizeof(int);
+    memcpy(ptr, &rank, sizeof(int));
+    ptr += sizeof(int);
+    memcpy(ptr, &cnodeid, sizeof(int));
+    ptr += sizeof(int);
+  }
+
+  std::vector<const char *>::const_iterator iter;
+  for (iter = orderedEHName.begin(); iter != orderedEHName.end(); ++iter) {
+    int leng = strlen(*iter) + 1;
+    memcpy(ptr, *iter, leng);
+    ptr += leng;
+  }
+
+  return (size_t)(ptr - payload);
+}
+
+int main(int argc, char *argv[]) {
+  const size_t ntasks[] = {10000, 100000, 1000000};
+  int tpn = 16;
+  size_t n;
+  int rc = EXIT_SUCCESS;
+
+  if (argc > 1) tpn = atoi(argv[1]);
+  if (tpn <= 0) tpn = 16;
+
+  printf("%10s %10s %12s %12s %12s\n", "tasks", "hosts", "bytes",
+         "map (s)", "intern (s)");
+
+  for (n = 0; n < sizeof(ntasks) / sizeof(ntasks[0]); ++n) {
+    proctab_t pt;
+    size_t i;
+    char hn[64];
+
+    pt.reserve(ntasks[n]);
+    proctab_t::str_id_t exec = pt.intern("/usr/workspace/bin/a.out");
+    for (i = 0; i < ntasks[n]; ++i) {
+      snprintf(hn, sizeof(hn), "node%06lu", (unsigned long)(i / tpn));
+      pt.append(pt.intern(hn), exec, 10000 + (int)(i % tpn), (int)i, -1);
+    }
+    pt.finalize();
+
+    char *buf1 = (char *)malloc(pt.rpdtab_size_bound());
+    char *buf2 = (char *)malloc(pt.rpdtab_size_bound());
+    unsigned int nexec, nhn;
+
+    double t0 = now();
+    size_t len1 = map_serialize(pt, buf1);
+    double t1 = now();
+    size_t len2 = pt.serialize_rpdtab(buf2, &nexec, &nhn);
+    double t2 = now();
+
+    printf("%10lu %10lu %12lu %12.6f %12.6f\n", (unsigned long)ntasks[n],
+           (unsigned long)pt.num_hosts(), (unsigned long)len2, t1 - t0,
+           t2 - t1);
+
+    if (len1 != len2 || memcmp(buf1, buf2, len1) != 0 ||
+        nhn != pt.num_hosts() || nexec != 1) {
+      fprintf(stderr, "payload mismatch at %lu tasks\n",
+              (unsigned long)ntasks[n]);
+      rc = EXIT_FAILURE;
+    }
+
+    size_t len3 = chunk_serialize(pt, 4096, buf1);
+    if (len3 != len2 || memcmp(buf1, buf2, len2) != 0) {
+      fprintf(stderr, "chunked payload mismatch at %lu tasks\n",
+              (unsigned long)ntasks[n]);
+      rc = EXIT_FAILURE;
+    }
+
+    free(buf1);
+    free(buf2);
+  }
+
+  return rc;
+}
@@ -0,0 +1,314 @@
+/*
+ *--------------------------------------------------------------------------------
+ * Copyright (c) 2008, Lawrence Livermore National Security, LLC. Produced at
+ * the Lawrence Livermore National Laboratory. Written by Dong H. Ahn
+ * <ahn1@llnl.gov>. LLNL-CODE-409469. All rights reserved.
+ *
+ * This file is part of LaunchMON. For details, see
+ * https://computing.llnl.gov/?set=resources&page=os_projects
+ *
+ * Please also read LICENSE.txt -- Our Notice and GNU Lesser General Public
+ * License.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the terms and conditions of the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple
+ * Place, Suite 330, Boston, MA 02111-1307 USA
+ *--------------------------------------------------------------------------------
+ */
+
+#ifndef HAVE_LAUNCHMON_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dirent.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "sdbg_std.hxx"
+#include "sdbg_base_symtab.hxx"
+#include "sdbg_base_symtab_impl.hxx"
+#include "sdbg_linux_std.hxx"
+#include "sdbg_linux_symtab.hxx"
+#include "sdbg_linux_symtab_impl.hxx"
+
+/*
+ * Benchmark of the symbol table phase of engine startup
+ *
+ * Usage: symtab_cache_bench [image ...]
+ *
+ * For each image (default: this program and the shared objects
+ * it has loaded) it resolves the symbols the engine looks up at
+ * startup through linux_image_t, as the engine does. The cold run
+ * starts from an empty persistent symbol cache, the warm runs
+ * reuse the one the cold run wrote. The baseline run reads each
+ * image's whole symbol table with libelf, the way the engine did
+ * before symbols were resolved on demand. All runs must resolve
+ * every symbol to the same value.
+ */
+
+typedef linux_image_t<T_VA> bench_image_t;
+
+static const char *engine_symbols[] = {
+    "MPIR_Breakpoint",      "MPIR_debug_state",   "MPIR_being_debugged",
+    "MPIR_proctable",       "MPIR_proctable_size", "MPIR_debug_gate",
+    "MPIR_executable_path", "MPIR_server_arguments", "MPIR_partial_attach_ok",
+    "_dl_debug_state",      "_r_debug",           "_dl_debug_addr",
+    "nptl_version",         "__libc_start_main",  "main",
+    "malloc",               NULL};
+
+static double now() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+}
+
+static void default_images(std::vector<std::string> &images) {
+  std::set<std::string> seen;
+  char line[PATH_MAX + 256];
+  char exe[PATH_MAX];
+  ssize_t len;
+  FILE *fp;
+
+  if ((len = readlink("/proc/self/exe", exe, sizeof(exe) - 1)) > 0) {
+    exe[len] = '\0';
+    images.push_back(exe);
+    seen.insert(exe);
+  }
+
+  if (!(fp = fopen("/proc/self/maps", "r"))) {
+    return;
+  }
+
+  while (fgets(line, sizeof(line), fp)) {
+    char *path = strchr(line, '/');
+    if (!path) continue;
+    path[strcspn(path, "\n")] = '\0';
+    if (!strstr(path, ".so") || seen.count(path)) continue;
+    images.push_back(path);
+    seen.insert(path);
+  }
+
+  fclose(fp);
+}
+
+//
+// resolves engine_symbols in images with linux_image_t, which
+// goes through the symbol cache; each image writes its cache
+// file as it is destroyed
+//
+static void resolve(const std::vector<std::string> &images,
+                    std::vector<long long> &values) {
+  size_t i, k;
+
+  values.clear();
+
+  for (i = 0; i < images.size(); ++i) {
+    bench_image_t image(images[i]);
+
+    image.init();
+    image.read_linkage_symbols();
+
+    for (k = 0; engine_symbols[k]; ++k) {
+      const symbol_base_t<T_VA> &sym = image.get_a_symbol(engine_symbols[k]);
+      values.push_back(sym.get_name() == SYMTAB_UNINIT_STRING
+                           ? -1LL
+                           : (long long)sym.get_raw_address());
+    }
+  }
+}
+
+//
+// resolves engine_symbols in images from their whole symbol
+// tables, read with libelf into the image's linkage symbol map
+//
+static void resolve_libelf(const std::vector<std::string> &images,
+                           std::vector<long long> &values) {
+  size_t i, k;
+
+  values.clear();
+
+  for (i = 0; i < images.size(); ++i) {
+    bench_image_t image(images[i]);
+    std::map<std::string, symbol_base_t<T_VA> *, ltstr> &symtab =
+        image.get_linkage_symtab();
+    elf_wrapper elfw(images[i]);
+    lmon_elf_shdr_t *shdr = NULL;
+    lmon_elf_shdr_t *shdrdyn = NULL;
+    Elf_Scn *symtab_sect = NULL;
+    Elf_Scn *dynsym_sect = NULL;
+    Elf_Scn *sect = NULL;
+    Elf_Data *elf_data = NULL;
+
+    elfw.init();
+    Elf *elf_h = elfw.get_elf_handler();
+
+    while ((sect = elf_nextscn(elf_h, sect)) != NULL) {
+#if BIT64
+      if ((shdr = elf64_getshdr(sect)) == NULL) continue;
+#else
+      if ((shdr = elf32_getshdr(sect)) == NULL) continue;
+#endif
+      if (shdr->sh_type == SHT_SYMTAB) {
+        symtab_sect = sect;
+        break;
+      } else if (shdr->sh_type == SHT_DYNSYM) {
+        dynsym_sect = sect;
+        shdrdyn = shdr;
+      }
+    }
+
+    if (!symtab_sect) {
+      symtab_sect = dynsym_sect;
+      shdr = shdrdyn;
+    }
+
+    if (symtab_sect && (elf_data = elf_getdata(symtab_sect, NULL)) != NULL) {
+      lmon_elf_sym_t *first_sym = (lmon_elf_sym_t *)elf_data->d_buf;
+      lmon_elf_sym_t *last_sym =
+          (lmon_elf_sym_t *)((char *)elf_data->d_buf + elf_data->d_size);
+
+      for (; first_sym < last_sym; first_sym++) {
+        char *symname =
+            elf_strptr(elf_h, shdr->sh_link, (size_t)first_sym->st_name);
+        if (!symname || *symname == '\0' || first_sym->st_value == 0) continue;
+
+        linkage_symbol_t<T_VA> *a_linksym = new linkage_symbol_t<T_VA>(
+            symname, image.get_base_image_name(),
+            (const T_VA)first_sym->st_value, (const T_VA)SYMTAB_UNINIT_ADDR);
+
+        std::string tmp;
+        image.decode_binding(first_sym->st_info, tmp);
+        a_linksym->set_binding(tmp);
+        a_linksym->set_vis(image.resolve_binding(first_sym->st_info));
+        image.decode_visibility(first_sym->st_other, tmp);
+        a_linksym->set_visibility(tmp);
+        image.decode_type(first_sym->st_info, tmp);
+        a_linksym->set_type(tmp);
+        a_linksym->set_defined(first_sym->st_shndx != SHN_UNDEF);
+
+        if (!symtab.insert(std::make_pair(std::string(symname),
+                                          (symbol_base_t<T_VA> *)a_linksym))
+                 .second) {
+          delete a_linksym;
+        }
+      }
+    }
+
+    for (k = 0; engine_symbols[k]; ++k) {
+      std::map<std::string, symbol_base_t<T_VA> *, ltstr>::const_iterator pos =
+          symtab.find(engine_symbols[k]);
+      values.push_back(pos == symtab.end()
+                           ? -1LL
+                           : (long long)pos->second->get_raw_address());
+    }
+  }
+}
+
+//
+// removes the cache files in dir, then dir itself
+//
+static int remove_cache_dir(const char *dir) {
+  DIR *d;
+  struct dirent *ent;
+  int rc = 0;
+
+  if ((d = opendir(dir)) == NULL) {
+    return -1;
+  }
+
+  while ((ent = readdir(d)) != NULL) {
+    if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) {
+      continue;
+    }
+    std::string fn = std::string(dir) + "/" + ent->d_name;
+    if (unlink(fn.c_str()) != 0) {
+      rc = -1;
+    }
+  }
+  closedir(d);
+
+  return (rmdir(dir) == 0) ? rc : -1;
+}
+
+static int report(const char *run, size_t nimages,
+                  const std::vector<long long> &values,
+                  const std::vector<long long> &expected, double t) {
+  printf("%10s %8lu %12.6f\n", run, (unsigned long)nimages, t);
+
+  if (values != expected) {
+    fprintf(stderr, "%s run disagrees with the cold run\n", run);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+  const int nwarm = 5;
+  std::vector<std::string> images;
+  std::vector<long long> cold, values;
+  char dir[] = "/tmp/symtab_cache_bench.XXXXXX";
+  double t0;
+  int i, rc = EXIT_SUCCESS;
+
+  for (i = 1; i < argc; ++i) {
+    images.push_back(argv[i]);
+  }
+  if (images.empty()) {
+    default_images(images);
+  }
+
+  if (!mkdtemp(dir)) {
+    perror("mkdtemp");
+    return EXIT_FAILURE;
+  }
+  setenv("LMON_ENGINE_SYMCACHE_DIR", dir, 1);
+  unsetenv("LMON_ENGINE_SYMCACHE");
+
+  try {
+    printf("%10s %8s %12s\n", "run", "images", "time (s)");
+
+    t0 = now();
+    resolve(images, cold);
+    rc |= report("cold", images.size(), cold, cold, now() - t0);
+
+    for (i = 0; i < nwarm; ++i) {
+      t0 = now();
+      resolve(images, values);
+      rc |= report("warm", images.size(), values, cold, now() - t0);
+    }
+
+    t0 = now();
+    resolve_libelf(images, values);
+    rc |= report("libelf", images.size(), values, cold, now() - t0);
+  } catch (symtab_exception_t e) {
+    fprintf(stderr, "%s\n", e.get_message().c_str());
+    rc = EXIT_FAILURE;
+  }
+
+  if (remove_cache_dir(dir) != 0) {
+    perror("removing the cache directory");
+    rc = EXIT_FAILURE;
+  }
+
+  return rc;
+}
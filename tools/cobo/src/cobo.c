@@ -5,7 +5,9 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <string.h>
+#include <ctype.h>
 #include <netdb.h>
 #include <errno.h>
 #include <stdarg.h>
@@ -37,6 +39,20 @@
 #define COBO_CONNECT_TIMELIMIT (600) /* seconds -- wait this long before giving up for good */
 #endif
 
+/* set env variable to configure the broadcast segment size */
+#ifndef COBO_BCAST_SEGMENT
+#define COBO_BCAST_SEGMENT (64*1024) /* bytes -- forward broadcast data in pieces of this size, 0 forwards whole messages */
+#endif
+
+/* set env variable to configure the shape of the tree */
+#ifndef COBO_TREE_FANOUT
+#define COBO_TREE_FANOUT (8) /* children per task in k-ary trees, and per group in topology-aware trees */
+#endif
+
+/* ids of user reduction ops start at COBO_OP_USER */
+#define COBO_OP_USER      (64)
+#define COBO_MAX_USER_OPS (16)
+
 #if defined(_IA64_)
 #undef htons
 #undef ntohs
@@ -75,6 +91,17 @@ static int cobo_connect_backoff       = COBO_CONNECT_BACKOFF;   /* exponential b
 static int cobo_connect_sleep         = COBO_CONNECT_SLEEP;     /* milliseconds to sleep before rescanning ports */
 static double cobo_connect_timelimit  = COBO_CONNECT_TIMELIMIT; /* seconds */
 
+/* broadcast settings */
+static int cobo_bcast_segment = COBO_BCAST_SEGMENT; /* bytes to forward to children as soon as they arrive */
+
+/* outstanding non-blocking collectives, in the order they were posted */
+static struct cobo_request_struct* cobo_req_head = NULL;
+static struct cobo_request_struct* cobo_req_tail = NULL;
+
+/* reduction ops registered with cobo_op_create, op COBO_OP_USER+i calls cobo_user_ops[i] */
+static cobo_op_fn cobo_user_ops[COBO_MAX_USER_OPS];
+static int cobo_num_user_ops = 0;
+
 /* to establish a connection, the service and session ids must match
  * the sessionid will be provided by the user, it should be a random
  * number which associate processes with the same session */
@@ -102,6 +129,11 @@ static int  cobo_num_child  = 0;     /* number of children */
 static int* cobo_child_incl = NULL;  /* number of children each child is responsible for (includes itself) */
 static int  cobo_num_child_incl = 0; /* total number of children this node is responsible for */
 
+/* tree shape, the server picks it and each parent forwards it along with the hostlist */
+static int cobo_tree_shape  = COBO_TREE_BINOMIAL; /* one of COBO_TREE_* */
+static int cobo_tree_fanout = COBO_TREE_FANOUT;   /* children per task (k-ary) or per group (topology-aware) */
+static int cobo_tree_group  = 0;                  /* hosts per switch in topology-aware trees, 0 groups by name only */
+
 static int cobo_root_fd = -1;
 
 double __cobo_ts = 0.0f;
@@ -497,6 +529,29 @@ static int cobo_connect(struct in_addr ip, int port, int timeout)
     return s;
 }
 
+/*
+ * returns 1 if the peer of socket s has closed or reset the connection, a task
+ * that already has its parent closes any other connection pending on its port,
+ * which happens when tasks share a host and several parents scan its ports
+ */
+static int cobo_peer_closed(int s)
+{
+    char c;
+    int rc = recv(s, &c, sizeof(c), MSG_PEEK | MSG_DONTWAIT);
+    return (rc == 0 || (rc < 0 && (errno == ECONNRESET || errno == ENOTCONN || errno == EPIPE)));
+}
+
+/* sends data written to socket s right away, broadcast segments and small control messages should not wait for acks */
+static void cobo_set_nodelay(int s)
+{
+    int on = 1;
+    if (setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)) < 0) {
+        cobo_debug(1, "Setting TCP_NODELAY (setsockopt() %m errno=%d) @ file %s:%d",
+                   errno, __FILE__, __LINE__
+        );
+    }
+}
+
 /* Attempts to connect to a given hostname using a port list and timeouts */
 static int cobo_connect_hostname(char* hostname, int rank)
 {
@@ -546,6 +601,12 @@ static int cobo_connect_hostname(char* hostname, int rank)
                    case HSHAKE_SUCCESS:
                       break;
                    case HSHAKE_INTERNAL_ERROR:
+                      if (cobo_peer_closed(s)) {
+                          cobo_debug(1, "Connection dropped when handshaking with server: %s\n",
+                                     handshake_last_error_str());
+                          test_failed = 1;
+                          break;
+                      }
                       cobo_debug(1, "Error handshaking with server: %s\n", handshake_last_error_str());
                       abort();
                    case HSHAKE_DROP_CONNECTION:
@@ -613,6 +674,7 @@ static int cobo_connect_hostname(char* hostname, int rank)
                 if (test_failed) {
                     close(s);
                 } else {
+                    cobo_set_nodelay(s);
                     connected = 1;
                     break;
                 }
@@ -681,6 +743,15 @@ static int cobo_send_hostlist(int s, char* hostname, int rank, int ranks, void*
         return (!COBO_SUCCESS);
     }
 
+    /* forward the shape of the tree, so that every task computes the same one */
+    int tree[3] = { cobo_tree_shape, cobo_tree_fanout, cobo_tree_group };
+    if (cobo_write_fd(s, tree, sizeof(tree)) < 0) {
+        cobo_error("Writing tree shape to rank %d on %s failed @ file %s:%d",
+                   rank, hostname, __FILE__, __LINE__
+        );
+        return (!COBO_SUCCESS);
+    }
+
     /* forward the size of the hostlist in bytes */
     if (cobo_write_fd(s, &bytes, sizeof(bytes)) < 0) {
         cobo_error("Writing hostname table to rank %d on %s failed @ file %s:%d",
@@ -720,15 +791,164 @@ static char* cobo_expand_hostname(int rank)
     return strdup(hostname);
 }
 
-/* given cobo_me and cobo_nprocs, fills in parent and children ranks -- currently implements a binomial tree */
+/*
+ * Every tree is built so that the subtree of a task covers a contiguous range
+ * of ranks starting at the task itself, which is what gather and scatter rely
+ * on.  A tree builder splits the range [low+1, high] below the task at low into
+ * consecutive pieces, one per child, the first rank of a piece being the child.
+ * It fills in starts[] in increasing order, sets starts[n] = high+1 and returns
+ * the number of pieces n.
+ */
+
+/* binomial tree: the upper half of the range goes to a child, repeat on the lower half */
+static int cobo_split_binomial(int low, int high, int* starts)
+{
+    int n = 0;
+    int top = high;
+    while (top - low > 0) {
+        int mid = (top - low) / 2 + (top - low) % 2 + low;
+        starts[n++] = mid;
+        top = mid-1;
+    }
+
+    /* we found the children from the highest rank down, so flip them */
+    int i;
+    for (i=0; i < n/2; i++) {
+        int tmp = starts[i];
+        starts[i] = starts[n-1-i];
+        starts[n-1-i] = tmp;
+    }
+    starts[n] = high+1;
+
+    return n;
+}
+
+/* k-ary tree: cut the range into up to k pieces of (nearly) equal size */
+static int cobo_split_kary(int low, int high, int k, int* starts)
+{
+    int count = high - low;
+    int n = (count < k) ? count : k;
+
+    int i;
+    int start = low+1;
+    for (i=0; i < n; i++) {
+        starts[i] = start;
+        start += count / n + (i < count % n);
+    }
+    starts[n] = high+1;
+
+    return n;
+}
+
+/*
+ * topology-aware tree: ranks are grouped in runs of consecutive ranks whose
+ * hosts hang off the same switch (see cobo_compute_groups).  The rest of the
+ * task's own run is cut into a k-ary tree, which keeps those edges inside the
+ * switch, and the runs that follow are dealt out to up to k group leaders.
+ */
+static int cobo_split_topo(int low, int high, int k, int* run_of, int* run_start, int* starts)
+{
+    /* split the rest of our own group */
+    int end = run_start[run_of[low]+1] - 1;
+    if (end > high) {
+        end = high;
+    }
+    int n = cobo_split_kary(low, end, k, starts);
+
+    /* then hand out whole groups to leaders in other groups */
+    if (end < high) {
+        int first = run_of[end+1];
+        int runs  = run_of[high] - first + 1;
+        int m = (runs < k) ? runs : k;
+
+        int i;
+        int run = first;
+        for (i=0; i < m; i++) {
+            starts[n++] = run_start[run];
+            run += runs / m + (i < runs % m);
+        }
+        starts[n] = high+1;
+    }
+
+    return n;
+}
+
+/* locates the node number at the end of the short name of hostname, returns the length of the prefix before it */
+static int cobo_host_prefix(const char* hostname, long* number)
+{
+    int len = strcspn(hostname, ".");
+    int end = len;
+    while (end > 0 && isdigit((unsigned char) hostname[end-1])) {
+        end--;
+    }
+
+    *number = (end < len) ? strtol(hostname + end, NULL, 10) : 0;
+    return end;
+}
+
+/*
+ * groups ranks into runs of consecutive ranks whose hosts share a switch, which
+ * we read off the hostname: hosts share a switch if their short names match up
+ * to the node number and, when cobo_tree_group is set, their node numbers fall
+ * into the same block of cobo_tree_group hosts.  Fills in run_of[rank] and
+ * run_start[run] for each run, with run_start[runs] = cobo_nprocs.
+ */
+static int cobo_compute_groups(int* run_of, int* run_start)
+{
+    int runs = 0;
+    char* prev = NULL;
+    int prev_len = 0;
+    long prev_num = 0;
+
+    int i;
+    for (i=0; i < cobo_nprocs; i++) {
+        char* host = cobo_expand_hostname(i);
+        long num;
+        int len = cobo_host_prefix(host, &num);
+
+        int same = (prev != NULL && len == prev_len && strncmp(host, prev, len) == 0);
+        if (same && cobo_tree_group > 0) {
+            same = (num / cobo_tree_group == prev_num / cobo_tree_group);
+        }
+        if (!same) {
+            run_start[runs++] = i;
+        }
+        run_of[i] = runs-1;
+
+        cobo_free(prev);
+        prev     = host;
+        prev_len = len;
+        prev_num = num;
+    }
+    cobo_free(prev);
+    run_start[runs] = cobo_nprocs;
+
+    return runs;
+}
+
+/* given cobo_me and cobo_nprocs, fills in parent and children ranks for the tree shape in cobo_tree_shape */
 static int cobo_compute_children()
 {
+    int k = cobo_tree_fanout;
+    int* run_of    = NULL;
+    int* run_start = NULL;
+
     /* compute the maximum number of children this task may have */
-    int n = 1;
     int max_children = 0;
-    while (n < cobo_nprocs) {
-        n <<= 1;
-        max_children++;
+    if (cobo_tree_shape == COBO_TREE_BINOMIAL) {
+        int n = 1;
+        while (n < cobo_nprocs) {
+            n <<= 1;
+            max_children++;
+        }
+    } else if (cobo_tree_shape == COBO_TREE_KARY) {
+        max_children = k;
+    } else {
+        max_children = 2 * k;
+        run_of    = (int*) cobo_malloc(cobo_nprocs * sizeof(int), "Group index array");
+        run_start = (int*) cobo_malloc((cobo_nprocs+1) * sizeof(int), "Group start array");
+        int runs = cobo_compute_groups(run_of, run_start);
+        cobo_debug(1, "Topology-aware tree over %d groups of hosts", runs);
     }
 
     /* prepare data structures to store our parent and children */
@@ -738,23 +958,47 @@ static int cobo_compute_children()
     cobo_child      = (int*) cobo_malloc(max_children * sizeof(int), "Child rank array");
     cobo_child_fd    = (int*) cobo_malloc(max_children * sizeof(int), "Child socket fd array");
     cobo_child_incl = (int*) cobo_malloc(max_children * sizeof(int), "Child children count array");
+    int* starts     = (int*) cobo_malloc((max_children+1) * sizeof(int), "Subtree start array");
 
-    /* find our parent rank and the ranks of our children */
+    /* walk down from rank 0 through the subtrees that hold us to find our parent and children */
     int low  = 0;
     int high = cobo_nprocs - 1;
-    while (high - low > 0) {
-        int mid = (high - low) / 2 + (high - low) % 2 + low;
+    while (1) {
+        int n;
+        if (cobo_tree_shape == COBO_TREE_BINOMIAL) {
+            n = cobo_split_binomial(low, high, starts);
+        } else if (cobo_tree_shape == COBO_TREE_KARY) {
+            n = cobo_split_kary(low, high, k, starts);
+        } else {
+            n = cobo_split_topo(low, high, k, run_of, run_start, starts);
+        }
+
         if (low == cobo_me) {
-            cobo_child[cobo_num_child] = mid;
-            cobo_child_incl[cobo_num_child] = high - mid + 1;
-            cobo_num_child++;
-            cobo_num_child_incl += (high - mid + 1);
+            /* our children, highest rank first as the collectives expect */
+            int i;
+            for (i=n-1; i >= 0; i--) {
+                cobo_child[cobo_num_child] = starts[i];
+                cobo_child_incl[cobo_num_child] = starts[i+1] - starts[i];
+                cobo_num_child++;
+                cobo_num_child_incl += starts[i+1] - starts[i];
+            }
+            break;
+        }
+
+        /* descend into the piece that holds us */
+        int i = 0;
+        while (starts[i+1] <= cobo_me) {
+            i++;
         }
-        if (mid == cobo_me) { cobo_parent = low; }
-        if (mid <= cobo_me) { low  = mid; }
-        else                { high = mid-1; }
+        cobo_parent = low;
+        low  = starts[i];
+        high = starts[i+1] - 1;
     }
 
+    cobo_free(starts);
+    cobo_free(run_of);
+    cobo_free(run_start);
+
     return COBO_SUCCESS;
 }
 
@@ -900,6 +1144,7 @@ static int cobo_open_tree()
         }
 
         /* if we get here, we've got a good connection to our parent */
+        cobo_set_nodelay(cobo_parent_fd);
         have_parent = 1;
     }
 
@@ -926,6 +1171,18 @@ static int cobo_open_tree()
         exit(1);
     }
 
+    /* adopt the tree shape the server picked */
+    int tree[3];
+    if (cobo_read_fd(cobo_parent_fd, tree, sizeof(tree)) < 0) {
+        cobo_error("Receiving tree shape from parent failed @ file %s:%d",
+                   __FILE__, __LINE__
+        );
+        exit(1);
+    }
+    cobo_tree_shape  = tree[0];
+    cobo_tree_fanout = tree[1];
+    cobo_tree_group  = tree[2];
+
     /* read the size of the hostlist (in bytes) */
     if (cobo_read_fd(cobo_parent_fd, &cobo_hostlist_size, sizeof(int)) < 0) {
         cobo_error("Receiving size of hostname table from parent failed @ file %s:%d",
@@ -1014,79 +1271,457 @@ static int cobo_close_tree()
 
 /*
  * =============================
- * Functions to bcast/gather/scatter with root as rank 0 using the TCP/socket tree.
+ * Non-blocking collectives, moved along by cobo_test and cobo_wait.
  * =============================
-*/
+ */
 
-/* broadcast size bytes from buf on rank 0 using socket tree */
-static int cobo_bcast_tree(void* buf, int size)
+/*
+ * A non-blocking collective runs in two phases over the tree rooted at rank 0.
+ * In the up phase, the data of each child is read into upbuf and then upcount
+ * bytes of upbuf are sent to the parent.  In the down phase, downcount bytes
+ * from the parent are read into downbuf and forwarded to every child.  Either
+ * phase may be empty, and the down phase starts once the up phase is done.
+ * All socket I/O is non-blocking, so a request advances only as far as its
+ * sockets allow each time the progress engine polls them.
+ */
+struct cobo_request_struct {
+    /* up phase, children to parent */
+    char* upbuf;
+    int   upcount;     /* bytes of upbuf to send to the parent */
+    int   upready;     /* bytes at the start of upbuf ready before any child data arrives */
+    int   upstream;    /* forward to the parent as leading bytes arrive, rather than after all children */
+    int   upsent;
+    int*  child_off;   /* offset in upbuf of the data of each child */
+    int*  child_len;   /* bytes to read from each child */
+    int*  child_recv;  /* bytes read from each child so far */
+
+    /* down phase, parent to children */
+    char* downbuf;
+    int   downcount;
+    int   downrecv;
+    int*  child_sent;  /* bytes forwarded to each child so far */
+
+    void* tmpbuf;      /* freed along with the request */
+    int   complete;
+    struct cobo_request_struct* next;
+};
+
+/* allocate a request with empty phases for this task and its children */
+static struct cobo_request_struct* cobo_request_alloc()
 {
-    int rc = COBO_SUCCESS;
+    struct cobo_request_struct* req = (struct cobo_request_struct*)
+        cobo_malloc(sizeof(struct cobo_request_struct), "Request in cobo_request_alloc");
+    memset(req, 0, sizeof(struct cobo_request_struct));
+
+    if (cobo_num_child > 0) {
+        int* ints = (int*) cobo_malloc(4 * cobo_num_child * sizeof(int), "Child state in cobo_request_alloc");
+        memset(ints, 0, 4 * cobo_num_child * sizeof(int));
+        req->child_off  = ints;
+        req->child_len  = ints + cobo_num_child;
+        req->child_recv = ints + 2 * cobo_num_child;
+        req->child_sent = ints + 3 * cobo_num_child;
+    }
+
+    return req;
+}
+
+static void cobo_request_free(struct cobo_request_struct* req)
+{
+    cobo_free(req->tmpbuf);
+    cobo_free(req->child_off);
+    cobo_free(req);
+}
+
+/* bytes of upbuf that may be sent to the parent so far */
+static int cobo_request_upavail(struct cobo_request_struct* req)
+{
+    int avail = req->upready;
     int i;
+    for(i=cobo_num_child-1; i>=0; i--) {
+        if (req->upstream) {
+            avail += req->child_recv[i];
+        }
+        if (req->child_recv[i] < req->child_len[i]) {
+            return req->upstream ? avail : 0;
+        }
+    }
+    return req->upcount;
+}
 
-    /* if i'm not rank 0, receive data from parent */
-    if (cobo_me != 0) {
-        if (cobo_read_fd(cobo_parent_fd, buf, size) < 0) {
-            cobo_error("Receiving broadcast data from parent failed @ file %s:%d",
-                       __FILE__, __LINE__
-            );
-            exit(1);
+/* add req to the tail of the queue of outstanding requests */
+static void cobo_request_post(struct cobo_request_struct* req)
+{
+    /* the root already holds the data of the down phase */
+    if (cobo_me == 0) {
+        req->downrecv = req->downcount;
+    }
+
+    if (cobo_req_tail != NULL) {
+        cobo_req_tail->next = req;
+    } else {
+        cobo_req_head = req;
+    }
+    cobo_req_tail = req;
+}
+
+/* move nbytes of non-blocking I/O on fd, returns the bytes moved, possibly 0 */
+static int cobo_request_io(int fd, char* buf, int nbytes, int is_read, int rank)
+{
+    int rc;
+    if (is_read) {
+        rc = recv(fd, buf, nbytes, MSG_DONTWAIT);
+    } else {
+        rc = send(fd, buf, nbytes, MSG_DONTWAIT);
+    }
+
+    if (rc < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
         }
+        cobo_error("%s rank %d in a non-blocking collective failed (fd=%d %m errno=%d) @ file %s:%d",
+                   is_read ? "Reading from" : "Writing to", rank, fd, errno, __FILE__, __LINE__
+        );
+        exit(1);
+    } else if (rc == 0 && is_read) {
+        cobo_error("Rank %d closed its connection in a non-blocking collective (fd=%d) @ file %s:%d",
+                   rank, fd, __FILE__, __LINE__
+        );
+        exit(1);
     }
 
-    /* for each child, forward data */
+    return rc;
+}
+
+/* whether all data of req has moved */
+static int cobo_request_done(struct cobo_request_struct* req)
+{
+    int i;
     for(i=0; i<cobo_num_child; i++) {
-        if (cobo_write_fd(cobo_child_fd[i], buf, size) < 0) {
-            cobo_error("Broadcasting data to child (rank %d) failed @ file %s:%d",
-                       cobo_child[i], __FILE__, __LINE__
+        if (req->child_recv[i] < req->child_len[i] || req->child_sent[i] < req->downcount) {
+            return 0;
+        }
+    }
+    if (cobo_me != 0 && req->upsent < req->upcount) {
+        return 0;
+    }
+    return req->downrecv == req->downcount;
+}
+
+/*
+ * poll the sockets req is waiting on for at most timeout milliseconds (-1 waits
+ * until one is ready) and move whatever data they are ready for, returns 1 once
+ * req is complete
+ */
+static int cobo_request_progress(struct cobo_request_struct* req, int timeout)
+{
+    struct pollfd fds[cobo_num_child + 1];
+    int which[cobo_num_child + 1];
+    int nfds = 0;
+    int i, k;
+
+    if (req->complete) {
+        return 1;
+    }
+
+    /* collect the sockets of the current phase that have data to move */
+    int updone = 1;
+    for(i=0; i<cobo_num_child; i++) {
+        if (req->child_recv[i] < req->child_len[i]) {
+            fds[nfds].fd = cobo_child_fd[i];
+            fds[nfds].events = POLLIN;
+            which[nfds++] = i;
+            updone = 0;
+        }
+    }
+
+    if (cobo_me != 0 && req->upsent < req->upcount) {
+        if (cobo_request_upavail(req) > req->upsent) {
+            fds[nfds].fd = cobo_parent_fd;
+            fds[nfds].events = POLLOUT;
+            which[nfds++] = -1;
+        }
+        updone = 0;
+    }
+
+    if (updone) {
+        if (req->downrecv < req->downcount) {
+            fds[nfds].fd = cobo_parent_fd;
+            fds[nfds].events = POLLIN;
+            which[nfds++] = -1;
+        }
+        for(i=0; i<cobo_num_child; i++) {
+            if (req->child_sent[i] < req->downrecv) {
+                fds[nfds].fd = cobo_child_fd[i];
+                fds[nfds].events = POLLOUT;
+                which[nfds++] = i;
+            }
+        }
+    }
+
+    if (nfds > 0 && poll(fds, nfds, timeout) < 0) {
+        if (errno != EINTR && errno != EAGAIN) {
+            cobo_error("Polling sockets of a non-blocking collective failed (%m errno=%d) @ file %s:%d",
+                       errno, __FILE__, __LINE__
             );
             exit(1);
         }
+        nfds = 0;
+    }
+
+    /* a hang up or an error also shows up in revents, the I/O call reports it */
+    for(k=0; k<nfds; k++) {
+        if (fds[k].revents == 0) {
+            continue;
+        }
+
+        i = which[k];
+        if (!updone && i >= 0) {
+            req->child_recv[i] += cobo_request_io(cobo_child_fd[i],
+                req->upbuf + req->child_off[i] + req->child_recv[i],
+                req->child_len[i] - req->child_recv[i], 1, cobo_child[i]
+            );
+        } else if (!updone) {
+            req->upsent += cobo_request_io(cobo_parent_fd,
+                req->upbuf + req->upsent,
+                cobo_request_upavail(req) - req->upsent, 0, cobo_parent
+            );
+        } else if (i >= 0) {
+            req->child_sent[i] += cobo_request_io(cobo_child_fd[i],
+                req->downbuf + req->child_sent[i],
+                req->downrecv - req->child_sent[i], 0, cobo_child[i]
+            );
+        } else {
+            req->downrecv += cobo_request_io(cobo_parent_fd,
+                req->downbuf + req->downrecv,
+                req->downcount - req->downrecv, 1, cobo_parent
+            );
+        }
+    }
+
+    req->complete = cobo_request_done(req);
+    return req->complete;
+}
+
+/*
+ * advance the outstanding requests in the order they were posted, which is the
+ * order their data travels over each socket, until req is complete (or all of
+ * them when req is NULL); if block is 0, return as soon as the oldest request
+ * can go no further without waiting
+ */
+static void cobo_progress(struct cobo_request_struct* req, int block)
+{
+    while (cobo_req_head != NULL && (req == NULL || !req->complete)) {
+        struct cobo_request_struct* head = cobo_req_head;
+        if (!cobo_request_progress(head, block ? -1 : 0)) {
+            if (!block) {
+                break;
+            }
+            continue;
+        }
+
+        cobo_req_head = head->next;
+        if (cobo_req_head == NULL) {
+            cobo_req_tail = NULL;
+        }
+        head->next = NULL;
+    }
+}
+
+/*
+ * =============================
+ * Functions to bcast/gather/scatter with root as rank 0 using the TCP/socket tree.
+ * =============================
+*/
+
+/*
+ * broadcast size bytes from buf on rank 0 using socket tree, the data is
+ * forwarded in pieces of cobo_bcast_segment bytes as soon as each arrives, so
+ * that a large message streams down the tree rather than being held at each
+ * level until all of it has been received
+ */
+static int cobo_bcast_tree(void* buf, int size)
+{
+    cobo_progress(NULL, 1);
+
+    int rc = COBO_SUCCESS;
+    int i;
+
+    int segment = size;
+    if (cobo_bcast_segment > 0 && cobo_bcast_segment < size) {
+        segment = cobo_bcast_segment;
+    }
+
+    int offset = 0;
+    while (offset < size) {
+        char* piece = (char*)buf + offset;
+        int count = size - offset;
+        if (count > segment) {
+            count = segment;
+        }
+
+        /* if i'm not rank 0, receive the next piece from parent */
+        if (cobo_me != 0) {
+            if (cobo_read_fd(cobo_parent_fd, piece, count) < 0) {
+                cobo_error("Receiving broadcast data from parent failed @ file %s:%d",
+                           __FILE__, __LINE__
+                );
+                exit(1);
+            }
+        }
+
+        /* for each child, forward the piece */
+        for(i=0; i<cobo_num_child; i++) {
+            if (cobo_write_fd(cobo_child_fd[i], piece, count) < 0) {
+                cobo_error("Broadcasting data to child (rank %d) failed @ file %s:%d",
+                           cobo_child[i], __FILE__, __LINE__
+                );
+                exit(1);
+            }
+        }
+
+        offset += count;
     }
 
     return rc;
 }
 
-/* reduce maximum integer to rank 0 */
-static int cobo_allreduce_max_int_tree(int* sendbuf, int* recvbuf)
+/* bytes in one element of type, -1 for an unknown type */
+static int cobo_type_size(int type)
+{
+    switch (type) {
+    case COBO_CHAR:               return sizeof(char);
+    case COBO_INT:                return sizeof(int);
+    case COBO_UNSIGNED:           return sizeof(unsigned int);
+    case COBO_LONG:               return sizeof(long);
+    case COBO_UNSIGNED_LONG:      return sizeof(unsigned long);
+    case COBO_LONG_LONG:          return sizeof(long long);
+    case COBO_UNSIGNED_LONG_LONG: return sizeof(unsigned long long);
+    case COBO_FLOAT:              return sizeof(float);
+    case COBO_DOUBLE:             return sizeof(double);
+    }
+    return -1;
+}
+
+/* apply EXPR of a[i] and b[i] to count elements of type T, leaving the result in a */
+#define COBO_OP_LOOP(T, EXPR) \
+    { T* a = (T*) inout; T* b = (T*) in; int i; \
+      for(i=0; i<count; i++) { a[i] = (T) (EXPR); } \
+      return COBO_SUCCESS; }
+
+#define COBO_OP_INTEGER(EXPR) \
+    case COBO_CHAR:               COBO_OP_LOOP(char, EXPR) \
+    case COBO_INT:                COBO_OP_LOOP(int, EXPR) \
+    case COBO_UNSIGNED:           COBO_OP_LOOP(unsigned int, EXPR) \
+    case COBO_LONG:               COBO_OP_LOOP(long, EXPR) \
+    case COBO_UNSIGNED_LONG:      COBO_OP_LOOP(unsigned long, EXPR) \
+    case COBO_LONG_LONG:          COBO_OP_LOOP(long long, EXPR) \
+    case COBO_UNSIGNED_LONG_LONG: COBO_OP_LOOP(unsigned long long, EXPR)
+
+#define COBO_OP_FLOATING(EXPR) \
+    case COBO_FLOAT:              COBO_OP_LOOP(float, EXPR) \
+    case COBO_DOUBLE:             COBO_OP_LOOP(double, EXPR)
+
+/*
+ * combine count elements of type from in into inout with op, inout[i] = inout[i] op in[i],
+ * returns -1 if op is unknown or does not apply to type (with count 0, this only checks)
+ */
+static int cobo_op_apply(int op, int type, void* inout, void* in, int count)
 {
+    if (op >= COBO_OP_USER && op < COBO_OP_USER + cobo_num_user_ops) {
+        if (cobo_type_size(type) < 0) {
+            return -1;
+        }
+        if (count > 0) {
+            (*cobo_user_ops[op - COBO_OP_USER])(inout, in, count, type);
+        }
+        return COBO_SUCCESS;
+    }
+
+    switch (op) {
+    case COBO_SUM:
+        switch (type) { COBO_OP_INTEGER(a[i] + b[i]) COBO_OP_FLOATING(a[i] + b[i]) }
+        break;
+    case COBO_PROD:
+        switch (type) { COBO_OP_INTEGER(a[i] * b[i]) COBO_OP_FLOATING(a[i] * b[i]) }
+        break;
+    case COBO_MIN:
+        switch (type) { COBO_OP_INTEGER(b[i] < a[i] ? b[i] : a[i]) COBO_OP_FLOATING(b[i] < a[i] ? b[i] : a[i]) }
+        break;
+    case COBO_MAX:
+        switch (type) { COBO_OP_INTEGER(b[i] > a[i] ? b[i] : a[i]) COBO_OP_FLOATING(b[i] > a[i] ? b[i] : a[i]) }
+        break;
+    case COBO_LAND:
+        switch (type) { COBO_OP_INTEGER(a[i] && b[i]) }
+        break;
+    case COBO_LOR:
+        switch (type) { COBO_OP_INTEGER(a[i] || b[i]) }
+        break;
+    case COBO_BAND:
+        switch (type) { COBO_OP_INTEGER(a[i] & b[i]) }
+        break;
+    case COBO_BOR:
+        switch (type) { COBO_OP_INTEGER(a[i] | b[i]) }
+        break;
+    case COBO_BXOR:
+        switch (type) { COBO_OP_INTEGER(a[i] ^ b[i]) }
+        break;
+    }
+
+    return -1;
+}
+
+/*
+ * reduce count elements of type from each task with op into recvbuf on rank 0,
+ * each task combines its own data with the result of each child's subtree in
+ * rank order and passes only count elements on to its parent
+ */
+static int cobo_reduce_tree(void* sendbuf, void* recvbuf, int count, int type, int op)
+{
+    cobo_progress(NULL, 1);
+
     int rc = COBO_SUCCESS;
+    int size = count * cobo_type_size(type);
 
-    /* init our current maximum to our own value */
-    int max_val = *sendbuf;
+    /* init our partial result to our own data */
+    void* accbuf = cobo_malloc(size, "Partial result buffer in cobo_reduce_tree");
+    void* childbuf = cobo_malloc(size, "Child data buffer in cobo_reduce_tree");
+    memcpy(accbuf, sendbuf, size);
 
-    /* if i have any children, receive their data */
+    /* if i have any children, receive their data and fold it in */
     int i;
-    int child_val;
     for(i=cobo_num_child-1; i>=0; i--) {
-        /* read integer from child */
-        if (cobo_read_fd(cobo_child_fd[i], &child_val, sizeof(child_val)) < 0) {
+        if (cobo_read_fd(cobo_child_fd[i], childbuf, size) < 0) {
             cobo_error("Reducing data from child (rank %d) failed @ file %s:%d",
                        cobo_child[i], __FILE__, __LINE__
             );
             exit(1);
         }
-
-        /* compare child's max to our current max */
-        if (child_val > max_val) {
-            max_val = child_val;
-        }
+        cobo_op_apply(op, type, accbuf, childbuf, count);
     }
 
     /* forward data to parent if we're not rank 0, otherwise set the recvbuf */
     if (cobo_me != 0) {
-        /* not the root, so forward our reduction result to our parent */
-        if (cobo_write_fd(cobo_parent_fd, &max_val, sizeof(max_val)) < 0) {
+        if (cobo_write_fd(cobo_parent_fd, accbuf, size) < 0) {
             cobo_error("Sending reduced data to parent failed @ file %s:%d",
                        __FILE__, __LINE__
             );
             exit(1);
         }
     } else {
-        /* we're the root, got the result, set the recvbuf */
-        *recvbuf = max_val;
+        memcpy(recvbuf, accbuf, size);
     }
 
+    cobo_free(childbuf);
+    cobo_free(accbuf);
+
+    return rc;
+}
+
+/* reduce maximum integer to rank 0, then broadcast it (cobo_ibarrier sends the same messages) */
+static int cobo_allreduce_max_int_tree(int* sendbuf, int* recvbuf)
+{
+    int rc = cobo_reduce_tree(sendbuf, recvbuf, 1, COBO_INT, COBO_MAX);
+
     /* broadcast result of reduction from rank 0 to all tasks */
     cobo_bcast_tree(recvbuf, sizeof(int));
 
@@ -1096,6 +1731,8 @@ static int cobo_allreduce_max_int_tree(int* sendbuf, int* recvbuf)
 /* gather sendcount bytes from sendbuf on each task into recvbuf on rank 0 */
 static int cobo_gather_tree(void* sendbuf, int sendcount, void* recvbuf)
 {
+    cobo_progress(NULL, 1);
+
     int rc = COBO_SUCCESS;
     int bigcount = (cobo_num_child_incl+1) * sendcount;
     void* bigbuf = recvbuf;
@@ -1138,6 +1775,8 @@ static int cobo_gather_tree(void* sendbuf, int sendcount, void* recvbuf)
 /* scatter sendcount byte chunks from sendbuf on rank 0 to recvbuf on each task */
 static int cobo_scatter_tree(void* sendbuf, int sendcount, void* recvbuf)
 {
+    cobo_progress(NULL, 1);
+
     int rc = COBO_SUCCESS;
     int bigcount = (cobo_num_child_incl+1) * sendcount;
     void* bigbuf = sendbuf;
@@ -1178,11 +1817,220 @@ static int cobo_scatter_tree(void* sendbuf, int sendcount, void* recvbuf)
 }
 
 /*
- * ==========================================================================
- * ==========================================================================
- * Client Interface Functions
- * ==========================================================================
- * ==========================================================================
+ * move bytes from fd in to fd out through buf of bufsize bytes, an out of -1
+ * drops the data
+ */
+static int cobo_forward_fd(int in, int out, char* buf, int bufsize, int bytes)
+{
+    while (bytes > 0) {
+        int count = (bytes < bufsize) ? bytes : bufsize;
+        if (cobo_read_fd(in, buf, count) < 0) {
+            return -1;
+        }
+        if (out >= 0 && cobo_write_fd(out, buf, count) < 0) {
+            return -1;
+        }
+        bytes -= count;
+    }
+    return 0;
+}
+
+/*
+ * scatter variable size chunks from sendbuf on rank 0, sendcounts[i] bytes at
+ * sendbuf+displs[i] go to rank i.  Each subtree covers a contiguous range of
+ * ranks, so a parent sends a child the counts of its whole range followed by
+ * the chunks of that range back to back.  A child keeps the first chunk and
+ * streams the rest on to its own children through a fixed size buffer, which
+ * it allocates before the exchange starts so that it never has to bail out
+ * halfway through it.
+ */
+static int cobo_scatterv_tree(void* sendbuf, int* sendcounts, int* displs, void* recvbuf, int recvcount)
+{
+    cobo_progress(NULL, 1);
+
+    int rc = COBO_SUCCESS;
+    int span = cobo_num_child_incl + 1;
+    int* counts = sendcounts;
+    char* stage = NULL;
+    int stagesize = 64*1024;
+    int i, j;
+
+    if (cobo_me != 0) {
+        counts = (int*) cobo_malloc(span * sizeof(int), "Count array in cobo_scatterv_tree");
+        stage = (char*) cobo_malloc(stagesize, "Staging buffer in cobo_scatterv_tree");
+
+        /* receive the counts of our range, then our own chunk, from our parent */
+        if (cobo_read_fd(cobo_parent_fd, counts, span * sizeof(int)) < 0) {
+            cobo_error("Receiving scatterv counts from parent failed @ file %s:%d",
+                       __FILE__, __LINE__
+            );
+            exit(1);
+        }
+
+        int keep = counts[0];
+        if (keep > recvcount) {
+            cobo_error("Scatterv chunk of %d bytes exceeds the receive count %d @ file %s:%d",
+                       counts[0], recvcount, __FILE__, __LINE__
+            );
+            keep = recvcount;
+            rc = -1;
+        }
+
+        if ((keep > 0 && cobo_read_fd(cobo_parent_fd, recvbuf, keep) < 0) ||
+            cobo_forward_fd(cobo_parent_fd, -1, stage, stagesize, counts[0] - keep) < 0)
+        {
+            cobo_error("Receiving scatterv data from parent failed @ file %s:%d",
+                       __FILE__, __LINE__
+            );
+            exit(1);
+        }
+    }
+
+    /* forward each child the counts and chunks of its range */
+    int first = 1;
+    for (i = cobo_num_child-1; i >= 0; i--) {
+        int n = cobo_child_incl[i];
+        int bytes = 0;
+        for (j = first; j < first + n; j++) {
+            bytes += counts[j];
+        }
+
+        if (cobo_write_fd(cobo_child_fd[i], &counts[first], n * sizeof(int)) < 0) {
+            cobo_error("Scattering counts to child (rank %d) failed @ file %s:%d",
+                       cobo_child[i], __FILE__, __LINE__
+            );
+            exit(1);
+        }
+
+        int failed = 0;
+        if (cobo_me == 0) {
+            /* the root's chunks may be anywhere in sendbuf, send them one by one */
+            for (j = first; j < first + n && !failed; j++) {
+                if (counts[j] > 0 &&
+                    cobo_write_fd(cobo_child_fd[i], (char*)sendbuf + displs[j], counts[j]) < 0)
+                {
+                    failed = 1;
+                }
+            }
+        } else {
+            failed = (cobo_forward_fd(cobo_parent_fd, cobo_child_fd[i], stage, stagesize, bytes) < 0);
+        }
+
+        if (failed) {
+            cobo_error("Scattering data to child (rank %d) failed @ file %s:%d",
+                       cobo_child[i], __FILE__, __LINE__
+            );
+            exit(1);
+        }
+        first += n;
+    }
+
+    /* copy my own chunk */
+    if (cobo_me == 0) {
+        if (counts[0] > recvcount) {
+            cobo_error("Scatterv chunk of %d bytes exceeds the receive count %d @ file %s:%d",
+                       counts[0], recvcount, __FILE__, __LINE__
+            );
+            rc = -1;
+        } else if (counts[0] > 0) {
+            memcpy(recvbuf, (char*)sendbuf + displs[0], counts[0]);
+        }
+    } else {
+        cobo_free(counts);
+        cobo_free(stage);
+    }
+
+    return rc;
+}
+
+/*
+ * gather sendcount bytes from sendbuf on each task into a buffer allocated on
+ * rank 0, where the data of all tasks ends up back to back in rank order and
+ * recvcounts[i] holds the number of bytes from rank i.  Counts travel up the
+ * tree ahead of the data: a task sends its parent the counts of its whole
+ * range, then the data of that range.
+ */
+static int cobo_gatherv_tree(void* sendbuf, int sendcount, void** recvbuf, int* recvcounts)
+{
+    cobo_progress(NULL, 1);
+
+    int rc = COBO_SUCCESS;
+    int span = cobo_num_child_incl + 1;
+    int* counts = recvcounts;
+    int i, j;
+
+    if (cobo_me != 0) {
+        counts = (int*) cobo_malloc(span * sizeof(int), "Count array in cobo_gatherv_tree");
+    }
+    counts[0] = sendcount;
+
+    /* receive the counts of each child's range */
+    int first = 1;
+    for (i = cobo_num_child-1; i >= 0; i--) {
+        if (cobo_read_fd(cobo_child_fd[i], &counts[first], cobo_child_incl[i] * sizeof(int)) < 0) {
+            cobo_error("Gathering counts from child (rank %d) failed @ file %s:%d",
+                       cobo_child[i], __FILE__, __LINE__
+            );
+            exit(1);
+        }
+        first += cobo_child_incl[i];
+    }
+
+    int total = 0;
+    for (j = 0; j < span; j++) {
+        total += counts[j];
+    }
+
+    /* then our own data followed by the data of each child's range */
+    char* bigbuf = (char*) cobo_malloc(total + 1, "Temporary gatherv buffer in cobo_gatherv_tree");
+    memcpy(bigbuf, sendbuf, sendcount);
+
+    int offset = sendcount;
+    first = 1;
+    for (i = cobo_num_child-1; i >= 0; i--) {
+        int bytes = 0;
+        for (j = first; j < first + cobo_child_incl[i]; j++) {
+            bytes += counts[j];
+        }
+        if (bytes > 0 && cobo_read_fd(cobo_child_fd[i], bigbuf + offset, bytes) < 0) {
+            cobo_error("Gathering data from child (rank %d) failed @ file %s:%d",
+                       cobo_child[i], __FILE__, __LINE__
+            );
+            exit(1);
+        }
+        offset += bytes;
+        first  += cobo_child_incl[i];
+    }
+
+    /* if i'm not rank 0, send counts and data to parent */
+    if (cobo_me != 0) {
+        if (cobo_write_fd(cobo_parent_fd, counts, span * sizeof(int)) < 0) {
+            cobo_error("Sending gathered counts to parent failed @ file %s:%d",
+                       __FILE__, __LINE__
+            );
+            exit(1);
+        }
+        if (total > 0 && cobo_write_fd(cobo_parent_fd, bigbuf, total) < 0) {
+            cobo_error("Sending gathered data to parent failed @ file %s:%d",
+                       __FILE__, __LINE__
+            );
+            exit(1);
+        }
+        cobo_free(counts);
+        cobo_free(bigbuf);
+    } else {
+        *recvbuf = bigbuf;
+    }
+
+    return rc;
+}
+
+/*
+ * ==========================================================================
+ * ==========================================================================
+ * Client Interface Functions
+ * ==========================================================================
+ * ==========================================================================
  */
 
 /* fills in fd with socket file desriptor to our parent */
@@ -1300,6 +2148,94 @@ int cobo_scatter(void* sendbuf, int sendcount, void* recvbuf, int root)
     return rc;
 }
 
+/*
+ * Perform MPI-like Scatterv, root writes sendcounts[i] bytes from
+ * sendbuf+displs[i] to task i, which receives them into recvbuf
+ * holding at most recvcount bytes
+ */
+int cobo_scatterv(void* sendbuf, int* sendcounts, int* displs, void* recvbuf, int recvcount, int root)
+{
+    struct timeval start, end;
+    cobo_gettimeofday(&start);
+    cobo_debug(3, "Starting cobo_scatterv()");
+
+    int rc = COBO_SUCCESS;
+
+    if (root == 0) {
+        rc = cobo_scatterv_tree(sendbuf, sendcounts, displs, recvbuf, recvcount);
+    } else {
+        cobo_error("Cannot execute scatterv from non-zero root @ file %s:%d",
+                   __FILE__, __LINE__
+        );
+        exit(1);
+    }
+
+    cobo_gettimeofday(&end);
+    cobo_debug(2, "Exiting cobo_scatterv(), took %f seconds for %d procs", cobo_getsecs(&end,&start), cobo_nprocs);
+    return rc;
+}
+
+/*
+ * Perform MPI-like Gatherv, each task writes sendcount bytes from sendbuf,
+ * then root receives a buffer allocated in recvbuf holding the data of all
+ * tasks back to back in rank order, and the number of bytes from task i in
+ * recvcounts[i].  The caller frees the buffer.
+ */
+int cobo_gatherv(void* sendbuf, int sendcount, void** recvbuf, int* recvcounts, int root)
+{
+    struct timeval start, end;
+    cobo_gettimeofday(&start);
+    cobo_debug(3, "Starting cobo_gatherv()");
+
+    int rc = COBO_SUCCESS;
+
+    if (root == 0) {
+        rc = cobo_gatherv_tree(sendbuf, sendcount, recvbuf, recvcounts);
+    } else {
+        cobo_error("Cannot execute gatherv to non-zero root @ file %s:%d",
+                   __FILE__, __LINE__
+        );
+        exit(1);
+    }
+
+    cobo_gettimeofday(&end);
+    cobo_debug(2, "Exiting cobo_gatherv(), took %f seconds for %d procs", cobo_getsecs(&end,&start), cobo_nprocs);
+    return rc;
+}
+
+/*
+ * Perform MPI-like Allgatherv, each task writes sendcount bytes from sendbuf,
+ * then receives a buffer allocated in recvbuf holding the data of all tasks
+ * back to back in rank order, and the number of bytes from task i in
+ * recvcounts[i].  The caller frees the buffer.
+ */
+int cobo_allgatherv(void* sendbuf, int sendcount, void** recvbuf, int* recvcounts)
+{
+    struct timeval start, end;
+    cobo_gettimeofday(&start);
+    cobo_debug(3, "Starting cobo_allgatherv()");
+
+    /* gather counts and data to rank 0 */
+    cobo_gatherv_tree(sendbuf, sendcount, recvbuf, recvcounts);
+
+    /* broadcast the counts, then the data from rank 0 */
+    cobo_bcast_tree(recvcounts, cobo_nprocs * sizeof(int));
+
+    int i;
+    int total = 0;
+    for (i = 0; i < cobo_nprocs; i++) {
+        total += recvcounts[i];
+    }
+    if (cobo_me != 0) {
+        *recvbuf = cobo_malloc(total + 1, "Receive buffer in cobo_allgatherv");
+    }
+    cobo_bcast_tree(*recvbuf, total);
+
+    cobo_gettimeofday(&end);
+    cobo_debug(2, "Exiting cobo_allgatherv(), took %f seconds for %d procs", cobo_getsecs(&end,&start), cobo_nprocs);
+    return COBO_SUCCESS;
+}
+
 /*
  * Perform MPI-like Allgather, each task writes sendcount bytes from sendbuf
  * then receives N*sendcount bytes into recvbuf
@@ -1360,6 +2296,87 @@ int cobo_allreduce_max_int(int* sendint, int* recvint)
     return COBO_SUCCESS;
 }
 
+/*
+ * Register a reduction op, fn(inout, in, count, type) must set inout[i] to
+ * inout[i] op in[i] for count elements of type; op receives the id to pass to
+ * cobo_reduce and cobo_allreduce.  All tasks must register their ops in the
+ * same order so that the ids match.
+ */
+int cobo_op_create(cobo_op_fn fn, int* op)
+{
+    if (fn == NULL || cobo_num_user_ops >= COBO_MAX_USER_OPS) {
+        cobo_error("Cannot register reduction op, %d of %d registered @ file %s:%d",
+                   cobo_num_user_ops, COBO_MAX_USER_OPS, __FILE__, __LINE__
+        );
+        return -1;
+    }
+
+    cobo_user_ops[cobo_num_user_ops] = fn;
+    *op = COBO_OP_USER + cobo_num_user_ops;
+    cobo_num_user_ops++;
+
+    return COBO_SUCCESS;
+}
+
+/*
+ * Perform MPI-like Reduce, each task combines count elements of type from
+ * sendbuf with op, root receives the result into recvbuf
+ */
+int cobo_reduce(void* sendbuf, void* recvbuf, int count, int type, int op, int root)
+{
+    struct timeval start, end;
+    cobo_gettimeofday(&start);
+    cobo_debug(3, "Starting cobo_reduce()");
+
+    int rc = COBO_SUCCESS;
+
+    if (cobo_type_size(type) < 0 || cobo_op_apply(op, type, NULL, NULL, 0) != COBO_SUCCESS) {
+        cobo_error("Cannot reduce type %d with op %d @ file %s:%d",
+                   type, op, __FILE__, __LINE__
+        );
+        return -1;
+    }
+
+    /* if root is rank 0 and reduce tree is enabled, use it */
+    /* (this is a common case) */
+    if (root == 0) {
+        if (count > 0) {
+            rc = cobo_reduce_tree(sendbuf, recvbuf, count, type, op);
+        }
+    } else {
+        cobo_error("Cannot execute reduce to non-zero root @ file %s:%d",
+                   __FILE__, __LINE__
+        );
+        exit(1);
+    }
+
+    cobo_gettimeofday(&end);
+    cobo_debug(2, "Exiting cobo_reduce(), took %f seconds for %d procs", cobo_getsecs(&end,&start), cobo_nprocs);
+    return rc;
+}
+
+/*
+ * Perform MPI-like Allreduce, each task combines count elements of type from
+ * sendbuf with op and receives the result into recvbuf
+ */
+int cobo_allreduce(void* sendbuf, void* recvbuf, int count, int type, int op)
+{
+    struct timeval start, end;
+    cobo_gettimeofday(&start);
+    cobo_debug(3, "Starting cobo_allreduce()");
+
+    int rc = cobo_reduce(sendbuf, recvbuf, count, type, op, 0);
+
+    /* broadcast result of reduction from rank 0 to all tasks */
+    if (rc == COBO_SUCCESS && count > 0) {
+        rc = cobo_bcast_tree(recvbuf, count * cobo_type_size(type));
+    }
+
+    cobo_gettimeofday(&end);
+    cobo_debug(2, "Exiting cobo_allreduce(), took %f seconds for %d procs", cobo_getsecs(&end,&start), cobo_nprocs);
+    return rc;
+}
+
 /*
  * Perform MPI-like Allgather of NULL-terminated strings (whose lengths may vary
  * from task to task).
@@ -1384,38 +2401,176 @@ int cobo_allgather_str(char* sendstr, char*** recvstr, char** recvbuf)
     cobo_gettimeofday(&start);
     cobo_debug(3, "Starting cobo_allgatherstr()");
 
-    /* determine max length of send strings */
-    int mylen  = strlen(sendstr) + 1;
-    int maxlen = 0;
-    cobo_allreduce_max_int(&mylen, &maxlen);
+    /* gather the strings back to back, each with its terminating NUL */
+    int* lengths = (int*) cobo_malloc(cobo_nprocs * sizeof(int), "String length array");
+    void* stringbuf = NULL;
+    cobo_allgatherv((void*) sendstr, strlen(sendstr) + 1, &stringbuf, lengths);
 
-    /* pad my string to match max length */
-    char* mystr = (char*) cobo_malloc(maxlen, "Padded String");
-    memset(mystr, '\0', maxlen);
-    strcpy(mystr, sendstr);
-
-    /* allocate enough buffer space to receive a maxlen string from all tasks */
-    char* stringbuf = (char*) cobo_malloc(cobo_nprocs * maxlen, "String Buffer");
-
-    /* gather strings from everyone */
-    cobo_allgather((void*) mystr, maxlen, (void*) stringbuf);
-
-    /* set up array and free temporary maxlen string */
+    /* set up array of pointers into the string buffer */
     char** strings = (char **) cobo_malloc(cobo_nprocs * sizeof(char*), "Array of String Pointers");
     int i;
+    int offset = 0;
     for (i=0; i<cobo_nprocs; i++) {
-        strings[i] = stringbuf + i*maxlen;
+        strings[i] = (char*) stringbuf + offset;
+        offset += lengths[i];
     }
-    cobo_free(mystr);
+    cobo_free(lengths);
 
     *recvstr = strings;
-    *recvbuf = stringbuf;
+    *recvbuf = (char*) stringbuf;
 
     cobo_gettimeofday(&end);
     cobo_debug(2, "Exiting cobo_allgatherstr(), took %f seconds for %d procs", cobo_getsecs(&end,&start), cobo_nprocs);
     return COBO_SUCCESS;
 }
 
+/*
+ * Start a non-blocking barrier, it exchanges the same messages as cobo_barrier;
+ * complete it with cobo_test or cobo_wait
+ */
+int cobo_ibarrier(cobo_request* req)
+{
+    cobo_debug(3, "Starting cobo_ibarrier()");
+
+    struct cobo_request_struct* r = cobo_request_alloc();
+
+    /* an int from each child, then one to the parent and one back down */
+    int* ints = (int*) cobo_malloc((cobo_num_child+1) * sizeof(int), "Barrier tokens in cobo_ibarrier");
+    ints[0] = 1;
+
+    int i;
+    int offset = sizeof(int);
+    for(i=cobo_num_child-1; i>=0; i--) {
+        r->child_off[i] = offset;
+        r->child_len[i] = sizeof(int);
+        offset += sizeof(int);
+    }
+
+    r->upbuf     = (char*) ints;
+    r->upcount   = sizeof(int);
+    r->downbuf   = (char*) ints;
+    r->downcount = sizeof(int);
+    r->tmpbuf    = ints;
+
+    cobo_request_post(r);
+    cobo_progress(r, 0);
+
+    *req = r;
+    return COBO_SUCCESS;
+}
+
+/*
+ * Start a non-blocking MPI-like Broadcast, buf must stay untouched until the
+ * request completes; complete it with cobo_test or cobo_wait
+ */
+int cobo_ibcast(void* buf, int sendcount, int root, cobo_request* req)
+{
+    cobo_debug(3, "Starting cobo_ibcast()");
+
+    if (root != 0) {
+        cobo_error("Cannot execute bcast from non-zero root @ file %s:%d",
+                   __FILE__, __LINE__
+        );
+        exit(1);
+    }
+
+    struct cobo_request_struct* r = cobo_request_alloc();
+    r->downbuf   = (char*) buf;
+    r->downcount = sendcount;
+
+    cobo_request_post(r);
+    cobo_progress(r, 0);
+
+    *req = r;
+    return COBO_SUCCESS;
+}
+
+/*
+ * Start a non-blocking MPI-like Gather, recvbuf on root holds nothing useful
+ * until the request completes; complete it with cobo_test or cobo_wait
+ */
+int cobo_igather(void* sendbuf, int sendcount, void* recvbuf, int root, cobo_request* req)
+{
+    cobo_debug(3, "Starting cobo_igather()");
+
+    if (root != 0) {
+        cobo_error("Cannot execute gather to non-zero root @ file %s:%d",
+                   __FILE__, __LINE__
+        );
+        exit(1);
+    }
+
+    struct cobo_request_struct* r = cobo_request_alloc();
+
+    /* like cobo_gather_tree, but data goes on to the parent as soon as the leading part of it is in */
+    int bigcount = (cobo_num_child_incl+1) * sendcount;
+    r->upbuf = (char*) recvbuf;
+    if (cobo_me != 0) {
+        r->upbuf  = (char*) cobo_malloc(bigcount, "Temporary gather buffer in cobo_igather");
+        r->tmpbuf = r->upbuf;
+    }
+    memcpy(r->upbuf, sendbuf, sendcount);
+
+    int i;
+    int offset = sendcount;
+    for(i=cobo_num_child-1; i>=0; i--) {
+        r->child_off[i] = offset;
+        r->child_len[i] = sendcount * cobo_child_incl[i];
+        offset += r->child_len[i];
+    }
+
+    r->upcount  = bigcount;
+    r->upready  = sendcount;
+    r->upstream = 1;
+
+    cobo_request_post(r);
+    cobo_progress(r, 0);
+
+    *req = r;
+    return COBO_SUCCESS;
+}
+
+/*
+ * Move the outstanding non-blocking collectives along as far as possible
+ * without waiting, and set flag to 1 if req has completed (it is then freed
+ * and set to NULL) or to 0 otherwise
+ */
+int cobo_test(cobo_request* req, int* flag)
+{
+    *flag = 1;
+    if (*req == NULL) {
+        return COBO_SUCCESS;
+    }
+
+    cobo_progress(*req, 0);
+    if (!(*req)->complete) {
+        *flag = 0;
+        return COBO_SUCCESS;
+    }
+
+    cobo_request_free(*req);
+    *req = NULL;
+    return COBO_SUCCESS;
+}
+
+/* Wait until req has completed, then free it and set it to NULL */
+int cobo_wait(cobo_request* req)
+{
+    struct timeval start, end;
+    cobo_gettimeofday(&start);
+    cobo_debug(3, "Starting cobo_wait()");
+
+    if (*req != NULL) {
+        cobo_progress(*req, 1);
+        cobo_request_free(*req);
+        *req = NULL;
+    }
+
+    cobo_gettimeofday(&end);
+    cobo_debug(2, "Exiting cobo_wait(), took %f seconds for %d procs", cobo_getsecs(&end,&start), cobo_nprocs);
+    return COBO_SUCCESS;
+}
+
 /* provide list of ports and number of ports as input, get number of tasks and my rank as output */
 int cobo_open(unsigned int sessionid, int* portlist, int num_ports, int* rank, int* num_ranks)
 {
@@ -1455,6 +2610,11 @@ int cobo_open(unsigned int sessionid, int* portlist, int num_ports, int* rank, i
         cobo_connect_timelimit = (double) atoi(value);
     }
 
+    /* bytes, 0 forwards broadcasts as whole messages */
+    if ((value = cobo_getenv("COBO_BCAST_SEGMENT", ENV_OPTIONAL))) {
+        cobo_bcast_segment = atoi(value);
+    }
+
     /* COBO_CLIENT_DEBUG={0,1} disables/enables debug statements */
     if ((value = cobo_getenv("COBO_CLIENT_DEBUG", ENV_OPTIONAL)) != NULL) {
         cobo_echo_debug = atoi(value);
@@ -1476,8 +2636,8 @@ int cobo_open(unsigned int sessionid, int* portlist, int num_ports, int* rank, i
     }
 
     cobo_debug(3, "In cobo_init():\n" \
-        "COBO_CONNECT_TIMEOUT: %d, COBO_CONNECT_BACKOFF: %d, COBO_CONNECT_SLEEP: %d, COBO_CONNECT_TIMELIMIT: %d",
-        cobo_connect_timeout, cobo_connect_backoff, cobo_connect_sleep, (int) cobo_connect_timelimit
+        "COBO_CONNECT_TIMEOUT: %d, COBO_CONNECT_BACKOFF: %d, COBO_CONNECT_SLEEP: %d, COBO_CONNECT_TIMELIMIT: %d, COBO_BCAST_SEGMENT: %d",
+        cobo_connect_timeout, cobo_connect_backoff, cobo_connect_sleep, (int) cobo_connect_timelimit, cobo_bcast_segment
     );
 
     /* DHA 4/11/2014: enable security handshake timeout */
@@ -1561,6 +2721,29 @@ int cobo_server_get_root_socket(int* fd)
     return -1;
 }
 
+/* pick the shape of the tree before calling cobo_server_open, clients adopt the shape of the server */
+int cobo_set_tree(int shape, int fanout, int group)
+{
+    if (shape != COBO_TREE_BINOMIAL && shape != COBO_TREE_KARY && shape != COBO_TREE_TOPO) {
+        cobo_error("Unknown tree shape %d @ file %s:%d",
+                   shape, __FILE__, __LINE__
+        );
+        return (!COBO_SUCCESS);
+    }
+    if (fanout < 1 || group < 0) {
+        cobo_error("Invalid tree fanout %d or group size %d @ file %s:%d",
+                   fanout, group, __FILE__, __LINE__
+        );
+        return (!COBO_SUCCESS);
+    }
+
+    cobo_tree_shape  = shape;
+    cobo_tree_fanout = fanout;
+    cobo_tree_group  = group;
+
+    return COBO_SUCCESS;
+}
+
 /* given a hostlist and portlist where clients are running, open the tree and assign ranks to clients */
 int cobo_server_open(unsigned int sessionid, char** hostlist, int num_hosts, int* portlist, int num_ports)
 {
@@ -1572,6 +2755,41 @@ int cobo_server_open(unsigned int sessionid, char** hostlist, int num_hosts, int
     cobo_nprocs = num_hosts;
     cobo_sessionid = sessionid;
 
+    /* COBO_TREE=binomial|kary[:fanout]|topo[:fanout] picks the shape of the tree */
+    char* value;
+    if ((value = cobo_getenv("COBO_TREE", ENV_OPTIONAL)) != NULL) {
+        int shape = cobo_tree_shape;
+        int fanout = cobo_tree_fanout;
+        char* colon = strchr(value, ':');
+        int len = (colon != NULL) ? (int) (colon - value) : (int) strlen(value);
+        if (len == 8 && strncmp(value, "binomial", len) == 0) {
+            shape = COBO_TREE_BINOMIAL;
+        } else if (len == 4 && strncmp(value, "kary", len) == 0) {
+            shape = COBO_TREE_KARY;
+        } else if (len == 4 && strncmp(value, "topo", len) == 0) {
+            shape = COBO_TREE_TOPO;
+        } else {
+            shape = -1;
+        }
+        if (colon != NULL) {
+            fanout = atoi(colon+1);
+        }
+        if (cobo_set_tree(shape, fanout, cobo_tree_group) != COBO_SUCCESS) {
+            cobo_error("Ignoring COBO_TREE=%s @ file %s:%d",
+                       value, __FILE__, __LINE__
+            );
+        }
+    }
+
+    /* COBO_TREE_GROUP gives the number of hosts per switch for the topology-aware tree */
+    if ((value = cobo_getenv("COBO_TREE_GROUP", ENV_OPTIONAL)) != NULL) {
+        cobo_set_tree(cobo_tree_shape, cobo_tree_fanout, atoi(value));
+    }
+
+    cobo_debug(1, "Tree shape %d, fanout %d, hosts per switch %d",
+        cobo_tree_shape, cobo_tree_fanout, cobo_tree_group
+    );
+
     /* check that we have some hosts in the hostlist */
     if (num_hosts <= 0) {
         return (!COBO_SUCCESS);
@@ -19,8 +19,41 @@
 
 #define COBO_SUCCESS (0)
 
+/* tree shapes for cobo_set_tree */
+#define COBO_TREE_BINOMIAL (0) /* binomial tree over the ranks (default) */
+#define COBO_TREE_KARY     (1) /* balanced tree with up to fanout children per task */
+#define COBO_TREE_TOPO     (2) /* k-ary trees within groups of hosts sharing a switch, joined by a k-ary tree of group leaders */
+
+/* element types for cobo_reduce and cobo_allreduce */
+#define COBO_CHAR               (0)
+#define COBO_INT                (1)
+#define COBO_UNSIGNED           (2)
+#define COBO_LONG               (3)
+#define COBO_UNSIGNED_LONG      (4)
+#define COBO_LONG_LONG          (5)
+#define COBO_UNSIGNED_LONG_LONG (6)
+#define COBO_FLOAT              (7)
+#define COBO_DOUBLE             (8)
+
+/* predefined reduction ops, the logical and bitwise ones apply to integer types only */
+#define COBO_SUM  (0)
+#define COBO_PROD (1)
+#define COBO_MIN  (2)
+#define COBO_MAX  (3)
+#define COBO_LAND (4)
+#define COBO_LOR  (5)
+#define COBO_BAND (6)
+#define COBO_BOR  (7)
+#define COBO_BXOR (8)
+
 extern handshake_protocol_t cobo_sec_protocol;
 
+/* handle of a non-blocking collective, cobo_test and cobo_wait set it to NULL once it completes */
+typedef struct cobo_request_struct* cobo_request;
+
+/* user reduction op for cobo_op_create, sets inout[i] = inout[i] op in[i] for count elements of type */
+typedef void (*cobo_op_fn)(void* inout, void* in, int count, int type);
+
 /*
  * ==========================================================================
  * ==========================================================================
@@ -53,12 +86,38 @@ int cobo_gather   (void* sendbuf, int sendcount, void* recvbuf, int root);
 /* root sends blocks of sendcount bytes to each task indexed from sendbuf */
 int cobo_scatter  (void* sendbuf, int sendcount, void* recvbuf, int root);
 
+/* root sends sendcounts[i] bytes from sendbuf+displs[i] to task i, which receives at most recvcount bytes */
+int cobo_scatterv (void* sendbuf, int* sendcounts, int* displs, void* recvbuf, int recvcount, int root);
+
+/* each task sends sendcount bytes from sendbuf, root receives an allocated buffer with the data of all tasks
+ * back to back in rank order, and recvcounts[i] bytes from task i; free the buffer when done */
+int cobo_gatherv  (void* sendbuf, int sendcount, void** recvbuf, int* recvcounts, int root);
+
 /* each task sends sendcount bytes from sendbuf and receives N*sendcount bytes into recvbuf */
 int cobo_allgather(void* sendbuf, int sendcount, void* recvbuf);
 
+/* like cobo_gatherv, but every task receives the buffer and the N recvcounts */
+int cobo_allgatherv(void* sendbuf, int sendcount, void** recvbuf, int* recvcounts);
+
 /* each task sends N*sendcount bytes from sendbuf and receives N*sendcount bytes into recvbuf */
 int cobo_alltoall (void* sendbuf, int sendcount, void* recvbuf);
 
+/* each task sends an int from sendint and receives the maximum of them into recvint */
+int cobo_allreduce_max_int(int* sendint, int* recvint);
+
+/* registers a reduction op, all tasks must register their ops in the same order */
+int cobo_op_create(cobo_op_fn fn, int* op);
+
+/*
+ * each task sends count elements of type from sendbuf, root receives them combined with op
+ * into recvbuf; the tree combines them on the way up in rank order, so the root only
+ * receives count elements from each of its children
+ */
+int cobo_reduce   (void* sendbuf, void* recvbuf, int count, int type, int op, int root);
+
+/* like cobo_reduce, but every task receives the result into recvbuf */
+int cobo_allreduce(void* sendbuf, void* recvbuf, int count, int type, int op);
+
 /*
  * Perform MPI-like Allgather of NULL-terminated strings (whose lengths may vary
  * from task to task).
@@ -79,6 +138,30 @@ int cobo_alltoall (void* sendbuf, int sendcount, void* recvbuf);
  */
 int cobo_allgather_str(char* sendstr, char*** recvstr, char** recvbuf);
 
+/*
+ * Non-blocking versions of cobo_barrier, cobo_bcast and cobo_gather.  Each
+ * starts the collective and returns a request right away, the buffers must not
+ * be touched until cobo_test or cobo_wait reports the request as complete.
+ * Requests only move while the caller is inside cobo_test, cobo_wait or
+ * another collective, so call cobo_test now and then during long computations.
+ * All tasks must post collectives, blocking or not, in the same order.
+ *
+ * Example Usage:
+ *   cobo_request req;
+ *   int done = 0;
+ *   cobo_ibcast(buf, size, 0, &req);
+ *   while (!done) { take_a_sample(); cobo_test(&req, &done); }
+ */
+int cobo_ibarrier(cobo_request* req);
+int cobo_ibcast  (void* buf, int sendcount, int root, cobo_request* req);
+int cobo_igather (void* sendbuf, int sendcount, void* recvbuf, int root, cobo_request* req);
+
+/* sets flag to 1 and req to NULL if req has completed, and to 0 otherwise, without waiting */
+int cobo_test(cobo_request* req, int* flag);
+
+/* waits until req has completed and sets it to NULL */
+int cobo_wait(cobo_request* req);
+
 /*
  * ==========================================================================
  * ==========================================================================
@@ -87,6 +170,16 @@ int cobo_allgather_str(char* sendstr, char*** recvstr, char** recvbuf);
  * ==========================================================================
  */
 
+/*
+ * pick the shape of the tree before calling cobo_server_open, fanout bounds
+ * the children per task (k-ary) or per group (topology-aware), group gives the
+ * number of hosts per switch (0 groups hosts by their name before the node
+ * number only).  The COBO_TREE=binomial|kary[:fanout]|topo[:fanout] and
+ * COBO_TREE_GROUP environment variables override it, and clients adopt the
+ * shape of the server when they call cobo_open.
+ */
+int cobo_set_tree(int shape, int fanout, int group);
+
 /* given a hostlist and portlist where clients are running, open the tree and assign ranks to clients */
 int cobo_server_open(unsigned int sessionid, char** hostlist, int num_hosts, int* portlist, int num_ports);
 